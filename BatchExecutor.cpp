@@ -0,0 +1,390 @@
+#include "BatchExecutor.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <iomanip>
+#include <cctype>
+#include <cstdio>
+
+BatchExecutor::BatchExecutor(HotelSystem& hotelRef) : hotel(hotelRef) {}
+
+bool BatchExecutor::tokenize(const std::string& line, std::vector<std::string>& tokens) {
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i]))) ++i;
+        if (i >= line.size()) break;
+
+        std::string token;
+        if (line[i] == '"') {
+            ++i;
+            while (i < line.size() && line[i] != '"') token += line[i++];
+            if (i >= line.size()) return false;  // unterminated quote
+            ++i;
+        } else {
+            while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i]))) token += line[i++];
+        }
+        tokens.push_back(token);
+    }
+    return true;
+}
+
+bool BatchExecutor::parseDateTime(const std::string& text, int defaultHour, time_t& out) {
+    int year = 0, month = 0, day = 0, hour = defaultHour, minute = 0, second = 0;
+    // One of the four forms, and nothing after it: "2025-03-1O" or
+    // "2025-03-10T14:30junk" must not book March 1st or 14:30
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c)) && c != '-' && c != 'T' && c != ':') return false;
+    }
+    const char* s = text.c_str();
+    int used = -1;
+    auto whole = [&](int fields, int wanted) {
+        bool ok = fields == wanted && used >= 0 && static_cast<size_t>(used) == text.size();
+        used = -1;
+        return ok;
+    };
+    if (!whole(std::sscanf(s, "%d-%d-%d%n", &year, &month, &day, &used), 3) &&
+        !whole(std::sscanf(s, "%d-%d-%dT%d%n", &year, &month, &day, &hour, &used), 4) &&
+        !whole(std::sscanf(s, "%d-%d-%dT%d:%d%n", &year, &month, &day, &hour, &minute, &used), 5) &&
+        !whole(std::sscanf(s, "%d-%d-%dT%d:%d:%d%n", &year, &month, &day, &hour, &minute, &second, &used), 6)) {
+        return false;
+    }
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) return false;
+
+    // Round-tripping through the day index rejects dates like 2025-02-30
+    int dayIndex = dayIndexFromCivil(year, month, day);
+    int y, m, d;
+    civilFromDayIndex(dayIndex, y, m, d);
+    if (y != year || m != month || d != day) return false;
+
+    out = fromDayIndex(dayIndex, hour) + minute * 60 + second;
+    return true;
+}
+
+bool BatchExecutor::parseRoomType(const std::string& text, RoomType& out) {
+    std::string t;
+    for (char c : text) t += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (t == "single" || t == "1") { out = RoomType::SINGLE; return true; }
+    if (t == "double" || t == "2") { out = RoomType::DOUBLE; return true; }
+    if (t == "suite" || t == "3")  { out = RoomType::SUITE; return true; }
+    if (t == "deluxe" || t == "4") { out = RoomType::DELUXE; return true; }
+    return false;
+}
+
+bool BatchExecutor::parseId(const std::string& text, int& out) {
+    try {
+        size_t used = 0;
+        out = std::stoi(text, &used);
+        return used == text.size();
+    } catch (...) {
+        return false;
+    }
+}
+
+OperationResult BatchExecutor::execute(const std::string& line, std::string& operation) {
+    OperationResult result;
+    operation.clear();
+
+    std::vector<std::string> args;
+    if (!tokenize(line, args)) {
+        operation = "?";
+        result.code = ResultCode::BAD_COMMAND;
+        result.message = "Unterminated quote.";
+        return result;
+    }
+    if (args.empty() || args[0][0] == '#') return result;
+
+    operation = args[0];
+    auto invalid = [&](const std::string& usage) {
+        result.code = ResultCode::BAD_COMMAND;
+        result.message = "Usage: " + usage;
+        return result;
+    };
+
+    int id = 0;
+    RoomType type = RoomType::SINGLE;
+    time_t checkIn = 0, checkOut = 0;
+
+    if (operation == "add_customer") {
+        if (args.size() != 4) return invalid("add_customer \"NAME\" EMAIL PHONE");
+        return hotel.addCustomer(args[1], args[2], args[3]);
+    }
+    if (operation == "modify_customer") {
+        if (args.size() != 5 || !parseId(args[1], id)) return invalid("modify_customer ID NAME|- EMAIL|- PHONE|-");
+        auto keep = [](const std::string& v) { return v == "-" ? std::string() : v; };
+        return hotel.modifyCustomer(id, keep(args[2]), keep(args[3]), keep(args[4]));
+    }
+    if (operation == "delete_customer") {
+        if (args.size() != 2 || !parseId(args[1], id)) return invalid("delete_customer ID");
+        return hotel.deleteCustomer(id);
+    }
+    if (operation == "create_reservation") {
+        if (args.size() != 5 || !parseId(args[1], id) || !parseRoomType(args[2], type) ||
+            !parseDateTime(args[3], 14, checkIn) || !parseDateTime(args[4], 11, checkOut)) {
+            return invalid("create_reservation CUSTOMER_ID TYPE YYYY-MM-DD[THH] YYYY-MM-DD[THH]");
+        }
+        return hotel.createReservation(id, type, checkIn, checkOut);
+    }
+    if (operation == "create_group") {
+        const char* usage = "create_group CUSTOMER_ID TYPE[:COUNT][,TYPE[:COUNT]...] YYYY-MM-DD[THH] YYYY-MM-DD[THH]";
+        if (args.size() != 5 || !parseId(args[1], id) ||
+            !parseDateTime(args[3], 14, checkIn) || !parseDateTime(args[4], 11, checkOut)) {
+            return invalid(usage);
+        }
+        std::vector<RoomType> types;
+        size_t requested[ROOM_TYPE_COUNT] = {};
+        std::istringstream mix(args[2]);
+        std::string item;
+        while (std::getline(mix, item, ',')) {
+            size_t colon = item.find(':');
+            int count = 1;
+            if (!parseRoomType(item.substr(0, colon), type) ||
+                (colon != std::string::npos && (!parseId(item.substr(colon + 1), count) || count <= 0))) {
+                return invalid(usage);
+            }
+            // Checked before anything is allocated for the group
+            size_t& total = requested[static_cast<int>(type)];
+            size_t available = hotel.roomCount(type);
+            if (static_cast<size_t>(count) > available - std::min(total, available)) {
+                result.code = ResultCode::BAD_COMMAND;
+                result.message = "The hotel has only " + std::to_string(available) + " " +
+                                 item.substr(0, colon) + " room(s).";
+                return result;
+            }
+            total += static_cast<size_t>(count);
+            types.insert(types.end(), static_cast<size_t>(count), type);
+        }
+        return hotel.createGroupReservation(id, types, checkIn, checkOut);
+    }
+    if (operation == "cancel") {
+        if (args.size() != 2 || !parseId(args[1], id)) return invalid("cancel ID");
+        return hotel.cancelReservation(id);
+    }
+    if (operation == "make_room") {
+        if (args.size() != 2 || !parseId(args[1], id)) return invalid("make_room ID");
+        return hotel.makeRoomFor(id);
+    }
+    if (operation == "reschedule") {
+        if (args.size() > 2 || (args.size() == 2 && args[1] != "revenue")) return invalid("reschedule [revenue]");
+        return hotel.reschedule(args.size() == 2);
+    }
+    if (operation == "check_in") {
+        if (args.size() != 2 || !parseId(args[1], id)) return invalid("check_in ID");
+        return hotel.checkInReservation(id);
+    }
+    if (operation == "check_out") {
+        if (args.size() != 2 || !parseId(args[1], id)) return invalid("check_out ID");
+        return hotel.checkOutReservation(id);
+    }
+    if (operation == "availability") {
+        if (args.size() != 4 || !parseRoomType(args[1], type) ||
+            !parseDateTime(args[2], 14, checkIn) || !parseDateTime(args[3], 11, checkOut)) {
+            return invalid("availability TYPE YYYY-MM-DD[THH] YYYY-MM-DD[THH]");
+        }
+        std::vector<int> free = hotel.findAvailableRooms(type, checkIn, checkOut);
+        std::ostringstream ss;
+        ss << free.size() << " room(s) available:";
+        for (int room : free) ss << " " << room;
+        result.message = ss.str();
+        return result;
+    }
+    if (operation == "lookup") {
+        if (args.size() != 2 || !parseId(args[1], id)) return invalid("lookup ID");
+        Reservation r;
+        result.id = id;
+        if (!hotel.lookupReservation(id, r)) {
+            result.code = ResultCode::NOT_FOUND;
+            result.message = "Reservation not found.";
+            return result;
+        }
+        result.roomNumber = r.getAssignedRoomNumber();
+        result.totalCost = r.getTotalCost();
+        result.message = "Reservation #" + std::to_string(id) + " " + r.getStatusString();
+        return result;
+    }
+    if (operation == "arrivals" || operation == "departures" || operation == "in_house") {
+        bool dated = operation != "in_house";
+        if (args.size() > (dated ? 2u : 1u) ||
+            (args.size() == 2 && !parseDateTime(args[1], 12, checkIn))) {
+            return invalid(dated ? operation + " [YYYY-MM-DD]" : operation);
+        }
+        int day = toDayIndex(args.size() == 2 ? checkIn : time(nullptr));
+        std::vector<Reservation> stays = operation == "arrivals" ? hotel.arrivalsOn(day)
+                                       : operation == "departures" ? hotel.departuresOn(day)
+                                                                   : hotel.inHouse();
+        std::ostringstream ss;
+        ss << stays.size() << " reservation(s):";
+        for (const auto& r : stays) {
+            ss << " #" << r.getId();
+            if (r.getAssignedRoomNumber() > 0) ss << "/" << r.getAssignedRoomNumber();
+        }
+        result.message = ss.str();
+        return result;
+    }
+    if (operation == "query") {
+        const char* usage = "query [status=S[,S...]] [customer=ID] [room=N] [type=T] [from=DATE] [to=DATE]"
+                            " [sort=id|check_in|check_out|cost] [desc] [limit=N] [after=CURSOR]";
+        static const char* const statusNames[] = {"pending", "confirmed", "checked_in", "checked_out", "cancelled"};
+        ReservationQuery query;
+        ReservationFilter& f = query.filter;
+        for (size_t i = 1; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            size_t eq = arg.find('=');
+            std::string key = arg.substr(0, eq), value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+            int number = 0;
+            if (arg == "desc") {
+                query.descending = true;
+            } else if (key == "status") {
+                std::stringstream list(value);
+                std::string name;
+                while (std::getline(list, name, ',')) {
+                    unsigned before = f.statusMask;
+                    for (int bit = 0; bit < 5; ++bit) {
+                        if (name == statusNames[bit]) f.statusMask |= 1u << bit;
+                    }
+                    if (f.statusMask == before) return invalid(usage);
+                }
+            } else if (key == "customer" && parseId(value, number)) {
+                f.customerId = number;
+            } else if (key == "room" && parseId(value, number)) {
+                f.roomNumber = number;
+            } else if (key == "type" && parseRoomType(value, type)) {
+                f.roomType = static_cast<int>(type);
+            } else if ((key == "from" || key == "to") && parseDateTime(value, 12, checkIn)) {
+                (key == "from" ? f.checkInFromDay : f.checkInToDay) = toDayIndex(checkIn);
+            } else if (key == "sort" && (value == "id" || value == "check_in" || value == "check_out" ||
+                                         value == "cost")) {
+                query.sort = value == "check_in" ? ReservationSort::CHECK_IN
+                           : value == "check_out" ? ReservationSort::CHECK_OUT
+                           : value == "cost" ? ReservationSort::TOTAL_COST : ReservationSort::ID;
+            } else if (key == "limit" && parseId(value, number) && number > 0) {
+                query.pageSize = static_cast<size_t>(number);
+            } else if (key == "after" && !value.empty()) {
+                query.cursor = value;
+            } else {
+                return invalid(usage);
+            }
+        }
+        ReservationPage page;
+        if (!hotel.queryReservations(query, page)) {
+            result.code = ResultCode::INVALID_INPUT;
+            result.message = "Invalid cursor: " + query.cursor;
+            return result;
+        }
+        std::ostringstream ss;
+        ss << page.matched << " match(es) via " << page.plan << ", " << page.examined << " examined:";
+        for (const auto& r : page.rows) ss << " #" << r.getId();
+        if (!page.nextCursor.empty()) ss << " next=" << page.nextCursor;
+        result.message = ss.str();
+        return result;
+    }
+    if (operation == "lookup_at") {
+        if (args.size() != 3 || !parseId(args[1], id) || !parseDateTime(args[2], 23, checkIn)) {
+            return invalid("lookup_at ID YYYY-MM-DD[THH[:MM[:SS]]]");
+        }
+        Reservation r;
+        result.id = id;
+        if (!hotel.lookupReservationAt(id, checkIn, r)) {
+            result.code = ResultCode::NOT_FOUND;
+            result.message = "Reservation not found at " + args[2] + ".";
+            return result;
+        }
+        result.roomNumber = r.getAssignedRoomNumber();
+        result.totalCost = r.getTotalCost();
+        result.message = "Reservation #" + std::to_string(id) + " " + r.getStatusString() + " at " + args[2];
+        return result;
+    }
+    if (operation == "block" || operation == "unblock") {
+        bool block = operation == "block";
+        if (args.size() < 4 || args.size() > (block ? 5u : 4u) ||
+            !parseDateTime(args[2], 0, checkIn) || !parseDateTime(args[3], 0, checkOut)) {
+            return invalid(block ? "block ROOMS YYYY-MM-DD YYYY-MM-DD [\"REASON\"]"
+                                 : "unblock ROOMS YYYY-MM-DD YYYY-MM-DD");
+        }
+        std::vector<int> roomNumbers = hotel.parseRoomList(args[1]);
+        int fromDay = toDayIndex(checkIn), toDay = toDayIndex(checkOut);
+        return block ? hotel.blockRooms(roomNumbers, fromDay, toDay, args.size() == 5 ? args[4] : "")
+                     : hotel.unblockRooms(roomNumbers, fromDay, toDay);
+    }
+    if (operation == "save") {
+        if (!hotel.saveData()) {
+            result.code = ResultCode::INVALID_STATE;
+            result.message = "Some data files could not be written; they will be retried.";
+            return result;
+        }
+        result.message = "Saved.";
+        return result;
+    }
+
+    result.code = ResultCode::BAD_COMMAND;
+    result.message = "Unknown command: " + operation;
+    return result;
+}
+
+BatchStats BatchExecutor::runFile(const std::string& path, std::ostream* log) {
+    BatchStats stats;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << path << " for reading.\n";
+        return stats;
+    }
+
+    auto batchStart = std::chrono::steady_clock::now();
+    std::string line;
+    std::string operation;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        auto start = std::chrono::steady_clock::now();
+        OperationResult result = execute(line, operation);
+        double micros = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count();
+        if (operation.empty()) continue;
+
+        ++stats.commands;
+        OperationTiming& timing = stats.byOperation[operation];
+        ++timing.count;
+        timing.totalMicros += micros;
+        if (micros > timing.maxMicros) timing.maxMicros = micros;
+
+        // A PENDING reservation is still a successfully executed command
+        if (result.ok() || result.code == ResultCode::NO_AVAILABILITY) {
+            ++stats.succeeded;
+        } else {
+            ++stats.failed;
+            ++timing.failures;
+            if (result.code == ResultCode::BAD_COMMAND) ++stats.parseErrors;
+        }
+
+        if (log) {
+            *log << lineNumber << ": " << operation << " -> " << result.message;
+            if (result.id > 0) *log << " [id " << result.id << "]";
+            *log << "\n";
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+    return stats;
+}
+
+void BatchExecutor::printStats(const BatchStats& stats, std::ostream& out) {
+    out << "\n========== BATCH SUMMARY ==========\n";
+    out << "Commands: " << stats.commands << " (" << stats.succeeded << " ok, "
+        << stats.failed << " failed, " << stats.parseErrors << " unparseable)\n";
+    out << "Elapsed: " << std::fixed << std::setprecision(3) << stats.seconds << " s\n";
+    if (stats.seconds > 0.0) {
+        out << "Throughput: " << std::setprecision(0) << stats.commands / stats.seconds << " ops/sec\n";
+    }
+    out << "\n" << std::left << std::setw(20) << "Operation" << std::right
+        << std::setw(10) << "Count" << std::setw(10) << "Failed"
+        << std::setw(12) << "Avg us" << std::setw(12) << "Max us" << "\n";
+    out << std::setprecision(1);
+    for (const auto& entry : stats.byOperation) {
+        const OperationTiming& t = entry.second;
+        out << std::left << std::setw(20) << entry.first << std::right
+            << std::setw(10) << t.count << std::setw(10) << t.failures
+            << std::setw(12) << t.totalMicros / t.count
+            << std::setw(12) << t.maxMicros << "\n";
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef BATCH_EXECUTOR_H
+#define BATCH_EXECUTOR_H
+
+#include "HotelSystem.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+struct OperationTiming {
+    size_t count = 0;
+    size_t failures = 0;
+    double totalMicros = 0.0;
+    double maxMicros = 0.0;
+};
+
+struct BatchStats {
+    size_t commands = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    size_t parseErrors = 0;
+    double seconds = 0.0;
+    std::map<std::string, OperationTiming> byOperation;
+};
+
+// Drives HotelSystem's non-interactive API from text commands, one per
+// line. Blank lines and lines starting with '#' are skipped; arguments
+// containing spaces are double-quoted. Dates are YYYY-MM-DD or
+// YYYY-MM-DDTHH[:MM[:SS]] (check-in defaults to 14:00, check-out to 11:00).
+//
+//   add_customer "NAME" EMAIL PHONE
+//   modify_customer ID NAME|- EMAIL|- PHONE|-
+//   delete_customer ID
+//   create_reservation CUSTOMER_ID single|double|suite|deluxe CHECK_IN CHECK_OUT
+//   create_group CUSTOMER_ID TYPE[:COUNT][,TYPE[:COUNT]...] CHECK_IN CHECK_OUT
+//   cancel ID
+//   make_room ID                      confirm a pending stay by moving others
+//   reschedule [revenue]              every active stay again; "revenue" keeps
+//                                     the most valuable ones per room type
+//   check_in ID
+//   check_out ID
+//   availability TYPE CHECK_IN CHECK_OUT
+//   lookup ID
+//   arrivals [DATE]                   reservations as #ID/ROOM; DATE defaults
+//   departures [DATE]                 to today
+//   in_house
+//   query [status=S[,S...]] [customer=ID] [room=N] [type=T] [from=DATE] [to=DATE]
+//         [sort=id|check_in|check_out|cost] [desc] [limit=N] [after=CURSOR]
+//                                     one page of matching reservations (see
+//                                     ReservationQuery.h); S is pending,
+//                                     confirmed, checked_in, checked_out or
+//                                     cancelled; DATEs bound the check-in day,
+//                                     to exclusive; after= takes the previous
+//                                     page's next= cursor
+//   lookup_at ID WHEN                 as it stood then (from the history);
+//                                     a bare date means 23:00 that day
+//   block ROOMS FROM TO ["REASON"]    ROOMS as in "101,102" or "301-399";
+//   unblock ROOMS FROM TO             FROM/TO are dates, TO exclusive
+//   save
+class BatchExecutor {
+private:
+    HotelSystem& hotel;
+
+    static bool tokenize(const std::string& line, std::vector<std::string>& tokens);
+    static bool parseDateTime(const std::string& text, int defaultHour, time_t& out);
+    static bool parseRoomType(const std::string& text, RoomType& out);
+    static bool parseId(const std::string& text, int& out);
+
+public:
+    explicit BatchExecutor(HotelSystem& hotel);
+
+    // operation receives the command name ("" for blank/comment lines)
+    OperationResult execute(const std::string& line, std::string& operation);
+
+    // Executes every command in the file through the real code path and
+    // times each one. Per-command results go to log when given.
+    BatchStats runFile(const std::string& path, std::ostream* log = nullptr);
+
+    static void printStats(const BatchStats& stats, std::ostream& out);
+};
+
+#endif
@@ -0,0 +1,125 @@
+// Capacity planning: runs DemandSimulator trials of one year of demand
+// against a room inventory and prints percentiles of occupancy, turned-away
+// requests and revenue. The inventory is either per-type room counts
+// (--rooms) or the rooms.json of a data directory (--data).
+#include "DemandSimulator.h"
+#include "Room.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    const int64_t TYPE_PRICE[ROOM_TYPE_COUNT] = {10000, 15000, 25000, 35000};
+
+    bool parseList(const std::string& list, std::vector<double>& out) {
+        out.clear();
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            char* end = nullptr;
+            double value = std::strtod(item.c_str(), &end);
+            if (end == item.c_str() || *end != '\0' || value < 0) return false;
+            out.push_back(value);
+        }
+        return out.size() == ROOM_TYPE_COUNT;
+    }
+
+    bool loadRooms(const std::string& directory, std::vector<Room>& rooms) {
+        std::ifstream file(directory + "/rooms.json");
+        if (!file.is_open()) return false;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) rooms.push_back(Room::deserialize(line));
+        }
+        return !rooms.empty();
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program
+                  << " [--trials N] [--threads N] [--seed N] [--rooms S,D,SU,DE | --data DIR]"
+                     " [--days N] [--arrivals PER_DAY] [--season AMPLITUDE] [--weekend FACTOR]"
+                     " [--lead DAYS] [--nights MEAN] [--cancel RATE] [--no-show RATE] [--mix S,D,SU,DE]\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t trials = 1000;
+    unsigned threads = 0;
+    uint64_t seed = 42;
+    std::vector<double> roomCounts = {40, 30, 20, 10};
+    std::string dataDirectory;
+    DemandModel model;
+
+    for (int i = 1; i < argc; ++i) {
+        std::vector<double> list;
+        if (std::strcmp(argv[i], "--trials") == 0 && i + 1 < argc) {
+            trials = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--rooms") == 0 && i + 1 < argc) {
+            if (!parseList(argv[++i], roomCounts)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            dataDirectory = argv[++i];
+        } else if (std::strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            model.days = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--arrivals") == 0 && i + 1 < argc) {
+            model.arrivalsPerDay = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--season") == 0 && i + 1 < argc) {
+            model.seasonAmplitude = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--weekend") == 0 && i + 1 < argc) {
+            model.weekendFactor = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--lead") == 0 && i + 1 < argc) {
+            model.meanLeadDays = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nights") == 0 && i + 1 < argc) {
+            model.meanNights = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--cancel") == 0 && i + 1 < argc) {
+            model.cancelRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-show") == 0 && i + 1 < argc) {
+            model.noShowRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--mix") == 0 && i + 1 < argc) {
+            if (!parseList(argv[++i], list)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            for (int t = 0; t < ROOM_TYPE_COUNT; ++t) model.typeShare[t] = list[t];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (trials == 0 || model.days <= 0 || model.arrivalsPerDay < 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Room> rooms;
+    if (!dataDirectory.empty()) {
+        if (!loadRooms(dataDirectory, rooms)) {
+            std::cerr << "No rooms found in " << dataDirectory << "/rooms.json\n";
+            return 1;
+        }
+    } else {
+        for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+            for (int i = 0; i < static_cast<int>(roomCounts[t]); ++i) {
+                rooms.push_back(Room((t + 1) * 1000 + i + 1, static_cast<RoomType>(t),
+                                     Money::fromCents(TYPE_PRICE[t])));
+            }
+        }
+    }
+
+    std::cout << "\n========== CAPACITY PLANNER ==========\n";
+    std::cout << rooms.size() << " rooms, " << model.arrivalsPerDay << " arrivals/day over "
+              << model.days << " days, seed " << seed << "\n";
+    DemandSimulator simulator(rooms, model, seed);
+    DemandSimulator::printReport(simulator.run(trials, threads), std::cout);
+    return 0;
+}
@@ -1,9 +1,11 @@
 #include "Customer.h"
+#include "Metrics.h"
+#include "ReportBuffer.h"
 #include <sstream>
 #include <vector>
 #include <cctype>
 
-int Customer::nextId = 1;
+IdAllocator<Customer> Customer::ids;
 
 namespace {
     std::string escapeJson(const std::string& input) {
@@ -103,18 +105,21 @@ namespace {
 Customer::Customer() : id(0), name(""), email(""), phone("") {}
 
 Customer::Customer(const std::string& name, const std::string& email, const std::string& phone)
-    : id(nextId++), name(name), email(email), phone(phone) {}
+    : id(ids.allocate()), name(name), email(email), phone(phone) {}
 
 Customer::Customer(int id, const std::string& name, const std::string& email, const std::string& phone)
-    : id(id), name(name), email(email), phone(phone) {
-    if (id >= nextId) nextId = id + 1;
-}
+    : id(id), name(name), email(email), phone(phone) {}
 
 void Customer::display() const {
-    std::cout << "Customer ID: " << id << "\n"
-              << "Name: " << name << "\n"
-              << "Email: " << email << "\n"
-              << "Phone: " << phone << "\n";
+    ReportBuffer out(std::cout);
+    render(out);
+}
+
+void Customer::render(ReportBuffer& out) const {
+    out << "Customer ID: " << id << "\n"
+        << "Name: " << name << "\n"
+        << "Email: " << email << "\n"
+        << "Phone: " << phone << "\n";
 }
 
 std::string Customer::serialize() const {
@@ -129,6 +134,8 @@ std::string Customer::serialize() const {
 }
 
 Customer Customer::deserialize(const std::string& data) {
+    HOTEL_TIME_SCOPE(Timer::DESERIALIZE_CUSTOMER);
+    HOTEL_COUNT(Counter::RECORDS_PARSED, 1);
     long long idVal = 0;
     std::string nameVal, emailVal, phoneVal;
 
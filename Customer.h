@@ -3,6 +3,9 @@
 
 #include <string>
 #include <iostream>
+#include "IdAllocator.h"
+
+class ReportBuffer;
 
 class Customer {
 private:
@@ -10,7 +13,7 @@ private:
     std::string name;
     std::string email;
     std::string phone;
-    static int nextId;
+    static IdAllocator<Customer> ids;
 
 public:
     Customer();
@@ -27,10 +30,11 @@ public:
     void setPhone(const std::string& p) { phone = p; }
     
     void display() const;
+    void render(ReportBuffer& out) const;
     
     std::string serialize() const;
     static Customer deserialize(const std::string& data);
-    static void setNextId(int id) { nextId = id; }
+    static void setNextId(int id) { ids.reset(id); }
 };
 
 #endif
@@ -0,0 +1,66 @@
+#include "DateUtils.h"
+#include <cstdio>
+
+std::tm toLocalTm(time_t t) {
+    std::tm out = {};
+#ifdef _WIN32
+    localtime_s(&out, &t);
+#else
+    localtime_r(&t, &out);
+#endif
+    return out;
+}
+
+int dayIndexFromCivil(int year, int month, int day) {
+    // Howard Hinnant's days_from_civil
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = year - era * 400;
+    const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void civilFromDayIndex(int dayIndex, int& year, int& month, int& day) {
+    dayIndex += 719468;
+    const int era = (dayIndex >= 0 ? dayIndex : dayIndex - 146096) / 146097;
+    const int doe = dayIndex - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + (month <= 2);
+}
+
+int toDayIndex(time_t t) {
+    std::tm tm = toLocalTm(t);
+    return dayIndexFromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+}
+
+time_t fromDayIndex(int dayIndex, int hour) {
+    int year, month, day;
+    civilFromDayIndex(dayIndex, year, month, day);
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+std::string formatTimestamp(time_t t, const char* format) {
+    std::tm tm = toLocalTm(t);
+    char buf[64];
+    size_t n = std::strftime(buf, sizeof(buf), format, &tm);
+    return std::string(buf, n);
+}
+
+std::string formatDay(int dayIndex) {
+    int year, month, day;
+    civilFromDayIndex(dayIndex, year, month, day);
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d", year, month, day);
+    return buf;
+}
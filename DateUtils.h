@@ -0,0 +1,21 @@
+#ifndef DATE_UTILS_H
+#define DATE_UTILS_H
+
+#include <ctime>
+#include <string>
+
+// Calendar days are counted as local dates since 1970-01-01, so a stay
+// occupies the nights [toDayIndex(checkIn), toDayIndex(checkOut)).
+int toDayIndex(time_t t);
+time_t fromDayIndex(int dayIndex, int hour = 0);
+
+int dayIndexFromCivil(int year, int month, int day);
+void civilFromDayIndex(int dayIndex, int& year, int& month, int& day);
+
+std::string formatDay(int dayIndex);
+// localtime_r / localtime_s
+std::tm toLocalTm(time_t t);
+// strftime on the local time; safe to call from worker threads
+std::string formatTimestamp(time_t t, const char* format);
+
+#endif
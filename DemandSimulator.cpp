@@ -0,0 +1,295 @@
+#include "DemandSimulator.h"
+#include "Scheduler.h"
+#include "DateUtils.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+namespace {
+    const int MAX_LEAD_DAYS = 330;
+    const double PI = 3.14159265358979323846;
+
+    // Same hand-made draws as SyntheticHotel.cpp: the <random>
+    // distributions differ between standard libraries, these do not
+    class Draw {
+    private:
+        std::mt19937_64 rng;
+
+    public:
+        explicit Draw(uint64_t seed) : rng(seed) {}
+
+        double unit() { return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0); }
+        size_t below(size_t n) { return static_cast<size_t>(unit() * static_cast<double>(n)); }
+        double exponential(double mean) { return -mean * std::log(1.0 - unit()); }
+
+        // Failures before the first success, success probability p
+        int geometric(double p) {
+            if (p >= 1.0) return 0;
+            return static_cast<int>(std::log(1.0 - unit()) / std::log(1.0 - p));
+        }
+
+        // Knuth's method; large means are split so exp(-mean) stays representable
+        int poisson(double mean) {
+            int count = 0;
+            while (mean > 0.0) {
+                double part = std::min(mean, 30.0);
+                mean -= part;
+                double limit = std::exp(-part);
+                double product = unit();
+                while (product > limit) {
+                    ++count;
+                    product *= unit();
+                }
+            }
+            return count;
+        }
+
+        size_t weighted(const double* weights, size_t count) {
+            double total = 0.0;
+            for (size_t i = 0; i < count; ++i) total += weights[i];
+            double x = unit() * total;
+            for (size_t i = 0; i < count; ++i) {
+                if (x < weights[i]) return i;
+                x -= weights[i];
+            }
+            return count - 1;
+        }
+    };
+
+    uint64_t mixSeed(uint64_t seed, uint64_t trial) {
+        // splitmix64 finalizer, so neighbouring trials get unrelated streams
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull * (trial + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    struct Request {
+        int arrivalDay;   // offset from DemandModel::firstDay
+        int nights;
+        int bookDay;
+        int cancelDay;    // -1: not cancelled
+        bool noShow;
+        RoomType type;
+        int reservationId;
+    };
+
+    enum EventKind { CANCEL = 0, BOOK = 1, ARRIVE = 2 };  // order within a day
+
+    struct Event {
+        int day;
+        int kind;
+        int request;
+
+        bool operator<(const Event& o) const {
+            if (day != o.day) return day < o.day;
+            if (kind != o.kind) return kind < o.kind;
+            return request < o.request;
+        }
+    };
+
+    double percentile(const std::vector<double>& sorted, double pct) {
+        if (sorted.empty()) return 0.0;
+        size_t rank = static_cast<size_t>(std::ceil(pct / 100.0 * static_cast<double>(sorted.size())));
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    Percentiles summarize(std::vector<double> values) {
+        Percentiles p;
+        if (values.empty()) return p;
+        std::sort(values.begin(), values.end());
+        p.p5 = percentile(values, 5);
+        p.p50 = percentile(values, 50);
+        p.p95 = percentile(values, 95);
+        double total = 0.0;
+        for (double v : values) total += v;
+        p.mean = total / static_cast<double>(values.size());
+        return p;
+    }
+}
+
+struct DemandSimulator::Worker {
+    std::vector<Request> requests;
+    std::vector<Event> events;
+    std::vector<Reservation> reservations;
+    std::vector<Room> rooms;
+    std::vector<RoomBlock> blocks;
+};
+
+DemandSimulator::DemandSimulator(const std::vector<Room>& rooms, const DemandModel& demand, uint64_t seedValue)
+    : inventory(rooms), model(demand), seed(seedValue) {
+    if (model.firstDay == 0) model.firstDay = dayIndexFromCivil(2030, 1, 1);
+    model.days = std::max(1, model.days);
+    model.meanNights = std::max(1.0, model.meanNights);
+
+    double total = 0.0;
+    for (double share : model.typeShare) total += share;
+    if (total <= 0.0) {
+        for (const auto& room : inventory) model.typeShare[static_cast<int>(room.getType())] += 1.0;
+    }
+
+    // mktime is slow, so stamp each possible night once
+    checkInAt.resize(model.days + DemandModel::MAX_NIGHTS + 1);
+    checkOutAt.resize(checkInAt.size());
+    for (size_t d = 0; d < checkInAt.size(); ++d) {
+        checkInAt[d] = fromDayIndex(model.firstDay + static_cast<int>(d), 14);
+        checkOutAt[d] = fromDayIndex(model.firstDay + static_cast<int>(d), 11);
+    }
+    arrivalMean.resize(model.days);
+    for (int d = 0; d < model.days; ++d) {
+        int year, month, day;
+        civilFromDayIndex(model.firstDay + d, year, month, day);
+        int dayOfYear = model.firstDay + d - dayIndexFromCivil(year, 1, 1);
+        double season = 1.0 + model.seasonAmplitude * std::cos(2.0 * PI * (dayOfYear - model.peakDayOfYear) / 365.0);
+        int weekday = ((model.firstDay + d) % 7 + 11) % 7;  // 0 = Sunday; day 0 was a Thursday
+        double weekend = (weekday == 5 || weekday == 6) ? model.weekendFactor : 1.0;
+        arrivalMean[d] = std::max(0.0, model.arrivalsPerDay * season * weekend);
+    }
+}
+
+TrialResult DemandSimulator::runTrial(size_t trial) const {
+    Worker worker;
+    return runTrial(trial, worker);
+}
+
+TrialResult DemandSimulator::runTrial(size_t trial, Worker& worker) const {
+    MetricsPause pause;
+    TrialResult result;
+    Draw draw(mixSeed(seed, trial));
+
+    // The year's requests, in arrival order
+    std::vector<Request>& requests = worker.requests;
+    requests.clear();
+    for (int d = 0; d < model.days; ++d) {
+        int arrivals = draw.poisson(arrivalMean[d]);
+        for (int i = 0; i < arrivals; ++i) {
+            Request r;
+            r.arrivalDay = d;
+            r.nights = std::min(DemandModel::MAX_NIGHTS, 1 + draw.geometric(1.0 / model.meanNights));
+            r.type = static_cast<RoomType>(draw.weighted(model.typeShare, ROOM_TYPE_COUNT));
+            int lead = std::min(MAX_LEAD_DAYS, static_cast<int>(draw.exponential(model.meanLeadDays)));
+            r.bookDay = d - lead;
+            r.cancelDay = -1;
+            if (lead > 0 && draw.unit() < model.cancelRate) {
+                r.cancelDay = r.bookDay + 1 + static_cast<int>(draw.below(static_cast<size_t>(lead)));
+            }
+            r.noShow = r.cancelDay < 0 && draw.unit() < model.noShowRate;
+            r.reservationId = 0;
+            requests.push_back(r);
+        }
+    }
+    result.requests = static_cast<int>(requests.size());
+
+    std::vector<Event>& events = worker.events;
+    events.clear();
+    for (size_t i = 0; i < requests.size(); ++i) {
+        int index = static_cast<int>(i);
+        events.push_back({requests[i].bookDay, BOOK, index});
+        if (requests[i].cancelDay >= 0) {
+            events.push_back({requests[i].cancelDay, CANCEL, index});
+        } else {
+            events.push_back({requests[i].arrivalDay, ARRIVE, index});
+        }
+    }
+    std::sort(events.begin(), events.end());
+
+    // Reservations are created at booking time, so ids follow booking
+    // order and the scheduler finds each one at position id - 1
+    std::vector<Reservation>& reservations = worker.reservations;
+    reservations.clear();
+    reservations.reserve(requests.size());
+    worker.rooms.assign(inventory.begin(), inventory.end());
+    worker.blocks.clear();
+    Scheduler scheduler(worker.rooms, reservations, worker.blocks);
+
+    for (const Event& e : events) {
+        Request& r = requests[e.request];
+        if (e.kind == BOOK) {
+            r.reservationId = static_cast<int>(reservations.size()) + 1;
+            reservations.push_back(Reservation(r.reservationId, 0, checkInAt[r.arrivalDay],
+                                               checkOutAt[r.arrivalDay + r.nights], -1,
+                                               ReservationStatus::PENDING, Money()));
+            reservations.back().setRequestedType(static_cast<int>(r.type));
+            scheduler.scheduleReservation(r.reservationId, r.type);
+        } else if (e.kind == CANCEL) {
+            ++result.cancelled;
+            scheduler.removeReservation(r.reservationId);
+        } else {
+            const Reservation& res = reservations[r.reservationId - 1];
+            if (res.getStatus() == ReservationStatus::PENDING) {
+                ++result.turnedAway;
+                scheduler.removeReservation(r.reservationId);
+            } else if (r.noShow) {
+                ++result.noShows;
+                scheduler.removeReservation(r.reservationId);
+            }
+        }
+    }
+
+    OccupancyReport report = scheduler.getOccupancySeries(model.firstDay, model.firstDay + model.days);
+    result.occupancyRate = report.occupancyRate;
+    result.revenue = report.totalRevenue;
+    return result;
+}
+
+CapacityReport DemandSimulator::run(size_t trials, unsigned threadCount, std::vector<TrialResult>* results) const {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<TrialResult> outcomes(trials);
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, trials));
+
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        Worker worker;
+        for (size_t i = next.fetch_add(1); i < trials; i = next.fetch_add(1)) {
+            outcomes[i] = runTrial(i, worker);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t) {
+        threads.emplace_back(work);
+    }
+    if (threadCount > 0) work();
+    for (auto& t : threads) t.join();
+
+    CapacityReport report;
+    report.trials = trials;
+    report.threads = threadCount;
+    std::vector<double> occupancy, turnedAway, turnAwayRate, revenue;
+    for (const auto& o : outcomes) {
+        occupancy.push_back(o.occupancyRate);
+        turnedAway.push_back(o.turnedAway);
+        int kept = o.requests - o.cancelled;
+        turnAwayRate.push_back(kept > 0 ? 100.0 * o.turnedAway / kept : 0.0);
+        revenue.push_back(o.revenue.toDouble());
+    }
+    report.occupancy = summarize(occupancy);
+    report.turnedAway = summarize(turnedAway);
+    report.turnAwayRate = summarize(turnAwayRate);
+    report.revenue = summarize(revenue);
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (results) results->swap(outcomes);
+    return report;
+}
+
+void DemandSimulator::printReport(const CapacityReport& report, std::ostream& out) {
+    out << report.trials << " trials on " << report.threads << " thread(s) in "
+        << std::fixed << std::setprecision(2) << report.seconds << " s\n\n";
+    out << std::left << std::setw(20) << "Metric" << std::right
+        << std::setw(14) << "p5" << std::setw(14) << "p50" << std::setw(14) << "p95"
+        << std::setw(14) << "mean" << "\n";
+    auto row = [&](const char* name, const Percentiles& p, int precision) {
+        out << std::left << std::setw(20) << name << std::right << std::setprecision(precision)
+            << std::setw(14) << p.p5 << std::setw(14) << p.p50 << std::setw(14) << p.p95
+            << std::setw(14) << p.mean << "\n";
+    };
+    row("Occupancy %", report.occupancy, 2);
+    row("Turned away", report.turnedAway, 0);
+    row("Turned away %", report.turnAwayRate, 2);
+    row("Revenue", report.revenue, 2);
+}
@@ -0,0 +1,88 @@
+#ifndef DEMAND_SIMULATOR_H
+#define DEMAND_SIMULATOR_H
+
+#include "Room.h"
+#include "Money.h"
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+// Demand for one simulated year. Arrivals per day are Poisson around
+// arrivalsPerDay, scaled by a yearly cosine peaking on peakDayOfYear and by
+// weekendFactor on Friday and Saturday arrivals. Each request is booked
+// leadDays ahead (exponential), stays 1 + geometric nights (at most
+// MAX_NIGHTS), picks a room type by typeShare (zeros: the inventory's mix),
+// and is later cancelled or a no-show with the given probabilities.
+struct DemandModel {
+    static const int MAX_NIGHTS = 28;
+
+    int firstDay = 0;             // day index of the first arrival night; 0: 2030-01-01
+    int days = 365;
+    double arrivalsPerDay = 20.0;
+    double seasonAmplitude = 0.3; // 0.3: peak day sees 1.3x, the trough 0.7x
+    int peakDayOfYear = 196;      // mid July
+    double weekendFactor = 1.2;
+    double meanLeadDays = 21.0;
+    double meanNights = 2.5;
+    double cancelRate = 0.10;     // cancelled between booking and arrival
+    double noShowRate = 0.03;     // never arrives; the room is released that day
+    double typeShare[ROOM_TYPE_COUNT] = {0, 0, 0, 0};
+};
+
+struct TrialResult {
+    int requests = 0;
+    int cancelled = 0;
+    int noShows = 0;
+    int turnedAway = 0;           // still without a room on the arrival day
+    double occupancyRate = 0.0;   // percent of room-nights over the year
+    Money revenue;
+};
+
+struct Percentiles {
+    double p5 = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double mean = 0.0;
+};
+
+struct CapacityReport {
+    size_t trials = 0;
+    unsigned threads = 0;
+    double seconds = 0.0;
+    Percentiles occupancy;        // percent
+    Percentiles turnedAway;       // requests
+    Percentiles turnAwayRate;     // percent of requests that were not cancelled
+    Percentiles revenue;          // currency units
+};
+
+// Discrete-event Monte Carlo over the real Scheduler: booking, cancellation
+// and arrival events of one generated year replayed in time order against
+// the room inventory, for many independent trials. Trial i always draws
+// from a generator seeded by (seed, i), so results do not depend on the
+// thread count. Each worker thread reuses its own request, event and
+// reservation buffers from trial to trial. Trials use their own ids and
+// are not recorded in Metrics, so they share nothing with the live hotel.
+class DemandSimulator {
+private:
+    std::vector<Room> inventory;
+    DemandModel model;
+    uint64_t seed;
+    std::vector<time_t> checkInAt;   // per night offset from model.firstDay
+    std::vector<time_t> checkOutAt;
+    std::vector<double> arrivalMean; // expected arrivals per day
+
+    struct Worker;  // per-thread buffers (DemandSimulator.cpp)
+
+    TrialResult runTrial(size_t trial, Worker& worker) const;
+
+public:
+    DemandSimulator(const std::vector<Room>& rooms, const DemandModel& model, uint64_t seed);
+
+    TrialResult runTrial(size_t trial) const;
+    CapacityReport run(size_t trials, unsigned threadCount = 0, std::vector<TrialResult>* results = nullptr) const;
+
+    static void printReport(const CapacityReport& report, std::ostream& out);
+};
+
+#endif
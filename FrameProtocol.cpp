@@ -0,0 +1,102 @@
+#include "FrameProtocol.h"
+#include <cstdio>
+#include <cerrno>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace {
+    void putU32(std::string& out, uint32_t v) {
+        out += static_cast<char>((v >> 24) & 0xFF);
+        out += static_cast<char>((v >> 16) & 0xFF);
+        out += static_cast<char>((v >> 8) & 0xFF);
+        out += static_cast<char>(v & 0xFF);
+    }
+
+    uint32_t getU32(const char* p) {
+        const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+        return (static_cast<uint32_t>(u[0]) << 24) | (static_cast<uint32_t>(u[1]) << 16) |
+               (static_cast<uint32_t>(u[2]) << 8) | static_cast<uint32_t>(u[3]);
+    }
+}
+
+void appendFrame(std::string& out, uint32_t requestId, const std::string& payload) {
+    putU32(out, static_cast<uint32_t>(payload.size()));
+    putU32(out, requestId);
+    out += payload;
+}
+
+int decodeFrame(const std::string& buffer, size_t& offset, uint32_t& requestId, std::string& payload) {
+    if (buffer.size() - offset < FRAME_HEADER_SIZE) return 0;
+    uint32_t length = getU32(buffer.data() + offset);
+    if (length > FRAME_MAX_PAYLOAD) return -1;
+    if (buffer.size() - offset < FRAME_HEADER_SIZE + length) return 0;
+
+    requestId = getU32(buffer.data() + offset + 4);
+    payload.assign(buffer, offset + FRAME_HEADER_SIZE, length);
+    offset += FRAME_HEADER_SIZE + length;
+    return 1;
+}
+
+std::string encodeResponse(const ResponseFrame& response) {
+    char head[80];
+    std::snprintf(head, sizeof(head), "%d %d %d %lld ", response.code, response.id,
+                  response.roomNumber, static_cast<long long>(response.cents));
+    return head + response.message;
+}
+
+bool decodeResponse(const std::string& payload, ResponseFrame& out) {
+    long long cents = 0;
+    int consumed = 0;
+    if (std::sscanf(payload.c_str(), "%d %d %d %lld %n", &out.code, &out.id,
+                    &out.roomNumber, &cents, &consumed) < 4) {
+        return false;
+    }
+    out.cents = cents;
+    out.message = payload.substr(static_cast<size_t>(consumed));
+    return true;
+}
+
+#ifdef __linux__
+bool writeFrame(int fd, uint32_t requestId, const std::string& payload) {
+    std::string frame;
+    appendFrame(frame, requestId, payload);
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = ::write(fd, frame.data() + sent, frame.size() - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readFrame(int fd, uint32_t& requestId, std::string& payload) {
+    std::string buffer;
+    char chunk[4096];
+    size_t offset = 0;
+    while (true) {
+        int status = decodeFrame(buffer, offset, requestId, payload);
+        if (status == 1) return true;
+        if (status < 0) return false;
+
+        // Read no further than the current frame so pipelined frames stay queued in the socket
+        size_t want = FRAME_HEADER_SIZE;
+        if (buffer.size() >= FRAME_HEADER_SIZE) {
+            const unsigned char* u = reinterpret_cast<const unsigned char*>(buffer.data());
+            uint32_t length = (static_cast<uint32_t>(u[0]) << 24) | (static_cast<uint32_t>(u[1]) << 16) |
+                              (static_cast<uint32_t>(u[2]) << 8) | static_cast<uint32_t>(u[3]);
+            want = FRAME_HEADER_SIZE + length;
+        }
+        size_t missing = want - buffer.size();
+        ssize_t n = ::read(fd, chunk, missing < sizeof(chunk) ? missing : sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+}
+#else
+bool writeFrame(int, uint32_t, const std::string&) { return false; }
+bool readFrame(int, uint32_t&, std::string&) { return false; }
+#endif
@@ -0,0 +1,40 @@
+#ifndef FRAME_PROTOCOL_H
+#define FRAME_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+
+// Wire format shared by the reservation server and its clients.
+//
+// Every message is a frame: 4-byte payload length and 4-byte request id,
+// both big-endian, followed by the payload. A request payload is one
+// BatchExecutor command line; the response echoes the request id so a
+// client may pipeline several requests on one connection.
+//
+// Response payload: "<code> <id> <room> <cents> <message>"
+
+const uint32_t FRAME_HEADER_SIZE = 8;
+const uint32_t FRAME_MAX_PAYLOAD = 64 * 1024;
+
+struct ResponseFrame {
+    int code = 0;        // ResultCode value
+    int id = 0;
+    int roomNumber = -1;
+    int64_t cents = 0;
+    std::string message;
+};
+
+void appendFrame(std::string& out, uint32_t requestId, const std::string& payload);
+
+// Returns 1 when a whole frame starting at offset was decoded (offset is
+// advanced past it), 0 when more bytes are needed, -1 on a corrupt frame.
+int decodeFrame(const std::string& buffer, size_t& offset, uint32_t& requestId, std::string& payload);
+
+std::string encodeResponse(const ResponseFrame& response);
+bool decodeResponse(const std::string& payload, ResponseFrame& out);
+
+// Blocking helpers for simple clients
+bool writeFrame(int fd, uint32_t requestId, const std::string& payload);
+bool readFrame(int fd, uint32_t& requestId, std::string& payload);
+
+#endif
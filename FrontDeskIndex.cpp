@@ -0,0 +1,93 @@
+#include "FrontDeskIndex.h"
+#include "DateUtils.h"
+
+void FrontDeskIndex::insert(std::vector<size_t>& list, size_t position, size_t Entry::*slot) {
+    entries[position].*slot = list.size();
+    list.push_back(position);
+}
+
+void FrontDeskIndex::remove(std::vector<size_t>& list, size_t position, size_t Entry::*slot) {
+    size_t at = entries[position].*slot;
+    size_t last = list.back();
+    list[at] = last;
+    entries[last].*slot = at;
+    list.pop_back();
+    entries[position].*slot = NONE;
+}
+
+void FrontDeskIndex::place(size_t position, const Reservation& r) {
+    Entry& e = entries[position];
+    ReservationStatus status = r.getStatus();
+    e.arrivalDay = toDayIndex(r.getCheckInTime());
+    e.departureDay = toDayIndex(r.getCheckOutTime());
+    if (status != ReservationStatus::CANCELLED) {
+        insert(arrivalsByDay[e.arrivalDay], position, &Entry::arrivalSlot);
+    }
+    if (status == ReservationStatus::CONFIRMED || status == ReservationStatus::CHECKED_IN ||
+        status == ReservationStatus::CHECKED_OUT) {
+        insert(departuresByDay[e.departureDay], position, &Entry::departureSlot);
+    }
+    if (status == ReservationStatus::CHECKED_IN) {
+        insert(guests, position, &Entry::inHouseSlot);
+    }
+    e.customerId = r.getCustomerId();
+    insert(byCustomer[e.customerId], position, &Entry::customerSlot);
+    e.roomNumber = r.getAssignedRoomNumber();
+    if (e.roomNumber > 0) insert(byRoom[e.roomNumber], position, &Entry::roomSlot);
+}
+
+void FrontDeskIndex::unplace(size_t position) {
+    const Entry& e = entries[position];
+    if (e.arrivalSlot != NONE) remove(arrivalsByDay[e.arrivalDay], position, &Entry::arrivalSlot);
+    if (e.departureSlot != NONE) remove(departuresByDay[e.departureDay], position, &Entry::departureSlot);
+    if (e.inHouseSlot != NONE) remove(guests, position, &Entry::inHouseSlot);
+    if (e.customerSlot != NONE) remove(byCustomer[e.customerId], position, &Entry::customerSlot);
+    if (e.roomSlot != NONE) remove(byRoom[e.roomNumber], position, &Entry::roomSlot);
+}
+
+void FrontDeskIndex::rebuild(const std::vector<Reservation>& reservations) {
+    std::lock_guard<std::mutex> guard(mutex);
+    entries.assign(reservations.size(), Entry());
+    arrivalsByDay.clear();
+    departuresByDay.clear();
+    byCustomer.clear();
+    byRoom.clear();
+    guests.clear();
+    for (size_t i = 0; i < reservations.size(); ++i) place(i, reservations[i]);
+}
+
+void FrontDeskIndex::update(size_t position, const Reservation& r) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (position >= entries.size()) entries.resize(position + 1);
+    unplace(position);
+    place(position, r);
+}
+
+std::vector<size_t> FrontDeskIndex::arrivals(int day) const {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = arrivalsByDay.find(day);
+    return it == arrivalsByDay.end() ? std::vector<size_t>() : it->second;
+}
+
+std::vector<size_t> FrontDeskIndex::departures(int day) const {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = departuresByDay.find(day);
+    return it == departuresByDay.end() ? std::vector<size_t>() : it->second;
+}
+
+std::vector<size_t> FrontDeskIndex::inHouse() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return guests;
+}
+
+std::vector<size_t> FrontDeskIndex::forCustomer(int customerId) const {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = byCustomer.find(customerId);
+    return it == byCustomer.end() ? std::vector<size_t>() : it->second;
+}
+
+std::vector<size_t> FrontDeskIndex::forRoom(int roomNumber) const {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = byRoom.find(roomNumber);
+    return it == byRoom.end() ? std::vector<size_t>() : it->second;
+}
@@ -0,0 +1,66 @@
+#ifndef FRONT_DESK_INDEX_H
+#define FRONT_DESK_INDEX_H
+
+#include "Reservation.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Reservation positions bucketed by local check-in and check-out day,
+// customer and room, plus the guests currently checked in, so the front
+// desk's lists and searches cost O(k) in the stays they return instead of
+// a scan of the whole book. Positions are indices into HotelSystem's
+// reservation vector, which only ever grows between rebuilds. Each list is
+// kept as a vector with every member remembering its slot, so moves in and
+// out are O(1).
+//
+//   arrivals(day)    check-in on day, not cancelled (waitlisted included)
+//   departures(day)  check-out on day, holding or having held a room
+//   inHouse()        CHECKED_IN
+//   forCustomer(id)  every reservation of the customer
+//   forRoom(number)  every reservation assigned to the room, any status
+//
+// update() must see every change to a reservation's dates or status;
+// HotelSystem calls it wherever it marks a reservation changed.
+// Thread-safe.
+class FrontDeskIndex {
+private:
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    struct Entry {
+        int arrivalDay = 0;
+        int departureDay = 0;
+        int customerId = 0;
+        int roomNumber = -1;
+        size_t arrivalSlot = NONE;
+        size_t departureSlot = NONE;
+        size_t inHouseSlot = NONE;
+        size_t customerSlot = NONE;
+        size_t roomSlot = NONE;
+    };
+
+    std::vector<Entry> entries;  // by reservation position
+    std::unordered_map<int, std::vector<size_t>> arrivalsByDay;
+    std::unordered_map<int, std::vector<size_t>> departuresByDay;
+    std::unordered_map<int, std::vector<size_t>> byCustomer;
+    std::unordered_map<int, std::vector<size_t>> byRoom;
+    std::vector<size_t> guests;
+    mutable std::mutex mutex;
+
+    void place(size_t position, const Reservation& r);
+    void unplace(size_t position);
+    void insert(std::vector<size_t>& list, size_t position, size_t Entry::*slot);
+    void remove(std::vector<size_t>& list, size_t position, size_t Entry::*slot);
+
+public:
+    void rebuild(const std::vector<Reservation>& reservations);
+    void update(size_t position, const Reservation& r);
+
+    std::vector<size_t> arrivals(int day) const;
+    std::vector<size_t> departures(int day) const;
+    std::vector<size_t> inHouse() const;
+    std::vector<size_t> forCustomer(int customerId) const;
+    std::vector<size_t> forRoom(int roomNumber) const;
+};
+
+#endif
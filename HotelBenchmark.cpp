@@ -0,0 +1,410 @@
+// Scheduler and persistence benchmarks over generated hotels (see
+// SyntheticHotel.h). Every scale runs the same steps on the same data for a
+// given seed, so results from two builds can be compared directly:
+//   generate, schedule_reservations (bulk), schedule_revenue (the bulk
+//   pass keeping the most valuable stays per type), schedule_reservation (one
+//   booking at a time, in booking order, first-fit), schedule_best_fit
+//   (the same bookings under AssignmentPolicy::BEST_FIT), remove_reservation,
+//   the occupancy and revenue reports, load_data, snapshot_publish, save_data.
+// The booking steps and schedule_revenue also report the share of bookings
+// that got a room.
+// Per-operation steps stop once they exceed the time budget and are marked
+// truncated; the bulk passes cannot be interrupted, so they are skipped above
+// --bulk-limit. Results go to stdout as a table and, with --json, to a file.
+#include "HotelSystem.h"
+#include "Metrics.h"
+#include "SyntheticHotel.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    struct BenchResult {
+        size_t scale = 0;
+        std::string name;
+        size_t ops = 0;
+        double seconds = 0.0;
+        uint64_t p50Nanos = 0;
+        uint64_t p99Nanos = 0;
+        uint64_t maxNanos = 0;
+        bool truncated = false;
+        bool skipped = false;
+        double acceptedPct = -1.0;  // bookings confirmed, for the booking steps
+    };
+
+    struct Options {
+        std::vector<size_t> scales = {1000, 10000, 100000};
+        uint64_t seed = 42;
+        double budgetSeconds = 10.0;
+        size_t bulkLimit = 50000;
+        size_t samples = 1000;     // remove_reservation operations per scale
+        size_t perRoom = 0;        // reservations per room; 0: SyntheticSpec's default
+        int reportRepeats = 5;
+        std::string jsonFile;
+    };
+
+    uint64_t nanosSince(Clock::time_point start) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Times single operations into a histogram and stops at the budget
+    class Timing {
+    private:
+        LatencyHistogram histogram;
+        Clock::time_point begin = Clock::now();
+        double budget;
+        size_t ops = 0;
+
+    public:
+        explicit Timing(double budgetSeconds) : budget(budgetSeconds) {}
+
+        template <typename Fn>
+        void run(Fn&& operation) {
+            auto start = Clock::now();
+            operation();
+            histogram.record(nanosSince(start));
+            ++ops;
+        }
+
+        bool overBudget() const { return secondsSince(begin) > budget; }
+
+        BenchResult finish(size_t scale, const std::string& name, bool truncated = false) const {
+            BenchResult r;
+            r.scale = scale;
+            r.name = name;
+            r.ops = ops;
+            r.seconds = static_cast<double>(histogram.getTotalNanos()) / 1e9;
+            r.p50Nanos = histogram.percentileNanos(50);
+            r.p99Nanos = histogram.percentileNanos(99);
+            r.maxNanos = histogram.getMaxNanos();
+            r.truncated = truncated;
+            return r;
+        }
+    };
+
+    BenchResult skipped(size_t scale, const std::string& name) {
+        BenchResult r;
+        r.scale = scale;
+        r.name = name;
+        r.skipped = true;
+        return r;
+    }
+
+    void printRow(const BenchResult& r) {
+        std::cout << std::fixed << std::setw(10) << r.scale << "  " << std::left << std::setw(22) << r.name
+                  << std::right;
+        if (r.skipped) {
+            std::cout << std::setw(10) << "-" << "  skipped (--bulk-limit)\n";
+            return;
+        }
+        double rate = r.seconds > 0.0 ? static_cast<double>(r.ops) / r.seconds : 0.0;
+        std::cout << std::setw(10) << r.ops
+                  << std::setw(11) << std::setprecision(3) << r.seconds
+                  << std::setw(13) << std::setprecision(0) << rate
+                  << std::setw(12) << std::setprecision(2) << r.p50Nanos / 1000.0
+                  << std::setw(12) << r.p99Nanos / 1000.0
+                  << (r.truncated ? "  truncated (budget)" : "");
+        if (r.acceptedPct >= 0.0) std::cout << "  accepted " << std::setprecision(1) << r.acceptedPct << "%";
+        std::cout << "\n";
+    }
+
+    void writeJson(const Options& options, const std::vector<BenchResult>& results, std::ostream& out) {
+        out << "{\"suite\":\"hotel_bench\",\"seed\":" << options.seed
+            << ",\"budget_seconds\":" << options.budgetSeconds
+            << ",\"bulk_limit\":" << options.bulkLimit
+#ifdef HOTEL_NO_METRICS
+            << ",\"metrics\":false"
+#else
+            << ",\"metrics\":true"
+#endif
+            << ",\"results\":[";
+        out << std::fixed;
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            double rate = r.seconds > 0.0 ? static_cast<double>(r.ops) / r.seconds : 0.0;
+            out << (i ? "," : "") << "\n  {\"scale\":" << r.scale
+                << ",\"benchmark\":\"" << r.name << "\""
+                << ",\"ops\":" << r.ops
+                << ",\"seconds\":" << std::setprecision(9) << r.seconds
+                << ",\"ops_per_sec\":" << std::setprecision(3) << rate
+                << ",\"p50_ns\":" << r.p50Nanos
+                << ",\"p99_ns\":" << r.p99Nanos
+                << ",\"max_ns\":" << r.maxNanos;
+            if (r.acceptedPct >= 0.0) out << ",\"accepted_pct\":" << std::setprecision(3) << r.acceptedPct;
+            out
+                << ",\"truncated\":" << (r.truncated ? "true" : "false")
+                << ",\"skipped\":" << (r.skipped ? "true" : "false") << "}";
+        }
+        out << "\n]}\n";
+    }
+
+    void runScale(size_t scale, const Options& options, std::vector<BenchResult>& results) {
+        auto emit = [&](const BenchResult& r) {
+            printRow(r);
+            results.push_back(r);
+        };
+
+        SyntheticSpec spec;
+        spec.reservations = scale;
+        spec.seed = options.seed;
+        if (options.perRoom > 0) spec.rooms = std::max<size_t>(8, scale / options.perRoom);
+
+        SyntheticHotel hotel;
+        {
+            Timing t(options.budgetSeconds);
+            t.run([&]() { hotel = generateSyntheticHotel(spec); });
+            BenchResult r = t.finish(scale, "generate");
+            r.ops = scale;
+            emit(r);
+        }
+
+        // Bulk pass over every active reservation, as rescheduleAll runs it
+        if (scale <= options.bulkLimit) {
+            std::vector<Room> rooms = hotel.rooms;
+            std::vector<Reservation> reservations = hotel.reservations;
+            std::vector<RoomBlock> blocks;
+            Scheduler scheduler(rooms, reservations, blocks);
+            size_t active = static_cast<size_t>(std::count_if(reservations.begin(), reservations.end(),
+                [](const Reservation& r) { return r.getStatus() != ReservationStatus::CANCELLED; }));
+            Timing t(options.budgetSeconds);
+            t.run([&]() { scheduler.scheduleReservations(); });
+            BenchResult r = t.finish(scale, "schedule_reservations");
+            r.ops = active;
+            emit(r);
+        } else {
+            emit(skipped(scale, "schedule_reservations"));
+        }
+
+        // The same bulk pass keeping the most valuable stays per requested type
+        if (scale <= options.bulkLimit) {
+            std::vector<Room> rooms = hotel.rooms;
+            std::vector<Reservation> reservations = hotel.reservations;
+            for (size_t i = 0; i < reservations.size(); ++i) {
+                reservations[i].setRequestedType(static_cast<int>(hotel.requestedTypes[i]));
+            }
+            std::vector<RoomBlock> blocks;
+            Scheduler scheduler(rooms, reservations, blocks);
+            Timing t(options.budgetSeconds);
+            t.run([&]() { scheduler.scheduleReservationsForRevenue(); });
+            BenchResult r = t.finish(scale, "schedule_revenue");
+            size_t active = 0, accepted = 0;
+            for (const auto& res : reservations) {
+                if (res.getStatus() == ReservationStatus::CANCELLED) continue;
+                ++active;
+                if (res.getStatus() == ReservationStatus::CONFIRMED) ++accepted;
+            }
+            r.ops = active;
+            r.acceptedPct = active ? 100.0 * static_cast<double>(accepted) / static_cast<double>(active) : 0.0;
+            emit(r);
+        } else {
+            emit(skipped(scale, "schedule_revenue"));
+        }
+
+        // Bookings arrive one at a time
+        auto bookOneByOne = [&](Scheduler& target, const std::vector<Reservation>& list, const std::string& name) {
+            Timing t(options.budgetSeconds);
+            bool truncated = false;
+            size_t attempted = 0, accepted = 0;
+            for (size_t i = 0; i < list.size(); ++i) {
+                if (list[i].getStatus() == ReservationStatus::CANCELLED) continue;
+                if (t.overBudget()) {
+                    truncated = true;
+                    break;
+                }
+                int id = list[i].getId();
+                RoomType type = hotel.requestedTypes[i];
+                bool confirmed = false;
+                t.run([&]() { confirmed = target.scheduleReservation(id, type); });
+                ++attempted;
+                if (confirmed) ++accepted;
+            }
+            BenchResult r = t.finish(scale, name, truncated);
+            r.acceptedPct = attempted ? 100.0 * static_cast<double>(accepted) / static_cast<double>(attempted) : 0.0;
+            emit(r);
+        };
+
+        // The first-fit state feeds every later step
+        std::vector<Room> rooms = hotel.rooms;
+        std::vector<Reservation> reservations = hotel.reservations;
+        std::vector<RoomBlock> blocks;
+        Scheduler scheduler(rooms, reservations, blocks);
+        bookOneByOne(scheduler, reservations, "schedule_reservation");
+        {
+            std::vector<Room> bestRooms = hotel.rooms;
+            std::vector<Reservation> bestReservations = hotel.reservations;
+            std::vector<RoomBlock> bestBlocks;
+            Scheduler bestFit(bestRooms, bestReservations, bestBlocks);
+            bestFit.setAssignmentPolicy(AssignmentPolicy::BEST_FIT);
+            bookOneByOne(bestFit, bestReservations, "schedule_best_fit");
+        }
+
+        {
+            std::vector<int> confirmed;
+            for (const auto& r : reservations) {
+                if (r.getStatus() == ReservationStatus::CONFIRMED) confirmed.push_back(r.getId());
+            }
+            std::mt19937_64 rng(options.seed);
+            for (size_t i = confirmed.size(); i > 1; --i) std::swap(confirmed[i - 1], confirmed[rng() % i]);
+            if (confirmed.size() > options.samples) confirmed.resize(options.samples);
+
+            Timing t(options.budgetSeconds);
+            bool truncated = false;
+            for (int id : confirmed) {
+                if (t.overBudget()) {
+                    truncated = true;
+                    break;
+                }
+                t.run([&]() { scheduler.removeReservation(id); });
+            }
+            emit(t.finish(scale, "remove_reservation", truncated));
+        }
+
+        int fromDay = dayIndexFromCivil(2030, 1, 1);
+        int toDay = fromDay + spec.horizonDays + 60;
+        RevenueAnalytics analytics;
+        {
+            Timing t(options.budgetSeconds);
+            for (int i = 0; i < options.reportRepeats && !t.overBudget(); ++i) {
+                t.run([&]() { scheduler.getOccupancySeries(fromDay, toDay); });
+            }
+            emit(t.finish(scale, "occupancy_series"));
+        }
+        {
+            Timing t(options.budgetSeconds);
+            for (int i = 0; i < options.reportRepeats && !t.overBudget(); ++i) {
+                t.run([&]() { analytics.compute(reservations, rooms, fromDay, toDay); });
+            }
+            emit(t.finish(scale, "revenue_scan"));
+        }
+        {
+            // The first call builds the rollup; the rest answer from it
+            Timing t(options.budgetSeconds);
+            for (int i = 0; i < options.reportRepeats && !t.overBudget(); ++i) {
+                t.run([&]() { analytics.computeCached(scheduler.getCalendar(), rooms, fromDay, toDay); });
+            }
+            emit(t.finish(scale, "revenue_cached"));
+        }
+
+        // Round trip through HotelSystem's own files
+        std::string dir = (std::filesystem::temp_directory_path() /
+                           ("hotel_bench_" + std::to_string(scale))).string();
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        hotel.rooms.swap(rooms);
+        hotel.reservations.swap(reservations);
+        if (!hotel.writeTo(dir)) {
+            std::cerr << "Failed to write the generated hotel to " << dir << "\n";
+            return;
+        }
+        hotel = SyntheticHotel();
+        {
+            std::unique_ptr<HotelSystem> system;
+            Timing load(options.budgetSeconds);
+            load.run([&]() { system = std::make_unique<HotelSystem>(dir); });
+            emit(load.finish(scale, "load_data"));
+            system->setAutoSave(false);
+
+            Timing publish(options.budgetSeconds);
+            publish.run([&]() { system->snapshot(); });
+            emit(publish.finish(scale, "snapshot_publish"));
+
+            Timing save(options.budgetSeconds);
+            save.run([&]() { system->saveData(); });
+            emit(save.finish(scale, "save_data"));
+        }
+        std::filesystem::remove_all(dir);
+    }
+
+    bool parseScales(const std::string& list, std::vector<size_t>& out) {
+        out.clear();
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            // Accepts 1e5 as well as 100000
+            char* end = nullptr;
+            double value = std::strtod(item.c_str(), &end);
+            if (end == item.c_str() || *end != '\0' || value < 1) return false;
+            out.push_back(static_cast<size_t>(value));
+        }
+        return !out.empty();
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program
+                  << " [--scales N,N,...] [--seed N] [--budget SECONDS] [--bulk-limit N]"
+                     " [--samples N] [--repeats N] [--per-room N] [--json FILE]\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--scales") == 0 && i + 1 < argc) {
+            if (!parseScales(argv[++i], options.scales)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            options.budgetSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--bulk-limit") == 0 && i + 1 < argc) {
+            options.bulkLimit = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            options.samples = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--per-room") == 0 && i + 1 < argc) {
+            options.perRoom = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            options.reportRepeats = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            options.jsonFile = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.budgetSeconds <= 0.0 || options.reportRepeats <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "\n========== HOTEL BENCHMARK ==========\n";
+    std::cout << "seed " << options.seed << ", " << options.budgetSeconds << " s budget per step\n\n";
+    std::cout << std::setw(10) << "Scale" << "  " << std::left << std::setw(22) << "Benchmark" << std::right
+              << std::setw(10) << "Ops" << std::setw(11) << "Seconds" << std::setw(13) << "Ops/s"
+              << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << "\n";
+
+    std::vector<BenchResult> results;
+    for (size_t scale : options.scales) {
+        runScale(scale, options, results);
+    }
+
+    if (!options.jsonFile.empty()) {
+        std::ofstream file(options.jsonFile);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << options.jsonFile << " for writing.\n";
+            return 1;
+        }
+        writeJson(options, results, file);
+        std::cout << "\nResults written to " << options.jsonFile << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,472 @@
+#include "HotelHistory.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+    const size_t FLUSH_BYTES = 64 * 1024;
+    const char* const SNAPSHOT_PREFIX = "snapshot_";
+
+    const char* const EVENT_NAMES[HISTORY_EVENT_COUNT] = {
+        "customer_added", "customer_modified", "customer_deleted",
+        "reservation_created", "reservation_assigned", "reservation_waitlisted", "reservation_cancelled",
+        "reservation_checked_in", "reservation_checked_out", "reservation_updated", "reservation_deleted"
+    };
+
+    bool extractJsonNumber(const std::string& json, const std::string& key, long long& out) {
+        std::string pattern = "\"" + key + "\"";
+        size_t pos = json.find(pattern);
+        if (pos == std::string::npos) return false;
+        pos = json.find(':', pos);
+        if (pos == std::string::npos) return false;
+        ++pos;
+        while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos]))) ++pos;
+        size_t end = pos;
+        while (end < json.size() && (std::isdigit(static_cast<unsigned char>(json[end])) || json[end] == '-')) {
+            ++end;
+        }
+        if (end == pos) return false;
+        try {
+            out = std::stoll(json.substr(pos, end - pos));
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    bool isCustomerEvent(HistoryEvent event) {
+        return event == HistoryEvent::CUSTOMER_ADDED || event == HistoryEvent::CUSTOMER_MODIFIED ||
+               event == HistoryEvent::CUSTOMER_DELETED;
+    }
+
+    // A torn last write fails here: a line must end in "}}" or "null}"
+    bool parseEvent(const std::string& line, uint64_t& sequence, int64_t& atMicros, HistoryEvent& event,
+                    int& key, std::string& record) {
+        unsigned long long seq = 0;
+        long long at = 0;
+        char name[32];
+        int id = 0, used = 0;
+        if (std::sscanf(line.c_str(), "{\"seq\":%llu,\"at\":%lld,\"event\":\"%31[^\"]\",\"key\":%d,\"record\":%n",
+                        &seq, &at, name, &id, &used) != 4 || used == 0) {
+            return false;
+        }
+        size_t start = static_cast<size_t>(used);
+        if (line.size() < start + 2 || line.back() != '}') return false;
+        record = line.substr(start, line.size() - start - 1);
+        if (record == "null") {
+            record.clear();
+        } else if (record.front() != '{' || record.back() != '}') {
+            return false;
+        }
+        for (int i = 0; i < HISTORY_EVENT_COUNT; ++i) {
+            if (std::strcmp(name, EVENT_NAMES[i]) == 0) {
+                sequence = seq;
+                atMicros = at;
+                event = static_cast<HistoryEvent>(i);
+                key = id;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseHeader(const std::string& line, uint64_t& sequence, int64_t& atMicros, uint64_t& logOffset,
+                     size_t& customerCount, size_t& reservationCount) {
+        unsigned long long seq = 0, offset = 0, c = 0, r = 0;
+        long long at = 0;
+        if (std::sscanf(line.c_str(), "{\"seq\":%llu,\"at\":%lld,\"logOffset\":%llu,\"customers\":%llu,\"reservations\":%llu}",
+                        &seq, &at, &offset, &c, &r) != 5) {
+            return false;
+        }
+        sequence = seq;
+        atMicros = at;
+        logOffset = offset;
+        customerCount = static_cast<size_t>(c);
+        reservationCount = static_cast<size_t>(r);
+        return true;
+    }
+
+    HistoryEvent reservationEvent(bool known, int oldStatus, int oldRoom, int status, int room) {
+        if (!known) return HistoryEvent::RESERVATION_CREATED;
+        if (status != oldStatus) {
+            switch (static_cast<ReservationStatus>(status)) {
+                case ReservationStatus::PENDING: return HistoryEvent::RESERVATION_WAITLISTED;
+                case ReservationStatus::CONFIRMED: return HistoryEvent::RESERVATION_ASSIGNED;
+                case ReservationStatus::CHECKED_IN: return HistoryEvent::RESERVATION_CHECKED_IN;
+                case ReservationStatus::CHECKED_OUT: return HistoryEvent::RESERVATION_CHECKED_OUT;
+                case ReservationStatus::CANCELLED: return HistoryEvent::RESERVATION_CANCELLED;
+            }
+        }
+        return room != oldRoom ? HistoryEvent::RESERVATION_ASSIGNED : HistoryEvent::RESERVATION_UPDATED;
+    }
+}
+
+const char* historyEventName(HistoryEvent event) {
+    int index = static_cast<int>(event);
+    return index >= 0 && index < HISTORY_EVENT_COUNT ? EVENT_NAMES[index] : "unknown";
+}
+
+HotelHistory::HotelHistory(const std::string& dir, uint64_t snapshotInterval)
+    : directory(dir), logPath(dir + "/events.log"), minInterval(std::max<uint64_t>(1, snapshotInterval)) {
+    open();
+}
+
+HotelHistory::~HotelHistory() {
+    flush();
+}
+
+void HotelHistory::open() {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.compare(0, std::strlen(SNAPSHOT_PREFIX), SNAPSHOT_PREFIX) != 0) continue;
+        std::ifstream file(entry.path());
+        std::string header;
+        SnapshotInfo info;
+        size_t c = 0, r = 0;
+        if (std::getline(file, header) && parseHeader(header, info.sequence, info.atMicros, info.logOffset, c, r)) {
+            info.path = entry.path().string();
+            snapshots.push_back(info);
+        }
+    }
+    std::sort(snapshots.begin(), snapshots.end(),
+              [](const SnapshotInfo& a, const SnapshotInfo& b) { return a.sequence < b.sequence; });
+
+    std::ios::openmode mode = std::ios::binary | std::ios::app;
+    if (snapshots.empty()) {
+        // A log without its first snapshot cannot be replayed; start over
+        mode = std::ios::binary | std::ios::trunc | std::ios::out;
+    } else {
+        // The live view: the newest snapshot and everything logged after it
+        std::map<int, std::string> reservationLines;
+        const SnapshotInfo& last = snapshots.back();
+        loadSnapshot(last, customers, reservationLines);
+        uint64_t sequence = last.sequence;
+        lastMicros = last.atMicros;
+        sinceSnapshot = replay(logPath, last.logOffset, LLONG_MAX, customers, reservationLines, sequence,
+                               lastMicros);
+        nextSequence = sequence + 1;
+        for (auto& entry : reservationLines) {
+            long long status = 0, room = -1;
+            extractJsonNumber(entry.second, "status", status);
+            extractJsonNumber(entry.second, "assignedRoomNumber", room);
+            reservations[entry.first] = {std::move(entry.second), static_cast<int>(status), static_cast<int>(room)};
+        }
+
+        // A torn last line is skipped by replay; keep new events off it
+        std::ifstream existing(logPath, std::ios::binary | std::ios::ate);
+        if (existing) {
+            logBytes = static_cast<uint64_t>(existing.tellg());
+            if (logBytes > 0) {
+                existing.seekg(-1, std::ios::end);
+                if (existing.get() != '\n') pending = "\n";
+            }
+        }
+    }
+    log.open(logPath, mode);
+}
+
+int64_t HotelHistory::stamp() {
+    int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    lastMicros = std::max(lastMicros, now);  // never backwards, so the log stays sorted by time
+    return lastMicros;
+}
+
+void HotelHistory::append(HistoryEvent event, int key, const std::string& record) {
+    std::ostringstream ss;
+    ss << "{\"seq\":" << nextSequence++ << ",\"at\":" << stamp() << ",\"event\":\"" << historyEventName(event)
+       << "\",\"key\":" << key << ",\"record\":" << (record.empty() ? "null" : record) << "}\n";
+    pending += ss.str();
+    if (pending.size() >= FLUSH_BYTES) writePending();
+
+    ++sinceSnapshot;
+    uint64_t due = std::max<uint64_t>(minInterval, (customers.size() + reservations.size()) / 4);
+    if (sinceSnapshot >= due) writeSnapshot();
+}
+
+void HotelHistory::writePending() {
+    if (pending.empty()) return;
+    log.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+    log.flush();
+    logBytes += pending.size();
+    pending.clear();
+}
+
+void HotelHistory::writeSnapshot() {
+    writePending();
+    sinceSnapshot = 0;
+
+    SnapshotInfo info;
+    info.sequence = nextSequence - 1;
+    info.atMicros = stamp();
+    info.logOffset = logBytes;
+    char name[40];
+    std::snprintf(name, sizeof(name), "%s%012llu.json", SNAPSHOT_PREFIX,
+                  static_cast<unsigned long long>(info.sequence));
+    info.path = directory + "/" + name;
+
+    std::string temp = info.path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file) return;
+        file << "{\"seq\":" << info.sequence << ",\"at\":" << info.atMicros << ",\"logOffset\":" << info.logOffset
+             << ",\"customers\":" << customers.size() << ",\"reservations\":" << reservations.size() << "}\n";
+        for (const auto& c : customers) file << c.second << "\n";
+        for (const auto& r : reservations) file << r.second.line << "\n";
+        if (!file.flush()) return;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, info.path, ec);
+    if (ec) return;
+    // Several snapshots of one sequence (repeated syncs): the newest wins
+    if (!snapshots.empty() && snapshots.back().sequence == info.sequence) {
+        snapshots.back() = info;
+    } else {
+        snapshots.push_back(info);
+    }
+}
+
+void HotelHistory::customerSaved(const Customer& customer) {
+    std::string line = customer.serialize();
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = customers.find(customer.getId());
+    if (it != customers.end() && it->second == line) return;
+    HistoryEvent event = it == customers.end() ? HistoryEvent::CUSTOMER_ADDED : HistoryEvent::CUSTOMER_MODIFIED;
+    customers[customer.getId()] = line;
+    append(event, customer.getId(), line);
+}
+
+void HotelHistory::customerDeleted(int id) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (customers.erase(id) == 0) return;
+    append(HistoryEvent::CUSTOMER_DELETED, id, "");
+}
+
+void HotelHistory::reservationSaved(const Reservation& reservation, const std::string& line) {
+    std::lock_guard<std::mutex> guard(mutex);
+    saveReservation(reservation.getId(), line, static_cast<int>(reservation.getStatus()),
+                    reservation.getAssignedRoomNumber());
+}
+
+void HotelHistory::saveReservation(int id, const std::string& line, int status, int room) {
+    auto it = reservations.find(id);
+    if (it != reservations.end() && it->second.line == line) return;
+    bool known = it != reservations.end();
+    HistoryEvent event = reservationEvent(known, known ? it->second.status : 0, known ? it->second.room : -1,
+                                          status, room);
+    reservations[id] = {line, status, room};
+    append(event, id, line);
+}
+
+void HotelHistory::sync(const std::vector<Customer>& customerTable, const std::vector<Reservation>& reservationTable) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (snapshots.empty()) {
+        customers.clear();
+        reservations.clear();
+        for (const auto& c : customerTable) customers[c.getId()] = c.serialize();
+        for (const auto& r : reservationTable) {
+            reservations[r.getId()] = {r.serialize(), static_cast<int>(r.getStatus()), r.getAssignedRoomNumber()};
+        }
+        writeSnapshot();
+        return;
+    }
+
+    std::unordered_set<int> present;
+    for (const auto& c : customerTable) {
+        present.insert(c.getId());
+        std::string line = c.serialize();
+        auto it = customers.find(c.getId());
+        if (it != customers.end() && it->second == line) continue;
+        HistoryEvent event = it == customers.end() ? HistoryEvent::CUSTOMER_ADDED : HistoryEvent::CUSTOMER_MODIFIED;
+        customers[c.getId()] = line;
+        append(event, c.getId(), line);
+    }
+    for (auto it = customers.begin(); it != customers.end();) {
+        int id = it->first;
+        ++it;
+        if (!present.count(id)) {
+            customers.erase(id);
+            append(HistoryEvent::CUSTOMER_DELETED, id, "");
+        }
+    }
+
+    present.clear();
+    for (const auto& r : reservationTable) {
+        present.insert(r.getId());
+        saveReservation(r.getId(), r.serialize(), static_cast<int>(r.getStatus()), r.getAssignedRoomNumber());
+    }
+    for (auto it = reservations.begin(); it != reservations.end();) {
+        int id = it->first;
+        ++it;
+        if (!present.count(id)) {
+            reservations.erase(id);
+            append(HistoryEvent::RESERVATION_DELETED, id, "");
+        }
+    }
+    writePending();
+}
+
+void HotelHistory::flush() {
+    std::lock_guard<std::mutex> guard(mutex);
+    writePending();
+}
+
+bool HotelHistory::loadSnapshot(const SnapshotInfo& info, std::map<int, std::string>& customers,
+                                std::map<int, std::string>& reservations) {
+    std::ifstream file(info.path, std::ios::binary);
+    std::string line;
+    uint64_t sequence = 0, offset = 0;
+    int64_t at = 0;
+    size_t customerCount = 0, reservationCount = 0;
+    if (!std::getline(file, line) || !parseHeader(line, sequence, at, offset, customerCount, reservationCount)) {
+        return false;
+    }
+    long long id = 0;
+    for (size_t i = 0; i < customerCount && std::getline(file, line); ++i) {
+        if (extractJsonNumber(line, "id", id)) customers[static_cast<int>(id)] = line;
+    }
+    for (size_t i = 0; i < reservationCount && std::getline(file, line); ++i) {
+        if (extractJsonNumber(line, "id", id)) reservations[static_cast<int>(id)] = line;
+    }
+    return true;
+}
+
+size_t HotelHistory::replay(const std::string& path, uint64_t offset, int64_t untilMicros,
+                            std::map<int, std::string>& customers, std::map<int, std::string>& reservations,
+                            uint64_t& sequence, int64_t& atMicros) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return 0;
+    file.seekg(static_cast<std::streamoff>(offset));
+
+    size_t applied = 0;
+    std::string line, record;
+    uint64_t seq = 0;
+    int64_t at = 0;
+    HistoryEvent event;
+    int key = 0;
+    while (std::getline(file, line)) {
+        if (!parseEvent(line, seq, at, event, key, record) || seq <= sequence) continue;
+        if (at > untilMicros) break;
+        std::map<int, std::string>& table = isCustomerEvent(event) ? customers : reservations;
+        if (record.empty()) {
+            table.erase(key);
+        } else {
+            table[key] = record;
+        }
+        sequence = seq;
+        atMicros = at;
+        ++applied;
+    }
+    return applied;
+}
+
+bool HotelHistory::loadSnapshotReservation(const SnapshotInfo& info, int id, std::string& line) {
+    std::ifstream file(info.path, std::ios::binary);
+    std::string text;
+    uint64_t sequence = 0, offset = 0;
+    int64_t at = 0;
+    size_t customerCount = 0, reservationCount = 0;
+    if (!std::getline(file, text) || !parseHeader(text, sequence, at, offset, customerCount, reservationCount)) {
+        return false;
+    }
+    line.clear();
+    for (size_t i = 0; i < customerCount && file.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); ++i) {}
+    // Snapshots list reservations by id
+    long long key = 0;
+    for (size_t i = 0; i < reservationCount && std::getline(file, text); ++i) {
+        if (!extractJsonNumber(text, "id", key) || key < id) continue;
+        if (key == id) line.swap(text);
+        break;
+    }
+    return true;
+}
+
+void HotelHistory::replayReservation(const std::string& path, const SnapshotInfo& base, int64_t untilMicros,
+                                     int id, std::string& line) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return;
+    file.seekg(static_cast<std::streamoff>(base.logOffset));
+
+    // Only the stamp is read from other keys' lines
+    std::string keyTag = ",\"key\":" + std::to_string(id) + ",";
+    std::string text, record;
+    unsigned long long seq = 0;
+    long long at = 0;
+    uint64_t sequence = 0;
+    int64_t atMicros = 0;
+    HistoryEvent event;
+    int key = 0;
+    while (std::getline(file, text)) {
+        if (std::sscanf(text.c_str(), "{\"seq\":%llu,\"at\":%lld", &seq, &at) != 2 || seq <= base.sequence) continue;
+        if (at > untilMicros) break;
+        if (text.find(keyTag) == std::string::npos) continue;
+        if (!parseEvent(text, sequence, atMicros, event, key, record) || key != id || isCustomerEvent(event)) continue;
+        line.swap(record);
+    }
+}
+
+bool HotelHistory::snapshotAt(int64_t untilMicros, SnapshotInfo& out) {
+    std::lock_guard<std::mutex> guard(mutex);
+    writePending();
+    auto it = std::upper_bound(snapshots.begin(), snapshots.end(), untilMicros,
+                               [](int64_t t, const SnapshotInfo& s) { return t < s.atMicros; });
+    if (it == snapshots.begin()) return false;
+    out = *(it - 1);
+    return true;
+}
+
+bool HotelHistory::reservationAt(int id, time_t when, Reservation& out) {
+    int64_t untilMicros = static_cast<int64_t>(when) * 1000000 + 999999;
+    SnapshotInfo base;
+    std::string line;
+    if (!snapshotAt(untilMicros, base) || !loadSnapshotReservation(base, id, line)) return false;
+    replayReservation(logPath, base, untilMicros, id, line);
+    if (line.empty()) return false;
+    out = Reservation::deserialize(line);
+    return true;
+}
+
+bool HotelHistory::stateAt(time_t when, HistoryState& out) {
+    int64_t untilMicros = static_cast<int64_t>(when) * 1000000 + 999999;  // through the end of that second
+    SnapshotInfo base;
+    if (!snapshotAt(untilMicros, base)) return false;
+
+    // Snapshots and logged lines never change once written, so the rebuild
+    // runs without the lock while new events keep arriving
+    std::map<int, std::string> customerLines, reservationLines;
+    if (!loadSnapshot(base, customerLines, reservationLines)) return false;
+    out.snapshotSequence = base.sequence;
+    out.sequence = base.sequence;
+    out.atMicros = base.atMicros;
+    out.eventsReplayed = replay(logPath, base.logOffset, untilMicros, customerLines, reservationLines,
+                                out.sequence, out.atMicros);
+
+    out.customers.clear();
+    out.reservations.clear();
+    out.customers.reserve(customerLines.size());
+    out.reservations.reserve(reservationLines.size());
+    for (const auto& c : customerLines) out.customers.push_back(Customer::deserialize(c.second));
+    for (const auto& r : reservationLines) out.reservations.push_back(Reservation::deserialize(r.second));
+    return true;
+}
+
+HistoryStats HotelHistory::getStats() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    HistoryStats stats;
+    stats.events = nextSequence - 1;
+    stats.snapshots = snapshots.size();
+    stats.logBytes = logBytes + pending.size();
+    stats.eventsSinceSnapshot = sinceSnapshot;
+    stats.snapshotInterval = std::max<uint64_t>(minInterval, (customers.size() + reservations.size()) / 4);
+    return stats;
+}
@@ -0,0 +1,147 @@
+#ifndef HOTEL_HISTORY_H
+#define HOTEL_HISTORY_H
+
+#include "Customer.h"
+#include "Reservation.h"
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class HistoryEvent {
+    CUSTOMER_ADDED,
+    CUSTOMER_MODIFIED,
+    CUSTOMER_DELETED,
+    RESERVATION_CREATED,
+    RESERVATION_ASSIGNED,     // confirmed into a room, or moved to another
+    RESERVATION_WAITLISTED,   // back to PENDING
+    RESERVATION_CANCELLED,
+    RESERVATION_CHECKED_IN,
+    RESERVATION_CHECKED_OUT,
+    RESERVATION_UPDATED,      // any other change
+    RESERVATION_DELETED       // gone from the tables (restore of an older backup)
+};
+
+const int HISTORY_EVENT_COUNT = 11;
+
+const char* historyEventName(HistoryEvent event);
+
+// Customers and reservations as they stood at some instant
+struct HistoryState {
+    uint64_t sequence = 0;                  // last event included
+    int64_t atMicros = 0;                   // when it was recorded
+    std::vector<Customer> customers;        // by id
+    std::vector<Reservation> reservations;  // by id
+    uint64_t snapshotSequence = 0;          // the snapshot it was rebuilt from
+    size_t eventsReplayed = 0;              // log tail applied on top of it
+};
+
+struct HistoryStats {
+    uint64_t events = 0;
+    size_t snapshots = 0;
+    uint64_t logBytes = 0;
+    uint64_t eventsSinceSnapshot = 0;
+    uint64_t snapshotInterval = 0;  // events before the next snapshot is due
+};
+
+// Append-only history of customers and reservations, kept in a directory
+// next to the data files:
+//   events.log           one JSON line per change,
+//                        {"seq":N,"at":MICROS,"event":"reservation_cancelled","key":ID,"record":{...}}
+//                        with the record as saved after the change (null once deleted)
+//   snapshot_<seq>.json  a header {"seq":N,"at":MICROS,"logOffset":BYTES,"customers":C,"reservations":R}
+//                        then the C customer and R reservation records after event N
+// The state at time T is the newest snapshot taken at or before T plus the
+// log from its offset up to T. A snapshot is due once the events since the
+// last one reach the interval or a quarter of the live records, whichever
+// is larger: a query replays a bounded tail, and writing snapshots costs a
+// few record writes per event. Rooms are not recorded; their schedules
+// follow from the reservations.
+//
+// Appends are buffered and reach the file on flush(), when the buffer
+// fills or before a snapshot. The JSON files stay the source of truth, so
+// a crash loses at most the unflushed end of the history. Thread-safe.
+class HotelHistory {
+private:
+    struct ReservationEntry {
+        std::string line;
+        int status;
+        int room;
+    };
+
+    struct SnapshotInfo {
+        uint64_t sequence;
+        int64_t atMicros;
+        uint64_t logOffset;
+        std::string path;
+    };
+
+    std::string directory;
+    std::string logPath;
+    std::ofstream log;
+    std::string pending;       // appended, not yet written
+    uint64_t logBytes = 0;     // written
+    uint64_t nextSequence = 1;
+    int64_t lastMicros = 0;
+    uint64_t sinceSnapshot = 0;
+    uint64_t minInterval;
+    std::map<int, std::string> customers;            // the log's view of the live tables
+    std::map<int, ReservationEntry> reservations;
+    std::vector<SnapshotInfo> snapshots;             // by sequence
+    mutable std::mutex mutex;
+
+    void open();
+    int64_t stamp();
+    void append(HistoryEvent event, int key, const std::string& record);
+    void saveReservation(int id, const std::string& line, int status, int room);
+    void writePending();
+    void writeSnapshot();
+
+    static bool loadSnapshot(const SnapshotInfo& info, std::map<int, std::string>& customers,
+                             std::map<int, std::string>& reservations);
+    // Applies the log from offset through the last event at or before
+    // untilMicros; returns the events applied
+    static size_t replay(const std::string& path, uint64_t offset, int64_t untilMicros,
+                         std::map<int, std::string>& customers, std::map<int, std::string>& reservations,
+                         uint64_t& sequence, int64_t& atMicros);
+    // The same for one reservation: line is its record in the snapshot
+    // (empty if absent) and is updated by that key's events only
+    static bool loadSnapshotReservation(const SnapshotInfo& info, int id, std::string& line);
+    static void replayReservation(const std::string& path, const SnapshotInfo& base, int64_t untilMicros,
+                                  int id, std::string& line);
+    // The newest snapshot taken at or before untilMicros
+    bool snapshotAt(int64_t untilMicros, SnapshotInfo& out);
+
+public:
+    explicit HotelHistory(const std::string& directory, uint64_t snapshotInterval = 1000);
+    ~HotelHistory();  // flushes
+
+    HotelHistory(const HotelHistory&) = delete;
+    HotelHistory& operator=(const HotelHistory&) = delete;
+
+    // One event when the record differs from the log's view of it; the
+    // kind follows from what changed
+    void customerSaved(const Customer& customer);
+    void customerDeleted(int id);
+    void reservationSaved(const Reservation& reservation, const std::string& line);
+
+    // Brings the log in line with these tables. On an empty history this
+    // writes the first snapshot; afterwards it appends one event per record
+    // that differs (after a load, a restore or a bulk reschedule).
+    void sync(const std::vector<Customer>& customers, const std::vector<Reservation>& reservations);
+
+    void flush();
+
+    // false when when is before the first snapshot
+    bool stateAt(time_t when, HistoryState& out);
+    // One reservation at when, without rebuilding the rest: other records
+    // are skipped unparsed. false when it did not exist then too.
+    bool reservationAt(int id, time_t when, Reservation& out);
+
+    HistoryStats getStats() const;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef HOTEL_LOCKS_H
+#define HOTEL_LOCKS_H
+
+#include "Room.h"
+#include <mutex>
+#include <shared_mutex>
+
+// Lock hierarchy for HotelSystem when it is driven by several threads.
+//
+//   table        exclusive: anything that adds or removes vector elements
+//                (new customers/reservations, deletes, loads, reschedules);
+//                shared: everything else.
+//   shards[t]    one per RoomType. Guards the rooms of that type, the
+//                reservations assigned to them, that type's calendar
+//                series and its waitlist. Bookings of different types run
+//                in parallel.
+//
+// An unassigned (PENDING/CANCELLED) reservation belongs to no room, so it
+// is guarded by all shards together. Two writers get by with just one
+// shard: a booking placing its own new reservation, and a release promoting
+// waitlisted reservations of its type into the freed room. That is enough
+// because every other access to an unassigned reservation needs all shards.
+// Locks are always taken table first, then shards in ascending order, which
+// rules out deadlock.
+struct HotelLocks {
+    std::shared_mutex table;
+    std::shared_mutex shards[ROOM_TYPE_COUNT];
+};
+
+const unsigned ALL_SHARDS = (1u << ROOM_TYPE_COUNT) - 1;
+
+inline unsigned shardBit(RoomType type) {
+    return 1u << static_cast<int>(type);
+}
+
+// Whole-table exclusive access
+class TableWriteLock {
+private:
+    HotelLocks& locks;
+
+public:
+    explicit TableWriteLock(HotelLocks& l) : locks(l) { locks.table.lock(); }
+    ~TableWriteLock() { locks.table.unlock(); }
+    TableWriteLock(const TableWriteLock&) = delete;
+    TableWriteLock& operator=(const TableWriteLock&) = delete;
+};
+
+// Shared table lock plus the shards in mask, exclusive or shared.
+// lock()/unlock() allow re-acquiring a wider set after a retry.
+class ShardLock {
+private:
+    HotelLocks& locks;
+    unsigned held = 0;
+    bool exclusive;
+
+public:
+    ShardLock(HotelLocks& l, unsigned mask, bool exclusiveAccess = true)
+        : locks(l), exclusive(exclusiveAccess) {
+        lock(mask);
+    }
+    ShardLock(HotelLocks& l, std::defer_lock_t, bool exclusiveAccess = true)
+        : locks(l), exclusive(exclusiveAccess) {}
+    ~ShardLock() { unlock(); }
+    ShardLock(const ShardLock&) = delete;
+    ShardLock& operator=(const ShardLock&) = delete;
+
+    void lock(unsigned mask) {
+        if (held) return;
+        locks.table.lock_shared();
+        for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+            if (!(mask & (1u << t))) continue;
+            if (exclusive) locks.shards[t].lock();
+            else locks.shards[t].lock_shared();
+        }
+        held = mask | (1u << ROOM_TYPE_COUNT);  // marker bit: table is held
+    }
+
+    void unlock() {
+        if (!held) return;
+        for (int t = ROOM_TYPE_COUNT - 1; t >= 0; --t) {
+            if (!(held & (1u << t))) continue;
+            if (exclusive) locks.shards[t].unlock();
+            else locks.shards[t].unlock_shared();
+        }
+        locks.table.unlock_shared();
+        held = 0;
+    }
+
+    unsigned mask() const { return held & ALL_SHARDS; }
+};
+
+// Consistent read of everything: lookups, reports and saves
+class ReadLock : public ShardLock {
+public:
+    explicit ReadLock(HotelLocks& l) : ShardLock(l, ALL_SHARDS, false) {}
+};
+
+// Customers and the table shape only
+class TableReadLock : public ShardLock {
+public:
+    explicit TableReadLock(HotelLocks& l) : ShardLock(l, 0, false) {}
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "HotelSnapshot.h"
+#include <algorithm>
+
+std::unordered_map<int, size_t> HotelSnapshot::indexById() const {
+    std::unordered_map<int, size_t> index;
+    index.reserve(reservationCount);
+    for (size_t i = 0; i < reservationCount; ++i) {
+        index[reservationAt(i).getId()] = i;
+    }
+    return index;
+}
+
+SnapshotStore::SnapshotStore() : published(std::make_shared<HotelSnapshot>()) {}
+
+void SnapshotStore::markReservation(size_t index) {
+    std::lock_guard<std::mutex> lock(markMutex);
+    dirtyReservations.push_back(index);
+    dirty.store(true, std::memory_order_release);
+}
+
+void SnapshotStore::markRoom(size_t index) {
+    std::lock_guard<std::mutex> lock(markMutex);
+    dirtyRooms.push_back(index);
+    dirty.store(true, std::memory_order_release);
+}
+
+void SnapshotStore::markAll() {
+    std::lock_guard<std::mutex> lock(markMutex);
+    allDirty = true;
+    dirtyReservations.clear();
+    dirtyRooms.clear();
+    dirty.store(true, std::memory_order_release);
+}
+
+void SnapshotStore::publish(const std::vector<Reservation>& reservations, const std::vector<Room>& rooms) {
+    std::lock_guard<std::mutex> publishing(publishMutex);
+
+    std::vector<size_t> changedReservations, changedRooms;
+    bool rebuildAll;
+    {
+        std::lock_guard<std::mutex> lock(markMutex);
+        if (!dirty.load(std::memory_order_relaxed)) return;  // another reader published first
+        changedReservations.swap(dirtyReservations);
+        changedRooms.swap(dirtyRooms);
+        rebuildAll = allDirty;
+        allDirty = false;
+        dirty.store(false, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<const HotelSnapshot> previous = current();
+    auto next = std::make_shared<HotelSnapshot>();
+    next->version = previous->version + 1;
+    next->reservationCount = reservations.size();
+
+    size_t chunkCount = (reservations.size() + HotelSnapshot::CHUNK_SIZE - 1) / HotelSnapshot::CHUNK_SIZE;
+    auto copyChunk = [&](size_t c) {
+        size_t begin = c * HotelSnapshot::CHUNK_SIZE;
+        size_t end = std::min(reservations.size(), begin + HotelSnapshot::CHUNK_SIZE);
+        return std::make_shared<const HotelSnapshot::Chunk>(reservations.begin() + begin,
+                                                           reservations.begin() + end);
+    };
+
+    if (rebuildAll || rooms.size() != previous->rooms.size()) {
+        next->chunks.reserve(chunkCount);
+        for (size_t c = 0; c < chunkCount; ++c) next->chunks.push_back(copyChunk(c));
+        next->rooms.reserve(rooms.size());
+        for (const auto& room : rooms) next->rooms.push_back(std::make_shared<const Room>(room));
+    } else {
+        // Share every untouched chunk and room with the previous version
+        next->chunks = previous->chunks;
+        next->chunks.resize(chunkCount);
+        std::vector<bool> copied(chunkCount, false);
+        for (size_t i = previous->reservationCount; i < reservations.size(); ++i) {
+            changedReservations.push_back(i);  // appended since the last version
+        }
+        for (size_t index : changedReservations) {
+            size_t c = index / HotelSnapshot::CHUNK_SIZE;
+            if (c >= chunkCount || copied[c]) continue;
+            next->chunks[c] = copyChunk(c);
+            copied[c] = true;
+        }
+
+        next->rooms = previous->rooms;
+        for (size_t index : changedRooms) {
+            if (index < rooms.size()) next->rooms[index] = std::make_shared<const Room>(rooms[index]);
+        }
+    }
+
+    std::atomic_store(&published, std::shared_ptr<const HotelSnapshot>(std::move(next)));
+}
+
+std::shared_ptr<const HotelSnapshot> SnapshotStore::current() const {
+    return std::atomic_load(&published);
+}
@@ -0,0 +1,81 @@
+#ifndef HOTEL_SNAPSHOT_H
+#define HOTEL_SNAPSHOT_H
+
+#include "Reservation.h"
+#include "Room.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Immutable version of the reservation and room tables. Reservations are
+// stored in fixed-size chunks and rooms individually, all behind
+// shared_ptr, so a new version copies only the chunks and rooms that
+// changed and shares the rest with its predecessor. A reader that holds a
+// snapshot keeps exactly that version alive; it is freed with the last
+// reference.
+class HotelSnapshot {
+public:
+    static const size_t CHUNK_SIZE = 256;
+    typedef std::vector<Reservation> Chunk;
+
+private:
+    friend class SnapshotStore;
+
+    uint64_t version = 0;
+    size_t reservationCount = 0;
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    std::vector<std::shared_ptr<const Room>> rooms;
+
+public:
+    uint64_t getVersion() const { return version; }
+
+    size_t getReservationCount() const { return reservationCount; }
+    const Reservation& reservationAt(size_t index) const {
+        return (*chunks[index / CHUNK_SIZE])[index % CHUNK_SIZE];
+    }
+
+    size_t getRoomCount() const { return rooms.size(); }
+    const Room& roomAt(size_t index) const { return *rooms[index]; }
+
+    // Reservation id -> index, built per call for reports that join rooms
+    // to their reservations
+    std::unordered_map<int, size_t> indexById() const;
+};
+
+// Publishes HotelSnapshot versions of HotelSystem's live vectors. Writers
+// mark the elements they changed while still holding their shard lock;
+// publish() runs under a read lock of the whole hotel (no writer can be
+// mid-change), folds every pending mark into a new version and swaps it in
+// atomically. Publishing is lazy: nothing is copied until a reader asks.
+class SnapshotStore {
+private:
+    std::shared_ptr<const HotelSnapshot> published;
+
+    std::mutex markMutex;
+    std::vector<size_t> dirtyReservations;
+    std::vector<size_t> dirtyRooms;
+    bool allDirty = true;
+    std::atomic<bool> dirty{true};
+
+    std::mutex publishMutex;
+
+public:
+    SnapshotStore();
+
+    void markReservation(size_t index);
+    void markRoom(size_t index);
+    // After loads, restores and bulk reschedules
+    void markAll();
+
+    bool isDirty() const { return dirty.load(std::memory_order_acquire); }
+
+    // Caller must hold a consistent read lock on both vectors
+    void publish(const std::vector<Reservation>& reservations, const std::vector<Room>& rooms);
+
+    std::shared_ptr<const HotelSnapshot> current() const;
+};
+
+#endif
@@ -1,4 +1,7 @@
 #include "HotelSystem.h"
+#include "DateUtils.h"
+#include "Metrics.h"
+#include "ReportBuffer.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -8,12 +11,28 @@
 #include <ctime>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <unordered_set>
 
 HotelSystem::HotelSystem() {
     initialize();
 }
 
+HotelSystem::HotelSystem(const std::string& dataDirectory) : dataDir(dataDirectory) {
+    customersFile = dataPath("customers.json");
+    reservationsFile = dataPath("reservations.json");
+    roomsFile = dataPath("rooms.json");
+    ratesFile = dataPath("rates.json");
+    blocksFile = dataPath("blocks.json");
+    initialize();
+}
+
+std::string HotelSystem::dataPath(const std::string& fileName) const {
+    return dataDir.empty() ? fileName : dataDir + "/" + fileName;
+}
+
 HotelSystem::~HotelSystem() {
+    // Drains the write queue; the writer thread exits with `persistence`
     saveData();
 }
 static bool isDigitsOnly(const std::string& s) {
@@ -24,6 +43,15 @@ static bool isDigitsOnly(const std::string& s) {
     return true;
 }
 
+// Between pages of a listing: Enter shows the next page, anything else
+// stops. The answer is left unread, for the menu's "Press Enter" prompt
+// (or the next page's) to consume.
+static bool morePages() {
+    std::cout << " Enter for more, q to stop: ";
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    return std::cin.peek() == '\n';
+}
+
 static bool isValidName(const std::string& name) {
     if (name.empty()) return false;
 
@@ -77,28 +105,104 @@ static bool isValidPhone(const std::string& phone) {
 
 void HotelSystem::initialize() {
     if (rooms.empty()) {
-        rooms.push_back(Room(101, RoomType::SINGLE, 100.0));
-        rooms.push_back(Room(102, RoomType::SINGLE, 100.0));
-        rooms.push_back(Room(201, RoomType::DOUBLE, 150.0));
-        rooms.push_back(Room(202, RoomType::DOUBLE, 150.0));
-        rooms.push_back(Room(301, RoomType::SUITE, 250.0));
-        rooms.push_back(Room(302, RoomType::DELUXE, 350.0));
+        rooms.push_back(Room(101, RoomType::SINGLE, Money::fromCents(10000)));
+        rooms.push_back(Room(102, RoomType::SINGLE, Money::fromCents(10000)));
+        rooms.push_back(Room(201, RoomType::DOUBLE, Money::fromCents(15000)));
+        rooms.push_back(Room(202, RoomType::DOUBLE, Money::fromCents(15000)));
+        rooms.push_back(Room(301, RoomType::SUITE, Money::fromCents(25000)));
+        rooms.push_back(Room(302, RoomType::DELUXE, Money::fromCents(35000)));
     }
     
+    if (!persistence) {
+        const std::string paths[DATA_FILE_COUNT] = {customersFile, reservationsFile, roomsFile, ratesFile,
+                                                     blocksFile};
+        persistence = std::make_unique<PersistenceService>(paths);
+    }
+    if (!history) history = std::make_unique<HotelHistory>(dataPath("history"));
     loadData();
-    scheduler = std::make_unique<Scheduler>(rooms, reservations);
+    adoptLoadedData();
+    // Edits made to the files while the hotel was closed become events
+    history->sync(customers, reservations);
+    frontDesk.rebuild(reservations);
+    snapshots.markAll();
+    scheduler = std::make_unique<Scheduler>(rooms, reservations, blocks);
+    scheduler->setRateCalendar(&rateCalendar);
 }
 
 void HotelSystem::loadData() {
+    HOTEL_TIME_SCOPE(Timer::LOAD_DATA);
     loadCustomers();
     loadReservations();
     loadRooms();
+    loadRates();
+    loadBlocks();
+}
+
+bool HotelSystem::saveData() {
+    {
+        ReadLock read(locks);
+        saveCustomers();
+        saveReservations();
+        saveRooms();
+        saveRates();
+        saveBlocks();
+    }
+    bool saved = persistence->flush();
+    history->flush();
+    return saved;
+}
+
+void HotelSystem::setAssignmentPolicy(AssignmentPolicy policy) {
+    TableWriteLock write(locks);
+    scheduler->setAssignmentPolicy(policy);
 }
 
-void HotelSystem::saveData() {
-    saveCustomers();
-    saveReservations();
-    saveRooms();
+PersistenceStats HotelSystem::getPersistenceStats() const {
+    return persistence->getStats();
+}
+
+// Serialized records keyed the way PersistenceService tracks them
+static std::vector<std::pair<int, std::string>> customerRecords(const std::vector<Customer>& customers) {
+    std::vector<std::pair<int, std::string>> records;
+    records.reserve(customers.size());
+    for (const auto& c : customers) records.emplace_back(c.getId(), c.serialize());
+    return records;
+}
+
+static std::vector<std::pair<int, std::string>> reservationRecords(const std::vector<Reservation>& reservations) {
+    std::vector<std::pair<int, std::string>> records;
+    records.reserve(reservations.size());
+    for (const auto& r : reservations) records.emplace_back(r.getId(), r.serialize());
+    return records;
+}
+
+static std::vector<std::pair<int, std::string>> roomRecords(const std::vector<Room>& rooms) {
+    std::vector<std::pair<int, std::string>> records;
+    records.reserve(rooms.size());
+    for (const auto& r : rooms) records.emplace_back(r.getRoomNumber(), r.serialize());
+    return records;
+}
+
+static std::vector<std::pair<int, std::string>> rateRecords(const std::vector<RateRule>& rules) {
+    std::vector<std::pair<int, std::string>> records;
+    records.reserve(rules.size());
+    for (size_t i = 0; i < rules.size(); ++i) records.emplace_back(static_cast<int>(i), rules[i].serialize());
+    return records;
+}
+
+static std::vector<std::pair<int, std::string>> blockRecords(const std::vector<RoomBlock>& blocks) {
+    std::vector<std::pair<int, std::string>> records;
+    records.reserve(blocks.size());
+    for (const auto& b : blocks) records.emplace_back(b.id, b.serialize());
+    return records;
+}
+
+void HotelSystem::adoptLoadedData() {
+    persistence->adopt(DataFile::CUSTOMERS, customerRecords(customers));
+    persistence->adopt(DataFile::RESERVATIONS, reservationRecords(reservations));
+    persistence->adopt(DataFile::ROOMS, roomRecords(rooms));
+    persistence->adopt(DataFile::RATES, rateRecords(rateCalendar.getRules()));
+    persistence->adopt(DataFile::BLOCKS, blockRecords(blocks));
 }
 
 void HotelSystem::loadCustomers() {
@@ -156,40 +260,60 @@ void HotelSystem::loadRooms() {
     file.close();
 }
 
-void HotelSystem::saveCustomers() {
-    std::ofstream file(customersFile);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open " << customersFile << " for writing.\n";
-        return;
-    }
-    for (const auto& c : customers) {
-        file << c.serialize() << "\n";
+void HotelSystem::loadRates() {
+    std::ifstream file(ratesFile);
+    if (!file.is_open()) return;
+
+    std::vector<RateRule> rules;
+    std::string line;
+    while (std::getline(file, line)) {
+        RateRule rule;
+        if (!line.empty() && RateRule::deserialize(line, rule)) {
+            rules.push_back(rule);
+        }
     }
+    rateCalendar.setRules(rules);
     file.close();
 }
 
-void HotelSystem::saveReservations() {
-    std::ofstream file(reservationsFile);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open " << reservationsFile << " for writing.\n";
-        return;
-    }
-    for (const auto& r : reservations) {
-        file << r.serialize() << "\n";
+void HotelSystem::loadBlocks() {
+    std::ifstream file(blocksFile);
+    if (!file.is_open()) return;
+
+    blocks.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        RoomBlock block;
+        if (!line.empty() && RoomBlock::deserialize(line, block)) {
+            blocks.push_back(block);
+        }
     }
     file.close();
 }
 
+void HotelSystem::saveCustomers() {
+    HOTEL_TIME_SCOPE(Timer::SAVE_CUSTOMERS);
+    persistence->replace(DataFile::CUSTOMERS, customerRecords(customers));
+}
+
+void HotelSystem::saveReservations() {
+    HOTEL_TIME_SCOPE(Timer::SAVE_RESERVATIONS);
+    persistence->replace(DataFile::RESERVATIONS, reservationRecords(reservations));
+}
+
 void HotelSystem::saveRooms() {
-    std::ofstream file(roomsFile);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open " << roomsFile << " for writing.\n";
-        return;
-    }
-    for (const auto& r : rooms) {
-        file << r.serialize() << "\n";
-    }
-    file.close();
+    HOTEL_TIME_SCOPE(Timer::SAVE_ROOMS);
+    persistence->replace(DataFile::ROOMS, roomRecords(rooms));
+}
+
+void HotelSystem::saveRates() {
+    HOTEL_TIME_SCOPE(Timer::SAVE_RATES);
+    persistence->replace(DataFile::RATES, rateRecords(rateCalendar.getRules()));
+}
+
+void HotelSystem::saveBlocks() {
+    HOTEL_TIME_SCOPE(Timer::SAVE_BLOCKS);
+    persistence->replace(DataFile::BLOCKS, blockRecords(blocks));
 }
 
 Customer* HotelSystem::findCustomer(int id) {
@@ -213,6 +337,79 @@ Room* HotelSystem::findRoom(int roomNumber) {
     return nullptr;
 }
 
+unsigned HotelSystem::shardMaskFor(const Reservation& r) const {
+    for (const auto& room : rooms) {
+        if (room.getRoomNumber() == r.getAssignedRoomNumber()) return shardBit(room.getType());
+    }
+    return ALL_SHARDS;
+}
+
+void HotelSystem::markChanged(const Reservation* r, int roomNumber) {
+    if (r) {
+        size_t position = static_cast<size_t>(r - reservations.data());
+        snapshots.markReservation(position);
+        frontDesk.update(position, *r);
+        std::string line = r->serialize();
+        history->reservationSaved(*r, line);
+        if (autoSave) persistence->upsert(DataFile::RESERVATIONS, r->getId(), std::move(line));
+    }
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        if (rooms[i].getRoomNumber() == roomNumber) {
+            snapshots.markRoom(i);
+            if (autoSave) persistence->upsert(DataFile::ROOMS, roomNumber, rooms[i].serialize());
+            break;
+        }
+    }
+}
+
+void HotelSystem::markPromoted(const std::vector<size_t>& promoted) {
+    for (size_t index : promoted) {
+        markChanged(&reservations[index], reservations[index].getAssignedRoomNumber());
+    }
+}
+
+HotelFork HotelSystem::fork() const {
+    HotelFork state;
+    // One read lock for everything so the tables match the blocks and rates
+    ReadLock read(locks);
+    if (snapshots.isDirty()) snapshots.publish(reservations, rooms);
+    state.tables = snapshots.current();
+    state.blocks = blocks;
+    state.rateRules = rateCalendar.getRules();
+    state.policy = scheduler->getAssignmentPolicy();
+    return state;
+}
+
+std::shared_ptr<const HotelSnapshot> HotelSystem::snapshot() const {
+    // Only the publish needs the read lock; it copies the changed chunks
+    if (snapshots.isDirty()) {
+        ReadLock read(locks);
+        snapshots.publish(reservations, rooms);
+    }
+    return snapshots.current();
+}
+
+Reservation* HotelSystem::lockReservation(int id, ShardLock& guard) {
+    unsigned mask;
+    {
+        ReadLock read(locks);
+        Reservation* r = findReservation(id);
+        if (!r) return nullptr;
+        mask = shardMaskFor(*r);
+    }
+    // The reservation may change rooms between the peek and the lock, so
+    // widen the set until the shards held cover where it actually is
+    while (true) {
+        guard.lock(mask);
+        Reservation* r = findReservation(id);
+        if (!r) return nullptr;
+        unsigned needed = shardMaskFor(*r);
+        if ((needed & ~mask) == 0) return r;
+        guard.unlock();
+        mask |= needed;
+    }
+}
+
 time_t HotelSystem::createDateTime(int year, int month, int day, int hour, int minute) {
     struct tm timeinfo = {};
     timeinfo.tm_year = year - 1900;
@@ -240,6 +437,8 @@ void HotelSystem::displayMenu() {
     std::cout << "11. View Room Schedule\n";
     std::cout << "12. View Complete Schedule\n";
     std::cout << "13. Admin Login\n";
+    std::cout << "14. Today's Arrivals & Departures\n";
+    std::cout << "15. Search Reservations\n";
     std::cout << "0.  Exit\n";
     std::cout << "====================================================\n";
     std::cout << "Enter choice: ";
@@ -251,7 +450,17 @@ void HotelSystem::displayAdminMenu() {
     std::cout << "2. Create Backup\n";
     std::cout << "3. Restore Backup\n";
     std::cout << "4. Reschedule All Reservations\n";
-    std::cout << "5. Logout\n";
+    std::cout << "5. Occupancy Time Series\n";
+    std::cout << "6. Revenue Report\n";
+    std::cout << "7. Manage Rate Calendar\n";
+    std::cout << "8. Batch Invoices\n";
+    std::cout << "9. Persistence Stats\n";
+    std::cout << "10. Performance Metrics\n";
+    std::cout << "11. Room Blocks\n";
+    std::cout << "12. Make Room for Pending Reservation\n";
+    std::cout << "13. What-If Simulation\n";
+    std::cout << "14. Time Travel\n";
+    std::cout << "0.  Logout\n";
     std::cout << "================================\n";
     std::cout << "Enter choice: ";
 }
@@ -299,24 +508,29 @@ void HotelSystem::addCustomer() {
         break;
     }
 
-    Customer c(name, email, phone);
-    customers.push_back(c);
-
-    std::cout << "\nCustomer added successfully! ID: " << c.getId() << "\n";
-    saveCustomers();
+    OperationResult result = addCustomer(name, email, phone);
+    std::cout << "\nCustomer added successfully! ID: " << result.id << "\n";
 }
 
 void HotelSystem::viewCustomers() {
+    const size_t pageSize = 20;
     std::cout << "\n========== ALL CUSTOMERS ==========\n";
     if (customers.empty()) {
         std::cout << "No customers found.\n";
         return;
     }
     
-    for (const auto& c : customers) {
-        std::cout << "---\n";
-        c.display();
+    ReportBuffer out(std::cout);
+    for (size_t i = 0; i < customers.size(); ++i) {
+        out << "---\n";
+        customers[i].render(out);
+        if ((i + 1) % pageSize == 0 && i + 1 < customers.size()) {
+            out << "-- " << i + 1 << " of " << customers.size() << " --";
+            out.flush();
+            if (!morePages()) return;
+        }
     }
+    out << "-- " << customers.size() << " of " << customers.size() << " --\n";
 }
 
 void HotelSystem::modifyCustomer() {
@@ -341,36 +555,27 @@ void HotelSystem::modifyCustomer() {
 
     std::cout << "New Name (current: " << c->getName() << ", leave empty to keep): ";
     std::getline(std::cin, name);
-    if (!name.empty()) {
-        if (!isValidName(name)) {
-            std::cout << "Invalid name. Keeping old name.\n";
-        } else {
-            c->setName(name);
-        }
+    if (!name.empty() && !isValidName(name)) {
+        std::cout << "Invalid name. Keeping old name.\n";
+        name.clear();
     }
 
     std::cout << "New Email (current: " << c->getEmail() << ", leave empty to keep): ";
     std::getline(std::cin, email);
-    if (!email.empty()) {
-        if (!isValidEmail(email)) {
-            std::cout << "Invalid email. Keeping old email.\n";
-        } else {
-            c->setEmail(email);
-        }
+    if (!email.empty() && !isValidEmail(email)) {
+        std::cout << "Invalid email. Keeping old email.\n";
+        email.clear();
     }
 
     std::cout << "New Phone (current: " << c->getPhone() << ", leave empty to keep): ";
     std::getline(std::cin, phone);
-    if (!phone.empty()) {
-        if (!isValidPhone(phone)) {
-            std::cout << "Invalid phone. Keeping old phone.\n";
-        } else {
-            c->setPhone(phone);
-        }
+    if (!phone.empty() && !isValidPhone(phone)) {
+        std::cout << "Invalid phone. Keeping old phone.\n";
+        phone.clear();
     }
 
+    modifyCustomer(id, name, email, phone);
     std::cout << "Customer updated successfully.\n";
-    saveCustomers();
 }
 
 void HotelSystem::deleteCustomer() {
@@ -384,15 +589,11 @@ void HotelSystem::deleteCustomer() {
         return;
     }
     
-    auto it = std::find_if(customers.begin(), customers.end(),
-                          [id](const Customer& c) { return c.getId() == id; });
-    
-    if (it != customers.end()) {
-        customers.erase(it);
+    OperationResult result = deleteCustomer(id);
+    if (result.ok()) {
         std::cout << "Customer deleted successfully.\n";
-        saveCustomers();
     } else {
-        std::cout << "Customer not found.\n";
+        std::cout << result.message << "\n";
     }
 }
 static std::string roomTypeToString(RoomType t) {
@@ -421,204 +622,938 @@ bool isValidDate(int year, int month, int day, int hour) {
     return true;
 }
 
-void HotelSystem::createReservation() {
-    int customerId;
-    std::cout << "\n=== Create New Reservation ===\n";
-    std::cout << "Customer ID: ";
+// ---------- Non-interactive API ----------
+// Each operation validates its parameters, applies the change through the
+// same Scheduler path as the menu, and when autoSave is on enqueues the
+// changed records for the background writer before returning.
+
+namespace {
+    // Times one API call and appends it to the session trace, if one is
+    // open; with no trace it costs a null check
+    class TracedCall {
+    private:
+        TraceWriter* writer;
+        TraceRecord record;
+        std::chrono::steady_clock::time_point start;
+        const OperationResult* result = nullptr;
+
+    public:
+        TracedCall(TraceWriter* w, TraceOp op, const OperationResult* tracked = nullptr)
+            : writer(w), result(tracked) {
+            if (!writer) return;
+            record.op = op;
+            record.offsetMicros = writer->elapsedMicros();
+            start = std::chrono::steady_clock::now();
+        }
 
-    if (!(std::cin >> customerId)) {
-        std::cout << "Invalid input for Customer ID.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        return;
-    }
+        ~TracedCall() {
+            if (!writer) return;
+            record.latencyNanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+            if (result) setOutcome(result->code, result->id);
+            writer->append(record);
+        }
 
-    if (!findCustomer(customerId)) {
-        std::cout << "Customer not found.\n";
-        return;
-    }
+        TracedCall(const TracedCall&) = delete;
+        TracedCall& operator=(const TracedCall&) = delete;
 
-    // -------- NEW: choose room type ----------
-    int typeChoice;
-    RoomType desiredType;
+        void withId(int id) {
+            if (writer) record.id = id;
+        }
 
-    while (true) {
-        std::cout << "Room Type (1. Single, 2. Double, 3. Suite, 4. Deluxe): ";
-        if (!(std::cin >> typeChoice)) {
-            std::cout << "Invalid input. Please enter a number.\n";
-            std::cin.clear();
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            return;
+        void withCustomer(const std::string& name, const std::string& email, const std::string& phone) {
+            if (!writer) return;
+            record.name = name;
+            record.email = email;
+            record.phone = phone;
         }
 
-        if (typeChoice == 1) { desiredType = RoomType::SINGLE; break; }
-        if (typeChoice == 2) { desiredType = RoomType::DOUBLE; break; }
-        if (typeChoice == 3) { desiredType = RoomType::SUITE; break; }
-        if (typeChoice == 4) { desiredType = RoomType::DELUXE; break; }
+        void withStay(RoomType type, time_t checkIn, time_t checkOut) {
+            if (!writer) return;
+            record.type = type;
+            record.checkIn = checkIn;
+            record.checkOut = checkOut;
+        }
 
-        std::cout << "Invalid choice. Please select 1–4.\n";
-    }
+        void withGroup(const std::vector<RoomType>& types, time_t checkIn, time_t checkOut) {
+            if (!writer) return;
+            for (RoomType type : types) record.values.push_back(static_cast<int>(type));
+            record.checkIn = checkIn;
+            record.checkOut = checkOut;
+        }
 
-    // Check if hotel actually HAS that room type
-    bool hasType = false;
-    for (const auto& room : rooms) {
-        if (room.getType() == desiredType) {
-            hasType = true;
-            break;
+        void withCreated(int id) {
+            if (writer) record.createdIds.push_back(id);
+        }
+
+        void withBlock(const std::vector<int>& roomNumbers, int fromDay, int toDay, const std::string& reason) {
+            if (!writer) return;
+            record.values = roomNumbers;
+            record.fromDay = fromDay;
+            record.toDay = toDay;
+            record.name = reason;
+        }
+
+        void setOutcome(ResultCode code, int64_t value) {
+            record.code = static_cast<uint8_t>(code);
+            record.resultId = value;
         }
+    };
+}
+
+bool HotelSystem::startRecording(const std::string& path) {
+    auto writer = std::make_unique<TraceWriter>();
+    if (!writer->open(path)) return false;
+    trace = std::move(writer);
+    return true;
+}
+
+void HotelSystem::stopRecording() {
+    trace.reset();
+}
+
+OperationResult HotelSystem::addCustomer(const std::string& name, const std::string& email,
+                                         const std::string& phone) {
+    OperationResult result;
+    TracedCall call(trace.get(), TraceOp::ADD_CUSTOMER, &result);
+    call.withCustomer(name, email, phone);
+    if (!isValidName(name)) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Invalid name. Name cannot be empty or digits-only and must contain letters.";
+        return result;
+    }
+    if (!isValidEmail(email)) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Invalid email format. Example: user@example.com";
+        return result;
+    }
+    if (!isValidPhone(phone)) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Invalid phone number. Use digits only and make sure the length is bigger than 7!.";
+        return result;
     }
 
-    if (!hasType) {
-        std::cout << "Sorry, there are no rooms of this type.\n";
-        return;
+    // The id comes from the lock-free allocator; only the append is exclusive
+    Customer customer(name, email, phone);
+    result.id = customer.getId();
+    {
+        TableWriteLock write(locks);
+        customers.push_back(customer);
+        history->customerSaved(customer);
+        if (autoSave) persistence->upsert(DataFile::CUSTOMERS, customer.getId(), customer.serialize());
     }
-    // -----------------------------------------
+    result.message = "Customer added successfully!";
+    return result;
+}
 
-    int year, month, day, checkInHour;
-    int checkOutYear, checkOutMonth, checkOutDay, checkOutHour;
+OperationResult HotelSystem::modifyCustomer(int id, const std::string& name, const std::string& email,
+                                            const std::string& phone) {
+    OperationResult result;
+    result.id = id;
+    TracedCall call(trace.get(), TraceOp::MODIFY_CUSTOMER, &result);
+    call.withId(id);
+    call.withCustomer(name, email, phone);
+    if ((!name.empty() && !isValidName(name)) ||
+        (!email.empty() && !isValidEmail(email)) ||
+        (!phone.empty() && !isValidPhone(phone))) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Invalid customer details.";
+        return result;
+    }
 
-    std::cout << "Check-in Date (YYYY MM DD HH): ";
-    if (!(std::cin >> year >> month >> day >> checkInHour)) {
-        std::cout << "Invalid input for check-in date/time.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        return;
+    {
+        TableWriteLock write(locks);
+        Customer* c = findCustomer(id);
+        if (!c) {
+            result.code = ResultCode::NOT_FOUND;
+            result.message = "Customer not found.";
+            return result;
+        }
+        if (!name.empty()) c->setName(name);
+        if (!email.empty()) c->setEmail(email);
+        if (!phone.empty()) c->setPhone(phone);
+        history->customerSaved(*c);
+        if (autoSave) persistence->upsert(DataFile::CUSTOMERS, id, c->serialize());
     }
+    result.message = "Customer updated successfully.";
+    return result;
+}
 
-    std::cout << "Check-out Date (YYYY MM DD HH): ";
-    if (!(std::cin >> checkOutYear >> checkOutMonth >> checkOutDay >> checkOutHour)) {
-        std::cout << "Invalid input for check-out date/time.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        return;
+OperationResult HotelSystem::deleteCustomer(int id) {
+    OperationResult result;
+    result.id = id;
+    TracedCall call(trace.get(), TraceOp::DELETE_CUSTOMER, &result);
+    call.withId(id);
+    {
+        TableWriteLock write(locks);
+        auto it = std::find_if(customers.begin(), customers.end(),
+                              [id](const Customer& c) { return c.getId() == id; });
+        if (it == customers.end()) {
+            result.code = ResultCode::NOT_FOUND;
+            result.message = "Customer not found.";
+            return result;
+        }
+        customers.erase(it);
+        history->customerDeleted(id);
+        if (autoSave) persistence->erase(DataFile::CUSTOMERS, id);
     }
+    result.message = "Customer deleted successfully.";
+    return result;
+}
 
-    if (!isValidDate(year, month, day, checkInHour)) {
-    std::cout << "Invalid check-in date. Please enter a valid date.\n";
-    return;
+OperationResult HotelSystem::createReservation(int customerId, RoomType type,
+                                               time_t checkIn, time_t checkOut) {
+    OperationResult result;
+    TracedCall call(trace.get(), TraceOp::CREATE_RESERVATION, &result);
+    call.withId(customerId);
+    call.withStay(type, checkIn, checkOut);
+    bool customerExists = false;
+    bool hasType = false;
+    {
+        TableReadLock read(locks);
+        customerExists = findCustomer(customerId) != nullptr;
+        for (const auto& room : rooms) {
+            if (room.getType() == type) {
+                hasType = true;
+                break;
+            }
+        }
     }
-    if (!isValidDate(checkOutYear, checkOutMonth, checkOutDay, checkOutHour)) {
-    std::cout << "Invalid check-out date. Please enter a valid date.\n";
-    return;
+    if (!customerExists) {
+        result.code = ResultCode::NOT_FOUND;
+        result.message = "Customer not found.";
+        return result;
+    }
+    if (!hasType) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Sorry, there are no rooms of this type.";
+        return result;
     }
 
-    time_t checkIn = createDateTime(year, month, day, checkInHour, 0);
-    time_t checkOut = createDateTime(checkOutYear, checkOutMonth, checkOutDay, checkOutHour, 0);
-
-    time_t now = time(nullptr);
-    if (checkIn < now) {
-        std::cout << "Check-in date/time cannot be earlier than the current date/time.\n";
-        return;
+    if (checkIn < time(nullptr)) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Check-in date/time cannot be earlier than the current date/time.";
+        return result;
     }
     if (checkOut <= checkIn) {
-        std::cout << "Invalid dates: check-out must be after check-in.\n";
-        return;
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Invalid dates: check-out must be after check-in.";
+        return result;
     }
 
-    // Create reservation inside vector
-    reservations.emplace_back(customerId, checkIn, checkOut);
-    Reservation& res = reservations.back();
-
-    // Try to assign room of selected type
-    bool scheduled = scheduler->scheduleReservation(res.getId(), desiredType);
-
-if (scheduled) {
-    std::cout << "\nReservation created and confirmed!\n";
-    std::cout << "Reservation ID: " << res.getId() << "\n";
-    std::cout << "Assigned Room: " << res.getAssignedRoomNumber() << "\n";
+    // Create reservation inside vector; the append is the only exclusive step
+    Reservation pending(customerId, checkIn, checkOut);
+    pending.setRequestedType(static_cast<int>(type));
+    int id = pending.getId();
+    result.id = id;
+    {
+        TableWriteLock write(locks);
+        reservations.push_back(pending);
+        markChanged(&reservations.back(), -1);
+    }
 
-    // Optional: show room type based on the assigned room
-    Room* room = findRoom(res.getAssignedRoomNumber());
-    if (room) {
-        std::cout << "Room Type: " << room->getTypeString() << "\n";
+    // Try to assign room of selected type, holding only that type's shard
+    {
+        ShardLock shard(locks, shardBit(type));
+        Reservation* res = findReservation(id);
+        if (!res || res->getStatus() != ReservationStatus::PENDING) {
+            // Cancelled by another terminal before a room was assigned
+            result.code = ResultCode::INVALID_STATE;
+            result.message = "Reservation was cancelled before a room could be assigned.";
+            return result;
+        }
+        bool assigned = scheduler->scheduleReservation(id, type);
+        markChanged(res, res->getAssignedRoomNumber());
+        if (assigned) {
+            result.roomNumber = res->getAssignedRoomNumber();
+            result.totalCost = res->getTotalCost();
+            result.message = "Reservation created and confirmed!";
+        } else {
+            result.code = ResultCode::NO_AVAILABILITY;
+            result.message = "Reservation created but no " + roomTypeToString(type) +
+                             " rooms are available for these dates. It is on the waitlist.";
+        }
     }
 
-    std::cout << "Duration: " << res.getDuration() << " night(s)\n";
-    std::cout << "Total Cost: $" << res.getTotalCost() << "\n";
-} else {
-    std::cout << "\nReservation created but no "
-              << roomTypeToString(desiredType)
-              << " rooms are available for these dates.\n";
-    std::cout << "Reservation ID: " << res.getId()
-              << " (Status: Pending)\n";
+    return result;
 }
 
-    saveReservations();
-    saveRooms();
-}
+OperationResult HotelSystem::createGroupReservation(int customerId, const std::vector<RoomType>& roomTypes,
+                                                    time_t checkIn, time_t checkOut, std::vector<int>* ids) {
+    OperationResult result;
+    TracedCall call(trace.get(), TraceOp::CREATE_GROUP, &result);
+    call.withId(customerId);
+    call.withGroup(roomTypes, checkIn, checkOut);
+    if (roomTypes.empty()) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "A group needs at least one room.";
+        return result;
+    }
+    if (checkIn < time(nullptr)) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Check-in date/time cannot be earlier than the current date/time.";
+        return result;
+    }
+    if (checkOut <= checkIn) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Invalid dates: check-out must be after check-in.";
+        return result;
+    }
 
-void HotelSystem::viewReservations() {
-    std::cout << "\n========== ALL RESERVATIONS ==========\n";
-    if (reservations.empty()) {
-        std::cout << "No reservations found.\n";
-        return;
+    // Exclusive for the whole booking: nobody can take a room between the
+    // search and the assignment, and readers never see half a group
+    TableWriteLock write(locks);
+    if (!findCustomer(customerId)) {
+        result.code = ResultCode::NOT_FOUND;
+        result.message = "Customer not found.";
+        return result;
     }
-    
-    for (const auto& r : reservations) {
-        std::cout << "---\n";
-        r.display();
+    std::vector<size_t> roomIndices = scheduler->findGroupRooms(roomTypes, checkIn, checkOut);
+    if (roomIndices.empty()) {
+        result.code = ResultCode::INVALID_STATE;
+        result.message = "Not enough free rooms for the whole group on these dates. Nothing was booked.";
+        return result;
     }
-}
 
-void HotelSystem::cancelReservation() {
-    int id;
-    std::cout << "\nEnter Reservation ID to cancel: ";
-    if (!(std::cin >> id)) {
-        std::cout << "Invalid input. Please enter a number.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        return;
+    std::vector<size_t> reservationIndices;
+    reservationIndices.reserve(roomTypes.size());
+    for (RoomType type : roomTypes) {
+        Reservation r(customerId, checkIn, checkOut);
+        r.setRequestedType(static_cast<int>(type));
+        reservationIndices.push_back(reservations.size());
+        reservations.push_back(r);
     }
-    
-    Reservation* r = findReservation(id);
-    if (!r) {
-        std::cout << "Reservation not found.\n";
-        return;
+    scheduler->assignGroup(reservationIndices, roomIndices);
+
+    std::vector<std::pair<int, std::string>> reservationLines, roomLines;
+    for (size_t index : reservationIndices) {
+        const Reservation& r = reservations[index];
+        snapshots.markReservation(index);
+        frontDesk.update(index, r);
+        reservationLines.emplace_back(r.getId(), r.serialize());
+        history->reservationSaved(r, reservationLines.back().second);
+        result.totalCost += r.getTotalCost();
+        if (ids) ids->push_back(r.getId());
+        call.withCreated(r.getId());
     }
-    
-    if (r->getStatus() == ReservationStatus::CANCELLED) {
-        std::cout << "Reservation already cancelled.\n";
-        return;
+    for (size_t index : roomIndices) {
+        snapshots.markRoom(index);
+        roomLines.emplace_back(rooms[index].getRoomNumber(), rooms[index].serialize());
     }
-    
-    scheduler->removeReservation(id);
-    std::cout << "Reservation cancelled successfully.\n";
-    
-    saveReservations();
-    saveRooms();
+    if (autoSave) {
+        persistence->upsertMany(DataFile::RESERVATIONS, std::move(reservationLines));
+        persistence->upsertMany(DataFile::ROOMS, std::move(roomLines));
+    }
+
+    result.id = reservations[reservationIndices.front()].getId();
+    result.roomNumber = rooms[roomIndices.front()].getRoomNumber();
+    result.message = "Group booked: " + std::to_string(roomTypes.size()) + " room(s) confirmed.";
+    return result;
 }
 
-void HotelSystem::checkInReservation() {
-    int id;
-    std::cout << "\nEnter Reservation ID for check-in: ";
-    if (!(std::cin >> id)) {
-        std::cout << "Invalid input. Please enter a number.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        return;
-    }
-    
+OperationResult HotelSystem::makeRoomFor(int id) {
+    const std::chrono::milliseconds budget(500);
+    const int maxMoves = 8;
+    OperationResult result;
+    result.id = id;
+    TracedCall call(trace.get(), TraceOp::MAKE_ROOM_FOR, &result);
+    call.withId(id);
+
+    // Moves stay within one type, but the reservation is unassigned, so
+    // every shard is needed (see HotelLocks.h)
+    ShardLock all(locks, ALL_SHARDS);
     Reservation* r = findReservation(id);
     if (!r) {
-        std::cout << "Reservation not found.\n";
-        return;
+        result.code = ResultCode::NOT_FOUND;
+        result.message = "Reservation not found.";
+        return result;
     }
-    
-    if (r->getStatus() != ReservationStatus::CONFIRMED) {
-        std::cout << "Reservation must be confirmed before check-in.\n";
-        return;
+    if (r->getStatus() != ReservationStatus::PENDING) {
+        result.code = ResultCode::INVALID_STATE;
+        result.message = "Only pending reservations are waiting for a room.";
+        return result;
+    }
+    if (r->getRequestedType() < 0 || r->getRequestedType() >= ROOM_TYPE_COUNT) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Reservation has no requested room type.";
+        return result;
     }
-    
-    r->setStatus(ReservationStatus::CHECKED_IN);
-    std::cout << "Check-in successful! Welcome!\n";
-    std::cout << "Room Number: " << r->getAssignedRoomNumber() << "\n";
-    
-    saveReservations();
-}
 
-void HotelSystem::checkOutReservation() {
+    time_t now = time(nullptr);
+    Scheduler::DefragPlan plan = scheduler->planDefragmentation(
+        *r, static_cast<RoomType>(r->getRequestedType()), now, budget, maxMoves);
+    if (!plan.found) {
+        result.code = ResultCode::NO_AVAILABILITY;
+        result.message = "No way to fit it by moving up to " + std::to_string(maxMoves) +
+                         " future reservations (" + std::to_string(plan.roomsSearched) + " room(s) searched" +
+                         (plan.timedOut ? ", time budget reached" : "") + "). It stays on the waitlist.";
+        return result;
+    }
+
+    scheduler->applyDefragmentation(static_cast<size_t>(r - reservations.data()), plan);
+    for (const auto& move : plan.moves) {
+        markChanged(&reservations[move.reservation], move.toRoom);
+        markChanged(nullptr, move.fromRoom);
+    }
+    markChanged(r, plan.targetRoom);
+
+    result.roomNumber = plan.targetRoom;
+    result.totalCost = r->getTotalCost();
+    result.message = "Reservation confirmed in room " + std::to_string(plan.targetRoom) + " after moving " +
+                     std::to_string(plan.moves.size()) + " reservation(s).";
+    return result;
+}
+
+OperationResult HotelSystem::cancelReservation(int id) {
+    OperationResult result;
+    result.id = id;
+    TracedCall call(trace.get(), TraceOp::CANCEL_RESERVATION, &result);
+    call.withId(id);
+    {
+        ShardLock shard(locks, std::defer_lock);
+        Reservation* r = lockReservation(id, shard);
+        if (!r) {
+            result.code = ResultCode::NOT_FOUND;
+            result.message = "Reservation not found.";
+            return result;
+        }
+        if (r->getStatus() == ReservationStatus::CANCELLED) {
+            result.code = ResultCode::INVALID_STATE;
+            result.message = "Reservation already cancelled.";
+            return result;
+        }
+        int roomNumber = r->getAssignedRoomNumber();
+        std::vector<size_t> promoted;
+        scheduler->removeReservation(id, &promoted);
+        markChanged(r, roomNumber);
+        markPromoted(promoted);
+    }
+    result.message = "Reservation cancelled successfully.";
+    return result;
+}
+
+OperationResult HotelSystem::checkInReservation(int id) {
+    OperationResult result;
+    result.id = id;
+    TracedCall call(trace.get(), TraceOp::CHECK_IN, &result);
+    call.withId(id);
+    {
+        ShardLock shard(locks, std::defer_lock);
+        Reservation* r = lockReservation(id, shard);
+        if (!r) {
+            result.code = ResultCode::NOT_FOUND;
+            result.message = "Reservation not found.";
+            return result;
+        }
+        if (r->getStatus() != ReservationStatus::CONFIRMED) {
+            result.code = ResultCode::INVALID_STATE;
+            result.message = "Reservation must be confirmed before check-in.";
+            return result;
+        }
+        r->setStatus(ReservationStatus::CHECKED_IN);
+        markChanged(r, -1);
+        result.roomNumber = r->getAssignedRoomNumber();
+    }
+    result.message = "Check-in successful! Welcome!";
+    return result;
+}
+
+OperationResult HotelSystem::checkOutReservation(int id) {
+    OperationResult result;
+    result.id = id;
+    TracedCall call(trace.get(), TraceOp::CHECK_OUT, &result);
+    call.withId(id);
+    {
+        ShardLock shard(locks, std::defer_lock);
+        Reservation* r = lockReservation(id, shard);
+        if (!r) {
+            result.code = ResultCode::NOT_FOUND;
+            result.message = "Reservation not found.";
+            return result;
+        }
+        if (r->getStatus() != ReservationStatus::CHECKED_IN) {
+            result.code = ResultCode::INVALID_STATE;
+            result.message = "Must be checked-in before check-out.";
+            return result;
+        }
+        r->setStatus(ReservationStatus::CHECKED_OUT);
+        std::vector<size_t> promoted;
+        scheduler->releaseReservation(id, &promoted);
+        markChanged(r, -1);
+        markPromoted(promoted);
+        result.roomNumber = r->getAssignedRoomNumber();
+        result.totalCost = r->getTotalCost();
+    }
+    result.message = "Check-out successful.";
+    return result;
+}
+
+std::vector<int> HotelSystem::findAvailableRooms(RoomType type, time_t checkIn, time_t checkOut) const {
+    TracedCall call(trace.get(), TraceOp::FIND_AVAILABLE);
+    call.withStay(type, checkIn, checkOut);
+    std::vector<int> available;
+    {
+        ShardLock shard(locks, shardBit(type), false);
+        available = scheduler->getAvailableRooms(type, checkIn, checkOut);
+    }
+    call.setOutcome(ResultCode::OK, static_cast<int64_t>(available.size()));
+    return available;
+}
+
+bool HotelSystem::lookupReservation(int id, Reservation& out) const {
+    TracedCall call(trace.get(), TraceOp::LOOKUP_RESERVATION);
+    call.withId(id);
+    bool found = false;
+    {
+        ReadLock read(locks);
+        for (const auto& r : reservations) {
+            if (r.getId() == id) {
+                out = r;
+                found = true;
+                break;
+            }
+        }
+    }
+    call.setOutcome(found ? ResultCode::OK : ResultCode::NOT_FOUND, found ? id : 0);
+    return found;
+}
+
+bool HotelSystem::lookupCustomer(int id, Customer& out) const {
+    TracedCall call(trace.get(), TraceOp::LOOKUP_CUSTOMER);
+    call.withId(id);
+    bool found = false;
+    {
+        TableReadLock read(locks);
+        for (const auto& c : customers) {
+            if (c.getId() == id) {
+                out = c;
+                found = true;
+                break;
+            }
+        }
+    }
+    call.setOutcome(found ? ResultCode::OK : ResultCode::NOT_FOUND, found ? id : 0);
+    return found;
+}
+
+namespace {
+    std::vector<Reservation> byId(const std::vector<Reservation>& table, const std::vector<size_t>& positions) {
+        std::vector<Reservation> out;
+        out.reserve(positions.size());
+        for (size_t position : positions) {
+            if (position < table.size()) out.push_back(table[position]);
+        }
+        std::sort(out.begin(), out.end(),
+                  [](const Reservation& a, const Reservation& b) { return a.getId() < b.getId(); });
+        return out;
+    }
+}
+
+bool HotelSystem::queryReservations(const ReservationQuery& query, ReservationPage& out) const {
+    const int maxIndexedDays = 366;
+    const ReservationFilter& f = query.filter;
+    std::unordered_map<int, RoomType> roomTypes;
+    {
+        ReadLock read(locks);
+        for (const auto& room : rooms) roomTypes[room.getRoomNumber()] = room.getType();
+        ReservationPager pager(query, roomTypes);
+        if (!pager.ok()) return false;
+
+        std::vector<size_t> candidates;
+        std::string plan;
+        if (f.customerId != 0) {
+            candidates = frontDesk.forCustomer(f.customerId);
+            plan = "customer index";
+        }
+        if (f.roomNumber > 0) {
+            std::vector<size_t> inRoom = frontDesk.forRoom(f.roomNumber);
+            if (plan.empty() || inRoom.size() < candidates.size()) {
+                candidates.swap(inRoom);
+                plan = "room index";
+            }
+        }
+        unsigned cancelled = ReservationFilter::statusBit(ReservationStatus::CANCELLED);
+        if (plan.empty() && f.checkInFromDay != INT_MIN && f.checkInToDay != INT_MAX &&
+            static_cast<int64_t>(f.checkInToDay) - f.checkInFromDay <= maxIndexedDays &&
+            f.statusMask != 0 && (f.statusMask & cancelled) == 0) {
+            // Arrival buckets hold every stay that is not cancelled
+            for (int day = f.checkInFromDay; day < f.checkInToDay; ++day) {
+                std::vector<size_t> arriving = frontDesk.arrivals(day);
+                candidates.insert(candidates.end(), arriving.begin(), arriving.end());
+            }
+            plan = "arrival index";
+        }
+        if (!plan.empty()) {
+            for (size_t position : candidates) {
+                if (position < reservations.size()) pager.offer(reservations[position]);
+            }
+            out = pager.finish(plan);
+            return true;
+        }
+    }
+
+    // No index fits: a lock-free pass over the latest snapshot
+    ReservationPager pager(query, roomTypes);
+    std::shared_ptr<const HotelSnapshot> snap = snapshot();
+    for (size_t i = 0; i < snap->getReservationCount(); ++i) pager.offer(snap->reservationAt(i));
+    out = pager.finish("scan");
+    return true;
+}
+
+std::vector<Reservation> HotelSystem::arrivalsOn(int day) const {
+    ReadLock read(locks);
+    return byId(reservations, frontDesk.arrivals(day));
+}
+
+std::vector<Reservation> HotelSystem::departuresOn(int day) const {
+    ReadLock read(locks);
+    return byId(reservations, frontDesk.departures(day));
+}
+
+std::vector<Reservation> HotelSystem::inHouse() const {
+    ReadLock read(locks);
+    return byId(reservations, frontDesk.inHouse());
+}
+
+bool HotelSystem::historyAt(time_t when, HistoryState& out) const {
+    return history->stateAt(when, out);
+}
+
+bool HotelSystem::lookupReservationAt(int id, time_t when, Reservation& out) const {
+    return history->reservationAt(id, when, out);
+}
+
+std::vector<int> HotelSystem::parseRoomList(const std::string& text) const {
+    std::string spaced = text;
+    std::replace(spaced.begin(), spaced.end(), ',', ' ');
+    std::vector<int> roomNumbers;
+    std::istringstream tokens(spaced);
+    std::string token;
+    TableReadLock read(locks);
+    while (tokens >> token) {
+        int first = 0, last = 0;
+        char dash = 0;
+        std::istringstream range(token);
+        if (!(range >> first)) continue;
+        if (range >> dash >> last && dash == '-') {
+            for (const auto& room : rooms) {
+                if (room.getRoomNumber() >= first && room.getRoomNumber() <= last) {
+                    roomNumbers.push_back(room.getRoomNumber());
+                }
+            }
+        } else {
+            roomNumbers.push_back(first);
+        }
+    }
+    return roomNumbers;
+}
+
+size_t HotelSystem::roomCount(RoomType type) const {
+    TableReadLock read(locks);
+    return static_cast<size_t>(std::count_if(rooms.begin(), rooms.end(),
+                                             [type](const Room& room) { return room.getType() == type; }));
+}
+
+OperationResult HotelSystem::blockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay,
+                                        const std::string& reason) {
+    OperationResult result;
+    TracedCall call(trace.get(), TraceOp::BLOCK_ROOMS, &result);
+    call.withBlock(roomNumbers, fromDay, toDay, reason);
+    if (roomNumbers.empty() || toDay <= fromDay) {
+        result.code = ResultCode::INVALID_INPUT;
+        result.message = "Give at least one room and an end date after the start date.";
+        return result;
+    }
+
+    Scheduler::BlockOutcome outcome;
+    {
+        // Displaced stays may move between rooms of any type
+        TableWriteLock write(locks);
+        std::vector<size_t> changed;
+        outcome = scheduler->blockRooms(roomNumbers, fromDay, toDay, reason, &changed);
+        for (int number : roomNumbers) markChanged(nullptr, number);
+        for (size_t index : changed) markChanged(&reservations[index], reservations[index].getAssignedRoomNumber());
+        if (autoSave && outcome.blocked > 0) saveBlocks();
+    }
+
+    if (outcome.blocked == 0) {
+        result.code = outcome.unknown > 0 && outcome.skipped == 0 ? ResultCode::NOT_FOUND
+                                                                    : ResultCode::INVALID_STATE;
+    }
+    std::ostringstream message;
+    message << "Blocked " << outcome.blocked << " room(s).";
+    if (outcome.moved > 0) message << " " << outcome.moved << " reservation(s) moved to another room.";
+    if (outcome.waitlisted > 0) message << " " << outcome.waitlisted << " reservation(s) put on the waitlist.";
+    if (outcome.skipped > 0) message << " " << outcome.skipped << " room(s) skipped (guest checked in or already blocked).";
+    if (outcome.unknown > 0) message << " " << outcome.unknown << " room number(s) not found.";
+    result.message = message.str();
+    return result;
+}
+
+OperationResult HotelSystem::unblockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay) {
+    OperationResult result;
+    TracedCall call(trace.get(), TraceOp::UNBLOCK_ROOMS, &result);
+    call.withBlock(roomNumbers, fromDay, toDay, std::string());
+    int lifted;
+    {
+        TableWriteLock write(locks);
+        std::vector<size_t> promoted;
+        lifted = scheduler->unblockRooms(roomNumbers, fromDay, toDay, &promoted);
+        markPromoted(promoted);
+        if (autoSave && lifted > 0) saveBlocks();
+    }
+    if (lifted == 0) {
+        result.code = ResultCode::NOT_FOUND;
+        result.message = "No blocks found for those rooms and dates.";
+        return result;
+    }
+    result.message = "Lifted " + std::to_string(lifted) + " block(s).";
+    return result;
+}
+
+OperationResult HotelSystem::reschedule(bool maximizeRevenue) {
+    OperationResult result;
+    TracedCall call(trace.get(), TraceOp::RESCHEDULE, &result);
+    call.withId(maximizeRevenue ? 1 : 0);
+    TableWriteLock write(locks);
+    
+    std::unordered_map<int, Room*> roomByNumber;
+    for (auto& room : rooms) {
+        while (!room.getReservationIds().empty()) {
+            int resId = room.getReservationIds().front();
+            room.removeReservation(resId);
+        }
+        roomByNumber[room.getRoomNumber()] = &room;
+    }
+    
+    // Guests already in house keep their rooms; everything else is placed again
+    for (auto& res : reservations) {
+        if (res.getStatus() == ReservationStatus::CHECKED_IN) {
+            auto it = roomByNumber.find(res.getAssignedRoomNumber());
+            if (it != roomByNumber.end()) it->second->addReservation(res.getId());
+        } else if (res.getStatus() != ReservationStatus::CANCELLED &&
+                   res.getStatus() != ReservationStatus::CHECKED_OUT) {
+            res.setAssignedRoomNumber(-1);
+            res.setStatus(ReservationStatus::PENDING);
+            res.setTotalCost(Money());
+        }
+    }
+    
+    if (maximizeRevenue) {
+        scheduler->scheduleReservationsForRevenue();
+    } else {
+        scheduler->scheduleReservations();
+    }
+    snapshots.markAll();
+    history->sync(customers, reservations);
+    frontDesk.rebuild(reservations);
+
+    int confirmed = 0, pending = 0;
+    Money revenue;
+    for (const auto& res : reservations) {
+        if (res.getStatus() == ReservationStatus::CONFIRMED) {
+            ++confirmed;
+            revenue += res.getTotalCost();
+        } else if (res.getStatus() == ReservationStatus::PENDING) {
+            ++pending;
+        }
+    }
+    result.totalCost = revenue;
+    result.message = std::to_string(confirmed) + " confirmed (" + revenue.toString() + "), " +
+                     std::to_string(pending) + " pending.";
+
+    if (autoSave) {
+        saveReservations();
+        saveRooms();
+    }
+    return result;
+}
+
+void HotelSystem::createReservation() {
+    int customerId;
+    std::cout << "\n=== Create New Reservation ===\n";
+    std::cout << "Customer ID: ";
+
+    if (!(std::cin >> customerId)) {
+        std::cout << "Invalid input for Customer ID.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+
+    if (!findCustomer(customerId)) {
+        std::cout << "Customer not found.\n";
+        return;
+    }
+
+    // -------- NEW: choose room type ----------
+    int typeChoice;
+    RoomType desiredType;
+
+    while (true) {
+        std::cout << "Room Type (1. Single, 2. Double, 3. Suite, 4. Deluxe): ";
+        if (!(std::cin >> typeChoice)) {
+            std::cout << "Invalid input. Please enter a number.\n";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return;
+        }
+
+        if (typeChoice == 1) { desiredType = RoomType::SINGLE; break; }
+        if (typeChoice == 2) { desiredType = RoomType::DOUBLE; break; }
+        if (typeChoice == 3) { desiredType = RoomType::SUITE; break; }
+        if (typeChoice == 4) { desiredType = RoomType::DELUXE; break; }
+
+        std::cout << "Invalid choice. Please select 1–4.\n";
+    }
+
+    // Check if hotel actually HAS that room type
+    bool hasType = false;
+    for (const auto& room : rooms) {
+        if (room.getType() == desiredType) {
+            hasType = true;
+            break;
+        }
+    }
+
+    if (!hasType) {
+        std::cout << "Sorry, there are no rooms of this type.\n";
+        return;
+    }
+    // -----------------------------------------
+
+    int year, month, day, checkInHour;
+    int checkOutYear, checkOutMonth, checkOutDay, checkOutHour;
+
+    std::cout << "Check-in Date (YYYY MM DD HH): ";
+    if (!(std::cin >> year >> month >> day >> checkInHour)) {
+        std::cout << "Invalid input for check-in date/time.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+
+    std::cout << "Check-out Date (YYYY MM DD HH): ";
+    if (!(std::cin >> checkOutYear >> checkOutMonth >> checkOutDay >> checkOutHour)) {
+        std::cout << "Invalid input for check-out date/time.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+
+    if (!isValidDate(year, month, day, checkInHour)) {
+    std::cout << "Invalid check-in date. Please enter a valid date.\n";
+    return;
+    }
+    if (!isValidDate(checkOutYear, checkOutMonth, checkOutDay, checkOutHour)) {
+    std::cout << "Invalid check-out date. Please enter a valid date.\n";
+    return;
+    }
+
+    time_t checkIn = createDateTime(year, month, day, checkInHour, 0);
+    time_t checkOut = createDateTime(checkOutYear, checkOutMonth, checkOutDay, checkOutHour, 0);
+
+    OperationResult result = createReservation(customerId, desiredType, checkIn, checkOut);
+
+if (result.ok()) {
+    std::cout << "\nReservation created and confirmed!\n";
+    std::cout << "Reservation ID: " << result.id << "\n";
+    std::cout << "Assigned Room: " << result.roomNumber << "\n";
+
+    // Optional: show room type based on the assigned room
+    Room* room = findRoom(result.roomNumber);
+    if (room) {
+        std::cout << "Room Type: " << room->getTypeString() << "\n";
+    }
+
+    std::cout << "Duration: " << findReservation(result.id)->getDuration() << " night(s)\n";
+    std::cout << "Total Cost: $" << result.totalCost << "\n";
+} else if (result.code == ResultCode::NO_AVAILABILITY) {
+    std::cout << "\n" << result.message << "\n";
+    std::cout << "Reservation ID: " << result.id
+              << " (Status: Pending)\n";
+} else {
+    std::cout << result.message << "\n";
+}
+}
+
+void HotelSystem::viewReservations() {
+    std::cout << "\n========== ALL RESERVATIONS ==========\n";
+    printReservationPages(ReservationQuery());
+}
+
+void HotelSystem::printReservationPages(ReservationQuery query) {
+    ReportBuffer out(std::cout);
+    size_t shown = 0;
+    while (true) {
+        ReservationPage page;
+        if (!queryReservations(query, page)) return;
+        if (page.matched == 0) {
+            out << "No reservations found.\n";
+            return;
+        }
+        for (const auto& r : page.rows) {
+            out << "---\n";
+            r.render(out);
+        }
+        shown += page.rows.size();
+        out << "-- " << shown << " of " << page.matched << " (" << page.plan << ") --";
+        out.flush();
+        if (page.nextCursor.empty() || !morePages()) break;
+        query.cursor = page.nextCursor;
+    }
+    out << "\n";
+}
+
+void HotelSystem::searchReservations() {
+    ReservationQuery query;
+    ReservationFilter& f = query.filter;
+    auto ask = [](const char* prompt, int& value) {
+        std::cout << prompt;
+        if (std::cin >> value) return true;
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return false;
+    };
+    auto askDay = [&](const char* prompt, int& day) {
+        int year, month, dayOfMonth;
+        if (!ask(prompt, year)) return false;
+        if (year == 0) return true;
+        if (!(std::cin >> month >> dayOfMonth) || !isValidDate(year, month, dayOfMonth, 0)) {
+            std::cout << "Invalid date. Please enter a valid date.\n";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return false;
+        }
+        day = dayIndexFromCivil(year, month, dayOfMonth);
+        return true;
+    };
+
+    int status, type, sort;
+    std::cout << "\n=== Search Reservations (0 = any) ===\n";
+    if (!ask("Status (1 Pending, 2 Confirmed, 3 Checked In, 4 Checked Out, 5 Cancelled): ", status)) return;
+    if (status >= 1 && status <= 5) f.statusMask = 1u << (status - 1);
+    if (!ask("Customer ID: ", f.customerId)) return;
+    if (!ask("Room Number: ", f.roomNumber)) return;
+    if (!ask("Room Type (1 Single, 2 Double, 3 Suite, 4 Deluxe): ", type)) return;
+    if (type >= 1 && type <= ROOM_TYPE_COUNT) f.roomType = type - 1;
+    if (!askDay("Check-in from (YYYY MM DD): ", f.checkInFromDay)) return;
+    if (!askDay("Check-in before (YYYY MM DD): ", f.checkInToDay)) return;
+    if (!ask("Sort by (1 ID, 2 Check-in, 3 Check-out, 4 Total Cost; negative for descending): ", sort)) return;
+    query.descending = sort < 0;
+    switch (sort < 0 ? -sort : sort) {
+        case 2: query.sort = ReservationSort::CHECK_IN; break;
+        case 3: query.sort = ReservationSort::CHECK_OUT; break;
+        case 4: query.sort = ReservationSort::TOTAL_COST; break;
+        default: query.sort = ReservationSort::ID; break;
+    }
+    printReservationPages(query);
+}
+
+void HotelSystem::cancelReservation() {
     int id;
-    std::cout << "\nEnter Reservation ID for check-out: ";
+    std::cout << "\nEnter Reservation ID to cancel: ";
     if (!(std::cin >> id)) {
         std::cout << "Invalid input. Please enter a number.\n";
         std::cin.clear();
@@ -626,29 +1561,52 @@ void HotelSystem::checkOutReservation() {
         return;
     }
     
-    Reservation* r = findReservation(id);
-    if (!r) {
-        std::cout << "Reservation not found.\n";
+    OperationResult result = cancelReservation(id);
+    std::cout << result.message << "\n";
+}
+
+void HotelSystem::checkInReservation() {
+    int id;
+    std::cout << "\nEnter Reservation ID for check-in: ";
+    if (!(std::cin >> id)) {
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         return;
     }
     
-    if (r->getStatus() != ReservationStatus::CHECKED_IN) {
-        std::cout << "Must be checked-in before check-out.\n";
+    OperationResult result = checkInReservation(id);
+    std::cout << result.message << "\n";
+    if (result.ok()) {
+        std::cout << "Room Number: " << result.roomNumber << "\n";
+    }
+}
+
+void HotelSystem::checkOutReservation() {
+    int id;
+    std::cout << "\nEnter Reservation ID for check-out: ";
+    if (!(std::cin >> id)) {
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         return;
     }
     
-    r->setStatus(ReservationStatus::CHECKED_OUT);
-    generateInvoice(id);
-    
-    saveReservations();
+    OperationResult result = checkOutReservation(id);
+    if (result.ok()) {
+        generateInvoice(id);
+    } else {
+        std::cout << result.message << "\n";
+    }
 }
 
 
 void HotelSystem::viewRooms() {
-    std::cout << "\n========== ALL ROOMS ==========\n";
+    ReportBuffer out(std::cout);
+    out << "\n========== ALL ROOMS ==========\n";
     for (const auto& r : rooms) {
-        std::cout << "---\n";
-        r.display();
+        out << "---\n";
+        r.render(out);
     }
 }
 
@@ -665,6 +1623,25 @@ void HotelSystem::viewRoomSchedule() {
     scheduler->displayRoomSchedule(roomNum);
 }
 
+void HotelSystem::viewFrontDesk() {
+    int today = toDayIndex(time(nullptr));
+    ReportBuffer out(std::cout);
+    auto list = [&out](const char* title, const std::vector<Reservation>& stays) {
+        out << "\n" << title << " (" << stays.size() << ")\n";
+        if (stays.empty()) out << "  [None]\n";
+        for (const auto& r : stays) {
+            out << "  - Reservation #" << r.getId() << " [Customer " << r.getCustomerId() << "] ";
+            if (r.getAssignedRoomNumber() > 0) out << "Room " << r.getAssignedRoomNumber();
+            else out << "No room";
+            out << ", " << r.getDuration() << " night(s), " << r.getStatusString() << "\n";
+        }
+    };
+    out << "\n====== FRONT DESK " << formatDay(today) << " ======\n";
+    list("Arrivals", arrivalsOn(today));
+    list("Departures", departuresOn(today));
+    list("In House", inHouse());
+}
+
 void HotelSystem::generateInvoice(int id) {
     Reservation* r = findReservation(id);
     if (!r) {
@@ -675,40 +1652,61 @@ void HotelSystem::generateInvoice(int id) {
     Customer* c = findCustomer(r->getCustomerId());
     Room* room = findRoom(r->getAssignedRoomNumber());
 
-    time_t invoiceDate = r->getCheckOutTime();
-    time_t checkInTime = r->getCheckInTime();
-    time_t checkOutTime = r->getCheckOutTime();
-    
-    std::cout << "\n";
-    std::cout << "          SMART HOTEL - INVOICE                 \n";
-    
-    std::cout << "Invoice for Reservation #" << r->getId() << "\n";
-    std::cout << "Date: " << std::put_time(std::localtime(&invoiceDate), "%Y-%m-%d") << "\n\n";
-    
-    std::cout << "Customer Details:\n";
-    std::cout << "  Name: " << (c ? c->getName() : "N/A") << "\n";
-    std::cout << "  Email: " << (c ? c->getEmail() : "N/A") << "\n";
-    std::cout << "  Phone: " << (c ? c->getPhone() : "N/A") << "\n\n";
-    
-    std::cout << "Stay Details:\n";
-    std::cout << "  Room Number: " << r->getAssignedRoomNumber() << "\n";
-    std::cout << "  Room Type: " << (room ? room->getTypeString() : "N/A") << "\n";
-    std::cout << "  Check-in: " << std::put_time(std::localtime(&checkInTime), "%Y-%m-%d %H:%M") << "\n";
-    std::cout << "  Check-out: " << std::put_time(std::localtime(&checkOutTime), "%Y-%m-%d %H:%M") << "\n";
-    std::cout << "  Duration: " << r->getDuration() << " night(s)\n\n";
-    
-    std::cout << "Charges:\n";
-    std::cout << "  Room Rate: $" << (room ? room->getPricePerNight() : 0) << " per night\n";
-    std::cout << "  Number of Nights: " << r->getDuration() << "\n";
-    std::cout << "  Subtotal: $" << r->getTotalCost() << "\n";
-    
-    double tax = r->getTotalCost() * 0.10;
-    double total = r->getTotalCost() + tax;
-    
-    std::cout << "  Tax (10%): $" << std::fixed << std::setprecision(2) << tax << "\n";
-    std::cout << "  TOTAL: $" << total << "\n\n";
-    
-    std::cout << "Thank you for staying with us!\n";
+    ReportBuffer out(std::cout);
+    InvoiceBatch::render(out, *r, c, room);
+}
+
+void HotelSystem::runInvoiceBatch() {
+    int mode;
+    std::cout << "\nSelect Invoices (1. By Reservation IDs, 2. By Check-Out Date Range): ";
+    if (!(std::cin >> mode) || (mode != 1 && mode != 2)) {
+        std::cout << "Invalid choice.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+
+    InvoiceBatch batch(reservations, customers, rooms);
+    std::vector<int> ids;
+
+    if (mode == 1) {
+        std::cout << "Reservation IDs (space separated, 0 to finish): ";
+        int id;
+        while (std::cin >> id && id != 0) {
+            ids.push_back(id);
+        }
+        if (!std::cin) {
+            std::cout << "Invalid input. Please enter numbers.\n";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return;
+        }
+    } else {
+        int from, to;
+        if (!promptDayRange(from, to)) return;
+        ids = batch.selectByCheckOut(from, to);
+    }
+
+    if (ids.empty()) {
+        std::cout << "No invoices to generate.\n";
+        return;
+    }
+
+    std::string outputDir;
+    std::cout << "Output Directory: ";
+    std::cin >> outputDir;
+
+    InvoiceBatchResult result = batch.run(ids, outputDir);
+
+    std::cout << "\nInvoices Written: " << result.invoicesWritten << "\n";
+    std::cout << "Bytes Written: " << result.bytesWritten << "\n";
+    std::cout << "Elapsed: " << std::fixed << std::setprecision(3) << result.seconds << " s\n";
+    std::cout << "Throughput: " << std::setprecision(0) << result.invoicesPerSecond << " invoices/sec\n";
+    if (!result.failedIds.empty()) {
+        std::cout << "Failed Reservation IDs:";
+        for (int id : result.failedIds) std::cout << " " << id;
+        std::cout << "\n";
+    }
 }
 
 bool HotelSystem::adminLogin() {
@@ -736,14 +1734,12 @@ void HotelSystem::adminLogout() {
 }
 
 void HotelSystem::viewOccupancyReport() {
-    std::cout << "\n========== OCCUPANCY REPORT ==========\n";
-    std::cout << "Total Rooms: " << rooms.size() << "\n";
-    std::cout << "Rooms in Use: " << scheduler->getTotalRoomsUsed() << "\n";
-    std::cout << "Occupancy Rate: " << std::fixed << std::setprecision(1) 
-              << scheduler->getOccupancyRate() << "%\n\n";
-    
+    std::shared_ptr<const HotelSnapshot> snap = snapshot();
+
     int active = 0, pending = 0, checkedIn = 0, cancelled = 0;
-    for (const auto& r : reservations) {
+    std::unordered_set<int> liveIds;
+    for (size_t i = 0; i < snap->getReservationCount(); ++i) {
+        const Reservation& r = snap->reservationAt(i);
         switch (r.getStatus()) {
             case ReservationStatus::CONFIRMED: active++; break;
             case ReservationStatus::PENDING: pending++; break;
@@ -751,77 +1747,557 @@ void HotelSystem::viewOccupancyReport() {
             case ReservationStatus::CANCELLED: cancelled++; break;
             default: break;
         }
+        if (r.getStatus() != ReservationStatus::CANCELLED &&
+            r.getStatus() != ReservationStatus::CHECKED_OUT) {
+            liveIds.insert(r.getId());
+        }
+    }
+
+    // A room is in use while any of its reservations is still live
+    int roomsUsed = 0;
+    for (size_t i = 0; i < snap->getRoomCount(); ++i) {
+        for (int resId : snap->roomAt(i).getReservationIds()) {
+            if (liveIds.count(resId)) {
+                ++roomsUsed;
+                break;
+            }
+        }
     }
+    double occupancy = snap->getRoomCount() == 0
+        ? 0.0 : static_cast<double>(roomsUsed) / snap->getRoomCount() * 100.0;
+
+    std::cout << "\n========== OCCUPANCY REPORT ==========\n";
+    std::cout << "Total Rooms: " << snap->getRoomCount() << "\n";
+    std::cout << "Rooms in Use: " << roomsUsed << "\n";
+    std::cout << "Occupancy Rate: " << std::fixed << std::setprecision(1) 
+              << occupancy << "%\n\n";
     
     std::cout << "Reservation Statistics:\n";
     std::cout << "  Confirmed: " << active << "\n";
     std::cout << "  Checked In: " << checkedIn << "\n";
     std::cout << "  Pending: " << pending << "\n";
     std::cout << "  Cancelled: " << cancelled << "\n";
-    std::cout << "  Total: " << reservations.size() << "\n";
+    std::cout << "  Total: " << snap->getReservationCount() << "\n";
+}
+
+bool HotelSystem::promptDayRange(int& from, int& to) {
+    int fromYear, fromMonth, fromDay;
+    int toYear, toMonth, toDay;
+
+    std::cout << "\nFrom Date (YYYY MM DD): ";
+    if (!(std::cin >> fromYear >> fromMonth >> fromDay)) {
+        std::cout << "Invalid input for start date.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return false;
+    }
+    std::cout << "To Date, exclusive (YYYY MM DD): ";
+    if (!(std::cin >> toYear >> toMonth >> toDay)) {
+        std::cout << "Invalid input for end date.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return false;
+    }
+    if (!isValidDate(fromYear, fromMonth, fromDay, 0) || !isValidDate(toYear, toMonth, toDay, 0)) {
+        std::cout << "Invalid date. Please enter a valid date.\n";
+        return false;
+    }
+
+    from = dayIndexFromCivil(fromYear, fromMonth, fromDay);
+    to = dayIndexFromCivil(toYear, toMonth, toDay);
+    if (to <= from) {
+        std::cout << "Invalid range: end date must be after start date.\n";
+        return false;
+    }
+    return true;
+}
+
+void HotelSystem::viewOccupancySeries() {
+    int from, to;
+    if (!promptDayRange(from, to)) return;
+
+    int typeChoice;
+    std::cout << "Room Type (0. All, 1. Single, 2. Double, 3. Suite, 4. Deluxe): ";
+    if (!(std::cin >> typeChoice) || typeChoice < 0 || typeChoice > 4) {
+        std::cout << "Invalid room type.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+
+    OccupancyReport rep;
+    {
+        ReadLock read(locks);
+        rep = typeChoice == 0
+            ? scheduler->getOccupancySeries(from, to)
+            : scheduler->getOccupancySeries(from, to, static_cast<RoomType>(typeChoice - 1));
+    }
+
+    std::cout << "\n========== OCCUPANCY TIME SERIES ==========\n";
+    std::cout << "Room Type: " << (typeChoice == 0 ? "All" : roomTypeToString(static_cast<RoomType>(typeChoice - 1))) << "\n\n";
+    std::cout << std::left << std::setw(12) << "Date" << std::right
+              << std::setw(8) << "Sold" << std::setw(8) << "Rooms"
+              << std::setw(10) << "Occ %" << std::setw(12) << "Revenue" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& day : rep.days) {
+        std::cout << std::left << std::setw(12) << formatDay(day.day) << std::right
+                  << std::setw(8) << day.roomNightsSold << std::setw(8) << day.roomsAvailable
+                  << std::setw(10) << day.occupancyRate
+                  << std::setw(12) << day.revenue << "\n";
+    }
+
+    std::cout << "\nRoom-Nights Sold: " << rep.totalRoomNightsSold
+              << " / " << rep.totalRoomNightsAvailable << "\n";
+    std::cout << "Occupancy Rate: " << rep.occupancyRate << "%\n";
+    std::cout << "Revenue: $" << rep.totalRevenue << "\n";
+}
+
+void HotelSystem::viewRevenueReport() {
+    int from, to;
+    if (!promptDayRange(from, to)) return;
+
+    char mode;
+    std::cout << "Use cached rollup? (y/n): ";
+    std::cin >> mode;
+
+    RevenueSummary rep;
+    {
+        // The cached path consumes dirty ranges, so reports run one at a time
+        std::lock_guard<std::mutex> reporting(reportMutex);
+        if (mode == 'y' || mode == 'Y') {
+            ReadLock read(locks);
+            rep = analytics.computeCached(scheduler->getCalendar(), rooms, from, to);
+        } else {
+            // Full scan over a snapshot: bookings carry on meanwhile
+            rep = analytics.compute(*snapshot(), from, to);
+        }
+    }
+
+    std::cout << "\n========== REVENUE REPORT ==========\n";
+    std::cout << "Period: " << formatDay(from) << " to " << formatDay(to) << " (exclusive)\n";
+    std::cout << "Room Revenue: $" << rep.totalRevenue << "\n";
+    std::cout << "Room-Nights Sold: " << rep.roomNightsSold
+              << " / " << rep.roomNightsAvailable << "\n";
+    std::cout << "ADR: $" << rep.adr << "\n";
+    std::cout << "RevPAR: $" << rep.revpar << "\n\n";
+
+    std::cout << "Revenue by Room Type:\n";
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        std::cout << "  " << std::left << std::setw(8) << roomTypeToString(static_cast<RoomType>(t))
+                  << std::right << " $" << std::setw(12) << rep.revenueByType[t]
+                  << "  (" << rep.roomNightsByType[t] << " nights)\n";
+    }
+
+    std::cout << "\nRevenue by Month:\n";
+    if (rep.revenueByMonth.empty()) {
+        std::cout << "  [No revenue in this period]\n";
+    }
+    for (const auto& m : rep.revenueByMonth) {
+        std::cout << "  " << m.first / 100 << "-" << std::setw(2) << std::setfill('0') << m.first % 100
+                  << std::setfill(' ') << " $" << std::setw(12) << m.second << "\n";
+    }
+}
+
+void HotelSystem::viewPersistenceStats() {
+    PersistenceStats stats = persistence->getStats();
+
+    std::cout << "\n========== PERSISTENCE ==========\n";
+    std::cout << "Queue Depth: " << stats.queueDepth << " (max " << stats.maxQueueDepth << ")\n";
+    std::cout << "Changes Queued: " << stats.deltasEnqueued << "\n";
+    std::cout << "Changes Coalesced: " << stats.deltasCoalesced << "\n";
+    std::cout << "File Writes: " << stats.fileWrites << " (" << stats.bytesWritten << " bytes)\n";
+    std::cout << "Write Errors: " << stats.writeErrors << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Flush Latency (ms): last " << stats.lastFlushMillis
+              << ", avg " << stats.avgFlushMillis << ", max " << stats.maxFlushMillis << "\n";
+
+    HistoryStats events = history->getStats();
+    std::cout << "History: " << events.events << " events, " << events.snapshots << " snapshot(s), "
+              << events.logBytes << " bytes of log\n";
+    std::cout << "Next Snapshot: in " << events.snapshotInterval - std::min(events.snapshotInterval,
+                                                                          events.eventsSinceSnapshot)
+              << " event(s)\n";
+}
+
+void HotelSystem::viewMetrics() {
+    Metrics::dumpText(std::cout);
+
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::string path;
+    std::cout << "Export as JSON to file (blank to skip): ";
+    std::getline(std::cin, path);
+    if (path.empty()) return;
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cout << "Failed to open " << path << " for writing.\n";
+        return;
+    }
+    Metrics::dumpJson(file);
+    std::cout << "Metrics written to " << path << "\n";
+}
+
+void HotelSystem::manageRateCalendar() {
+    std::cout << "\n========== RATE CALENDAR ==========\n";
+    const auto& rules = rateCalendar.getRules();
+    if (rules.empty()) {
+        std::cout << "No rate rules. All nights use the room's base price.\n";
+    }
+    for (size_t i = 0; i < rules.size(); ++i) {
+        const RateRule& rule = rules[i];
+        std::cout << i + 1 << ". " << rule.getKindString() << " - "
+                  << roomTypeToString(rule.type) << " "
+                  << formatDay(rule.fromDay) << " to " << formatDay(rule.toDay)
+                  << " (exclusive): $" << rule.surcharge << "/night\n";
+    }
+
+    int choice;
+    std::cout << "\n1. Add Rule  2. Remove Rule  0. Back\nEnter choice: ";
+    if (!(std::cin >> choice)) {
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+
+    if (choice == 2) {
+        size_t index;
+        std::cout << "Rule number to remove: ";
+        if (!(std::cin >> index) || !rateCalendar.removeRule(index - 1)) {
+            std::cout << "Rule not found.\n";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            return;
+        }
+        std::cout << "Rule removed.\n";
+        saveRates();
+        return;
+    }
+    if (choice != 1) return;
+
+    int kindChoice, typeChoice;
+    std::cout << "Rule Kind (1. Weekend, 2. Season, 3. Event): ";
+    if (!(std::cin >> kindChoice) || kindChoice < 1 || kindChoice > 3) {
+        std::cout << "Invalid rule kind.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+    std::cout << "Room Type (1. Single, 2. Double, 3. Suite, 4. Deluxe): ";
+    if (!(std::cin >> typeChoice) || typeChoice < 1 || typeChoice > 4) {
+        std::cout << "Invalid room type.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+
+    RateRule rule;
+    rule.kind = static_cast<RateRuleKind>(kindChoice - 1);
+    rule.type = static_cast<RoomType>(typeChoice - 1);
+    if (!promptDayRange(rule.fromDay, rule.toDay)) return;
+
+    std::string amount;
+    std::cout << "Nightly Surcharge (negative for a discount, e.g. 25.50): ";
+    std::cin >> amount;
+    if (!Money::parse(amount, rule.surcharge)) {
+        std::cout << "Invalid amount.\n";
+        return;
+    }
+
+    rateCalendar.addRule(rule);
+    std::cout << "Rule added. New bookings are priced with it.\n";
+    saveRates();
+}
+
+void HotelSystem::manageRoomBlocks() {
+    std::cout << "\n========== ROOM BLOCKS ==========\n";
+    if (blocks.empty()) {
+        std::cout << "No rooms are out of service.\n";
+    }
+    for (const auto& b : blocks) {
+        std::cout << "Room " << b.roomNumber << ": " << formatDay(b.fromDay) << " to "
+                  << formatDay(b.toDay) << " (exclusive)"
+                  << (b.reason.empty() ? "" : " - " + b.reason) << "\n";
+    }
+
+    int choice;
+    std::cout << "\n1. Block Rooms  2. Unblock Rooms  0. Back\nEnter choice: ";
+    if (!(std::cin >> choice)) {
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+    if (choice != 1 && choice != 2) return;
+
+    std::string line;
+    std::cout << "Room Numbers (e.g. 101 102 or 301-399): ";
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::getline(std::cin, line);
+    std::vector<int> roomNumbers = parseRoomList(line);
+    if (roomNumbers.empty()) {
+        std::cout << "No rooms given.\n";
+        return;
+    }
+
+    int fromDay, toDay;
+    if (!promptDayRange(fromDay, toDay)) return;
+
+    if (choice == 2) {
+        std::cout << unblockRooms(roomNumbers, fromDay, toDay).message << "\n";
+        return;
+    }
+
+    std::string reason;
+    std::cout << "Reason: ";
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::getline(std::cin, reason);
+    std::cout << blockRooms(roomNumbers, fromDay, toDay, reason).message << "\n";
+}
+
+void HotelSystem::makeRoomForPending() {
+    int id;
+    std::cout << "\nPending Reservation ID: ";
+    if (!(std::cin >> id)) {
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+    std::cout << makeRoomFor(id).message << "\n";
+}
+
+void HotelSystem::viewHistoryAt() {
+    int year, month, day, hour, minute;
+    std::cout << "\n========== TIME TRAVEL ==========\n";
+    std::cout << "Date and time (YYYY MM DD HH MM): ";
+    if (!(std::cin >> year >> month >> day >> hour >> minute)) {
+        std::cout << "Invalid input for date/time.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+    if (!isValidDate(year, month, day, hour) || minute < 0 || minute > 59) {
+        std::cout << "Invalid date. Please enter a valid date.\n";
+        return;
+    }
+
+    // Through the end of that minute
+    time_t when = createDateTime(year, month, day, hour, minute) + 59;
+    auto start = std::chrono::steady_clock::now();
+    HistoryState state;
+    if (!historyAt(when, state)) {
+        std::cout << "The history starts after that time.\n";
+        return;
+    }
+    double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    int byStatus[5] = {0, 0, 0, 0, 0};
+    for (const auto& r : state.reservations) ++byStatus[static_cast<int>(r.getStatus())];
+    time_t at = static_cast<time_t>(state.atMicros / 1000000);
+    std::cout << "As of event #" << state.sequence << " ("
+              << std::put_time(std::localtime(&at), "%Y-%m-%d %H:%M:%S") << ")\n";
+    std::cout << "Rebuilt from snapshot #" << state.snapshotSequence << " and " << state.eventsReplayed
+              << " event(s) in " << std::fixed << std::setprecision(2) << millis << " ms\n";
+    std::cout << "Customers: " << state.customers.size() << "\n";
+    std::cout << "Reservations: " << state.reservations.size() << " (" << byStatus[0] << " pending, "
+              << byStatus[1] << " confirmed, " << byStatus[2] << " checked in, " << byStatus[3]
+              << " checked out, " << byStatus[4] << " cancelled)\n";
+
+    int id;
+    std::cout << "Reservation ID to show (0 for all): ";
+    if (!(std::cin >> id)) {
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+    ReportBuffer out(std::cout);
+    bool shown = false;
+    for (const auto& r : state.reservations) {
+        if (id != 0 && r.getId() != id) continue;
+        out << "---\n";
+        r.render(out);
+        shown = true;
+    }
+    if (!shown) out << "No such reservation at that time.\n";
+}
+
+void HotelSystem::runWhatIf() {
+    std::cout << "\n========== WHAT-IF SIMULATION ==========\n";
+    std::cout << "Nothing here changes the live hotel or its files.\n";
+    std::cout << "Report occupancy and revenue over:";
+    int fromDay, toDay;
+    if (!promptDayRange(fromDay, toDay)) return;
+
+    long long extra;
+    std::string amount, line;
+    std::cout << "Extra bookings to simulate in that range (0 for none): ";
+    if (!(std::cin >> extra) || extra < 0) {
+        std::cout << "Invalid input. Please enter a number.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
+    }
+    Money surcharge;
+    std::cout << "Nightly surcharge to try on every room type (e.g. 20.00, 0 to skip): ";
+    std::cin >> amount;
+    if (!Money::parse(amount, surcharge)) {
+        std::cout << "Invalid amount.\n";
+        return;
+    }
+    std::cout << "Rooms to take out of service (e.g. 301-399, blank to skip): ";
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::getline(std::cin, line);
+    std::vector<int> closed = parseRoomList(line);
+
+    std::vector<WhatIfScenario> scenarios(1);
+    scenarios[0].name = "Current";
+    WhatIfScenario s;
+    s.name = "Reschedule by check-in";
+    s.reschedule = WhatIfReschedule::CHECK_IN_ORDER;
+    scenarios.push_back(s);
+    s.name = "Reschedule by check-in, best-fit";
+    s.overridePolicy = true;
+    s.policy = AssignmentPolicy::BEST_FIT;
+    scenarios.push_back(s);
+    s = WhatIfScenario();
+    s.name = "Reschedule for revenue";
+    s.reschedule = WhatIfReschedule::MAX_REVENUE;
+    scenarios.push_back(s);
+    if (extra > 0) {
+        s = WhatIfScenario();
+        s.name = "+" + std::to_string(extra) + " bookings";
+        s.extraBookings = static_cast<size_t>(extra);
+        s.demandFromDay = fromDay;
+        s.demandToDay = toDay;
+        scenarios.push_back(s);
+        s.name += ", best-fit";
+        s.overridePolicy = true;
+        s.policy = AssignmentPolicy::BEST_FIT;
+        scenarios.push_back(s);
+    }
+    if (surcharge != Money()) {
+        s = WhatIfScenario();
+        s.name = "Surcharge " + surcharge.toString() + ", repriced";
+        for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+            RateRule rule;
+            rule.kind = RateRuleKind::SEASON;
+            rule.type = static_cast<RoomType>(t);
+            rule.fromDay = fromDay;
+            rule.toDay = toDay;
+            rule.surcharge = surcharge;
+            s.addRates.push_back(rule);
+        }
+        s.reschedule = WhatIfReschedule::CHECK_IN_ORDER;
+        scenarios.push_back(s);
+    }
+    if (!closed.empty()) {
+        s = WhatIfScenario();
+        s.name = "Without " + std::to_string(closed.size()) + " room(s)";
+        s.removeRooms = closed;
+        scenarios.push_back(s);
+    }
+
+    WhatIfSimulator simulator(fork(), fromDay, toDay);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<WhatIfOutcome> outcomes = simulator.run(scenarios);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n";
+    WhatIfSimulator::printComparison(outcomes[0], std::vector<WhatIfOutcome>(outcomes.begin() + 1, outcomes.end()),
+                                     std::cout);
+    std::cout << std::defaultfloat << std::setprecision(3) << "\n" << scenarios.size()
+              << " scenarios in " << seconds << " s\n";
 }
 
 void HotelSystem::createBackup() {
     std::cout << "\nCreating backup...\n";
+    // Copy what the writer has put on disk, including every queued change
+    if (!persistence->flush()) {
+        std::cout << "Warning: some changes could not be written and are missing from the backup.\n";
+    }
     
     std::ifstream src1(customersFile, std::ios::binary);
-    std::ofstream dst1("customers_backup.json", std::ios::binary);
+    std::ofstream dst1(dataPath("customers_backup.json"), std::ios::binary);
     if (src1 && dst1) dst1 << src1.rdbuf();
     
     std::ifstream src2(reservationsFile, std::ios::binary);
-    std::ofstream dst2("reservations_backup.json", std::ios::binary);
+    std::ofstream dst2(dataPath("reservations_backup.json"), std::ios::binary);
     if (src2 && dst2) dst2 << src2.rdbuf();
     
     std::ifstream src3(roomsFile, std::ios::binary);
-    std::ofstream dst3("rooms_backup.json", std::ios::binary);
+    std::ofstream dst3(dataPath("rooms_backup.json"), std::ios::binary);
     if (src3 && dst3) dst3 << src3.rdbuf();
+
+    std::ifstream src4(ratesFile, std::ios::binary);
+    std::ofstream dst4(dataPath("rates_backup.json"), std::ios::binary);
+    if (src4 && dst4) dst4 << src4.rdbuf();
+
+    std::ifstream src5(blocksFile, std::ios::binary);
+    std::ofstream dst5(dataPath("blocks_backup.json"), std::ios::binary);
+    if (src5 && dst5) dst5 << src5.rdbuf();
     
     std::cout << "Backup created successfully!\n";
 }
 
 void HotelSystem::restoreBackup() {
     std::cout << "\nRestoring from backup...\n";
-    
-    std::ifstream src1("customers_backup.json", std::ios::binary);
-    std::ofstream dst1(customersFile, std::ios::binary);
-    if (src1 && dst1) dst1 << src1.rdbuf();
-    
-    std::ifstream src2("reservations_backup.json", std::ios::binary);
-    std::ofstream dst2(reservationsFile, std::ios::binary);
-    if (src2 && dst2) dst2 << src2.rdbuf();
-    
-    std::ifstream src3("rooms_backup.json", std::ios::binary);
-    std::ofstream dst3(roomsFile, std::ios::binary);
-    if (src3 && dst3) dst3 << src3.rdbuf();
-    
-    loadData();
+    // Nothing queued may land on top of the restored files
+    persistence->flush();
+    {
+        std::ifstream src1(dataPath("customers_backup.json"), std::ios::binary);
+        std::ofstream dst1(customersFile, std::ios::binary);
+        if (src1 && dst1) dst1 << src1.rdbuf();
+
+        std::ifstream src2(dataPath("reservations_backup.json"), std::ios::binary);
+        std::ofstream dst2(reservationsFile, std::ios::binary);
+        if (src2 && dst2) dst2 << src2.rdbuf();
+
+        std::ifstream src3(dataPath("rooms_backup.json"), std::ios::binary);
+        std::ofstream dst3(roomsFile, std::ios::binary);
+        if (src3 && dst3) dst3 << src3.rdbuf();
+
+        std::ifstream src4(dataPath("rates_backup.json"), std::ios::binary);
+        if (src4) {
+            std::ofstream dst4(ratesFile, std::ios::binary);
+            if (dst4) dst4 << src4.rdbuf();
+        }
+
+        std::ifstream src5(dataPath("blocks_backup.json"), std::ios::binary);
+        if (src5) {
+            std::ofstream dst5(blocksFile, std::ios::binary);
+            if (dst5) dst5 << src5.rdbuf();
+        }
+    }
+
+    {
+        TableWriteLock write(locks);
+        loadData();
+        adoptLoadedData();
+        scheduler->rebuildCalendar();
+        snapshots.markAll();
+        history->sync(customers, reservations);
+        frontDesk.rebuild(reservations);
+    }
     std::cout << "Backup restored successfully!\n";
 }
 
 void HotelSystem::rescheduleAll() {
-    std::cout << "\nRescheduling all reservations...\n";
-    
-    for (auto& room : rooms) {
-        while (!room.getReservationIds().empty()) {
-            int resId = room.getReservationIds().front();
-            room.removeReservation(resId);
-        }
-    }
-    
-    for (auto& res : reservations) {
-        if (res.getStatus() != ReservationStatus::CANCELLED &&
-            res.getStatus() != ReservationStatus::CHECKED_OUT) {
-            res.setAssignedRoomNumber(-1);
-            res.setStatus(ReservationStatus::PENDING);
-            res.setTotalCost(0.0);
-        }
+    int choice;
+    std::cout << "\nWhen rooms run short, keep:\n";
+    std::cout << "1. Earliest check-ins (any room type)\n";
+    std::cout << "2. Highest revenue per requested room type\n";
+    std::cout << "Choice: ";
+    if (!(std::cin >> choice) || (choice != 1 && choice != 2)) {
+        std::cout << "Invalid choice.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return;
     }
-    
-    scheduler->scheduleReservations();
-    
+    std::cout << "\nRescheduling all reservations...\n";
+    std::cout << reschedule(choice == 2).message << "\n";
     std::cout << "Rescheduling complete!\n";
-    saveReservations();
-    saveRooms();
 }
 
 void HotelSystem::run() {
@@ -843,7 +2319,17 @@ void HotelSystem::run() {
                 case 2: createBackup(); break;
                 case 3: restoreBackup(); break;
                 case 4: rescheduleAll(); break;
-                case 5: adminLogout(); break;
+                case 5: viewOccupancySeries(); break;
+                case 6: viewRevenueReport(); break;
+                case 7: manageRateCalendar(); break;
+                case 8: runInvoiceBatch(); break;
+                case 9: viewPersistenceStats(); break;
+                case 10: viewMetrics(); break;
+                case 11: manageRoomBlocks(); break;
+                case 12: makeRoomForPending(); break;
+                case 13: runWhatIf(); break;
+                case 14: viewHistoryAt(); break;
+                case 0: adminLogout(); break;
                 default: std::cout << "Invalid choice.\n";
             }
         } else {
@@ -868,8 +2354,10 @@ void HotelSystem::run() {
                 case 9: checkOutReservation(); break;
                 case 10: viewRooms(); break;
                 case 11: viewRoomSchedule(); break;
-                case 12: scheduler->displaySchedule(); break;
+                case 12: Scheduler::displaySchedule(*snapshot()); break;
                 case 13: adminLogin(); break;
+                case 14: viewFrontDesk(); break;
+                case 15: searchReservations(); break;
                 case 0:
                     std::cout << "Thank you for using Smart Hotel System!\n";
                     return;
@@ -4,46 +4,112 @@
 #include "Customer.h"
 #include "Reservation.h"
 #include "Room.h"
+#include "RoomBlock.h"
 #include "Scheduler.h"
+#include "RevenueAnalytics.h"
+#include "RateCalendar.h"
+#include "InvoiceBatch.h"
+#include "HotelLocks.h"
+#include "HotelSnapshot.h"
+#include "HotelHistory.h"
+#include "FrontDeskIndex.h"
+#include "ReservationQuery.h"
+#include "PersistenceService.h"
+#include "TraceLog.h"
+#include "WhatIfSimulator.h"
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <ctime>
 
+enum class ResultCode {
+    OK,
+    NOT_FOUND,
+    INVALID_INPUT,
+    INVALID_STATE,
+    NO_AVAILABILITY,  // reservation was created but left PENDING
+    BAD_COMMAND       // scripted command could not be parsed
+};
+
+struct OperationResult {
+    ResultCode code = ResultCode::OK;
+    std::string message;
+    int id = 0;            // customer or reservation the operation created/touched
+    int roomNumber = -1;
+    Money totalCost;
+
+    bool ok() const { return code == ResultCode::OK; }
+};
 
 class HotelSystem {
 private:
     std::vector<Customer> customers;
     std::vector<Reservation> reservations;
     std::vector<Room> rooms;
+    std::vector<RoomBlock> blocks;
     std::unique_ptr<Scheduler> scheduler;
+    RevenueAnalytics analytics;
+    RateCalendar rateCalendar;
     
+    std::string dataDir;
     std::string customersFile = "customers.json";
     std::string reservationsFile = "reservations.json";
     std::string roomsFile = "rooms.json";
+    std::string ratesFile = "rates.json";
+    std::string blocksFile = "blocks.json";
     
     std::string adminUsername = "admin";
     std::string adminPassword = "admin123";
     bool isAdminLoggedIn = false;
+    bool autoSave = true;
+
+    // See HotelLocks.h. Only the non-interactive API, reports and
+    // structural admin actions lock; the menu itself is single-threaded.
+    mutable HotelLocks locks;
+    std::mutex reportMutex;              // RevenueAnalytics cache
+    mutable SnapshotStore snapshots;     // versions for lock-free readers
+    FrontDeskIndex frontDesk;            // arrivals, departures and in-house guests by day
+    // Owns the data files; saveX() hands it whole files, the API single records
+    std::unique_ptr<PersistenceService> persistence;
+    // Every customer and reservation change as an event (see HotelHistory.h)
+    std::unique_ptr<HotelHistory> history;
+    std::unique_ptr<TraceWriter> trace;  // set while a session is recorded
     
     void loadData();
-    void saveData();
     void loadCustomers();
     void loadReservations();
     void loadRooms();
+    void loadRates();
+    void loadBlocks();
     void saveCustomers();
     void saveReservations();
     void saveRooms();
+    void saveRates();
+    void saveBlocks();
+    void adoptLoadedData();
     
+    std::string dataPath(const std::string& fileName) const;
     Customer* findCustomer(int id);
     Reservation* findReservation(int id);
     Room* findRoom(int roomNumber);
+    unsigned shardMaskFor(const Reservation& r) const;
+    Reservation* lockReservation(int id, ShardLock& guard);
+    // Record a change for the next snapshot and, with autoSave, queue the
+    // changed records for disk; call with the writer's lock held
+    void markChanged(const Reservation* r, int roomNumber);
+    // Waitlisted stays the Scheduler confirmed into freed nights
+    void markPromoted(const std::vector<size_t>& promoted);
     time_t createDateTime(int year, int month, int day, int hour = 14, int minute = 0);
     void displayMenu();
     void displayAdminMenu();
+    void printReservationPages(ReservationQuery query);
+    bool promptDayRange(int& fromDay, int& toDay);
 
 public:
     HotelSystem();
+    // Reads and writes the JSON files inside dataDirectory instead of the working directory
+    explicit HotelSystem(const std::string& dataDirectory);
     ~HotelSystem();
     
     void run();
@@ -56,22 +122,108 @@ public:
     
     void createReservation();
     void viewReservations();
+    void searchReservations();
     void cancelReservation();
     void checkInReservation();
     void checkOutReservation();
     
     void viewRooms();
     void viewRoomSchedule();
+    void viewFrontDesk();
     
     void generateInvoice(int reservationId);
+    void runInvoiceBatch();
     
     bool adminLogin();
     void adminLogout();
     void viewOccupancyReport();
+    void viewOccupancySeries();
+    void viewRevenueReport();
+    void viewPersistenceStats();
+    void viewMetrics();
+    void manageRateCalendar();
+    void manageRoomBlocks();
+    void makeRoomForPending();
+    void runWhatIf();
+    void viewHistoryAt();
     void createBackup();
     void restoreBackup();
     
     void rescheduleAll();
+
+    // Non-interactive API used by scripts, the batch executor and tests of
+    // the real code path. Results carry the message the menu would print.
+    // Safe to call from several threads at once.
+    OperationResult addCustomer(const std::string& name, const std::string& email, const std::string& phone);
+    // Empty fields are left unchanged
+    OperationResult modifyCustomer(int id, const std::string& name, const std::string& email, const std::string& phone);
+    OperationResult deleteCustomer(int id);
+    OperationResult createReservation(int customerId, RoomType type, time_t checkIn, time_t checkOut);
+    // One reservation per entry of roomTypes, all for the same customer and
+    // dates. Either every room is confirmed or nothing is booked; the group
+    // is queued for disk as one change. ids receives the new reservations.
+    OperationResult createGroupReservation(int customerId, const std::vector<RoomType>& roomTypes,
+                                           time_t checkIn, time_t checkOut, std::vector<int>* ids = nullptr);
+    OperationResult cancelReservation(int id);
+    // Confirms a PENDING reservation by moving as few future stays of its
+    // room type as possible (see Scheduler::planDefragmentation)
+    OperationResult makeRoomFor(int id);
+    // Unassigns every active reservation and schedules them all again, by
+    // check-in order or, with maximizeRevenue, keeping the most valuable
+    // stays per requested room type (see Scheduler::scheduleReservationsForRevenue)
+    OperationResult reschedule(bool maximizeRevenue);
+    OperationResult checkInReservation(int id);
+    OperationResult checkOutReservation(int id);
+    std::vector<int> findAvailableRooms(RoomType type, time_t checkIn, time_t checkOut) const;
+    bool lookupReservation(int id, Reservation& out) const;
+    bool lookupCustomer(int id, Customer& out) const;
+    // The front desk's lists (see FrontDeskIndex.h), by reservation id;
+    // days are local day indices as in DateUtils.h
+    std::vector<Reservation> arrivalsOn(int day) const;
+    std::vector<Reservation> departuresOn(int day) const;
+    std::vector<Reservation> inHouse() const;
+    // One page of the reservations matching query.filter. A customer or
+    // room filter is served from that index (the smaller one when both are
+    // set), a check-in range of at most a year that excludes cancelled
+    // stays from the per-day arrival buckets; anything else scans the
+    // latest snapshot without locking. false when the cursor is malformed.
+    bool queryReservations(const ReservationQuery& query, ReservationPage& out) const;
+    // Customers and reservations as they were at when, rebuilt from the
+    // history; false when the history starts later
+    bool historyAt(time_t when, HistoryState& out) const;
+    bool lookupReservationAt(int id, time_t when, Reservation& out) const;
+    // Takes rooms out of service for the nights [fromDay, toDay) (see
+    // Scheduler::blockRooms); unblock lifts the blocks overlapping the range
+    OperationResult blockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay,
+                               const std::string& reason);
+    OperationResult unblockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay);
+    // "101 102", "101,102" or ranges such as "301-399" (the existing rooms in it)
+    std::vector<int> parseRoomList(const std::string& text) const;
+    // Rooms of that type, blocked or not
+    size_t roomCount(RoomType type) const;
+
+    // Records every API call from now on (see TraceLog.h) until
+    // stopRecording or destruction. Start and stop while no other thread
+    // is using the hotel.
+    bool startRecording(const std::string& path);
+    void stopRecording();
+
+    // Latest consistent version of reservations and rooms. Holding it
+    // blocks nobody; publishing a new version copies only what changed.
+    std::shared_ptr<const HotelSnapshot> snapshot() const;
+    // Current tables, blocks, rates and policy for what-if runs (see
+    // WhatIfSimulator.h). Costs one snapshot publish at most.
+    HotelFork fork() const;
+
+    // Room choice for new bookings and reschedules (first-fit by default)
+    void setAssignmentPolicy(AssignmentPolicy policy);
+
+    // With autoSave off, mutations stay in memory until saveData()
+    void setAutoSave(bool enabled) { autoSave = enabled; }
+    // Queues every file and returns once the writer has put them on disk;
+    // false when some file could not be written
+    bool saveData();
+    PersistenceStats getPersistenceStats() const;
 };
 
 #endif
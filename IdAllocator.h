@@ -0,0 +1,52 @@
+#ifndef ID_ALLOCATOR_H
+#define ID_ALLOCATOR_H
+
+#include <atomic>
+
+// Lock-free id source shared by all threads. Each thread reserves a block
+// of ids with one fetch_add and hands them out locally, so concurrent
+// creators never contend on the counter. Ids stay unique but are no longer
+// gap-free when several threads allocate.
+//
+// Loaded tables set the counter with reset(), which bumps the epoch so
+// every cached block is dropped. Records built with an explicit id (history
+// states, what-if forks, simulations) leave the counter alone. Tag gives
+// each id space its own thread-local cache.
+template <typename Tag>
+class IdAllocator {
+private:
+    static const int BLOCK_SIZE = 64;
+
+    struct Block {
+        int next = 0;
+        int end = 0;
+        unsigned epoch = 0;
+    };
+
+    std::atomic<int> counter{1};
+    std::atomic<unsigned> epoch{0};
+
+    static Block& localBlock() {
+        thread_local Block block;
+        return block;
+    }
+
+public:
+    int allocate() {
+        Block& block = localBlock();
+        unsigned current = epoch.load(std::memory_order_acquire);
+        if (block.next == block.end || block.epoch != current) {
+            block.next = counter.fetch_add(BLOCK_SIZE, std::memory_order_relaxed);
+            block.end = block.next + BLOCK_SIZE;
+            block.epoch = current;
+        }
+        return block.next++;
+    }
+
+    void reset(int nextId) {
+        counter.store(nextId, std::memory_order_relaxed);
+        epoch.fetch_add(1, std::memory_order_release);
+    }
+};
+
+#endif
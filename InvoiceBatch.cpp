@@ -0,0 +1,170 @@
+#include "InvoiceBatch.h"
+#include "DateUtils.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+InvoiceBatch::InvoiceBatch(const std::vector<Reservation>& reservationsRef,
+                           const std::vector<Customer>& customers,
+                           const std::vector<Room>& rooms)
+    : reservations(reservationsRef) {
+    for (const auto& c : customers) customersById[c.getId()] = &c;
+    for (const auto& r : rooms) roomsByNumber[r.getRoomNumber()] = &r;
+    for (const auto& r : reservations) reservationsById[r.getId()] = &r;
+}
+
+void InvoiceBatch::render(ReportBuffer& out, const Reservation& r, const Customer* c, const Room* room) {
+    int nights = r.getDuration();
+    Money tax = r.getTotalCost().percent(10);
+    Money total = r.getTotalCost() + tax;
+    const char* none = "N/A";
+
+    out << "\n"
+        << "          SMART HOTEL - INVOICE                 \n"
+        << "Invoice for Reservation #" << r.getId() << "\n"
+        << "Date: ";
+    out.date(r.getCheckOutTime());
+    out << "\n\n";
+
+    out << "Customer Details:\n";
+    out << "  Name: ";
+    if (c) out << c->getName(); else out << none;
+    out << "\n  Email: ";
+    if (c) out << c->getEmail(); else out << none;
+    out << "\n  Phone: ";
+    if (c) out << c->getPhone(); else out << none;
+    out << "\n\n";
+
+    out << "Stay Details:\n";
+    out << "  Room Number: " << r.getAssignedRoomNumber() << "\n";
+    out << "  Room Type: ";
+    if (room) out << room->getTypeString(); else out << none;
+    out << "\n  Check-in: ";
+    out.dateTime(r.getCheckInTime());
+    out << "\n  Check-out: ";
+    out.dateTime(r.getCheckOutTime());
+    out << "\n  Duration: " << nights << " night(s)\n\n";
+
+    // The subtotal is the rate calendar's quote; whatever its weekend,
+    // season and event rules add or take off gets a line of its own
+    Money rate = room ? room->getPricePerNight() : Money();
+    Money adjustment = r.getTotalCost() - rate * nights;
+    out << "Charges:\n";
+    out << "  Room Rate: $" << rate << " per night\n";
+    out << "  Number of Nights: " << nights << "\n";
+    if (adjustment > Money()) out << "  Rate Surcharges: $" << adjustment << "\n";
+    if (adjustment < Money()) out << "  Rate Discounts: -$" << Money() - adjustment << "\n";
+    out << "  Subtotal: $" << r.getTotalCost() << "\n";
+    out << "  Tax (10%): $" << tax << "\n";
+    out << "  TOTAL: $" << total << "\n\n";
+
+    out << "Thank you for staying with us!\n";
+}
+
+std::vector<int> InvoiceBatch::selectByCheckOut(int fromDay, int toDay) const {
+    std::vector<int> ids;
+    for (const auto& r : reservations) {
+        if (r.getStatus() != ReservationStatus::CHECKED_OUT) continue;
+        int day = toDayIndex(r.getCheckOutTime());
+        if (day >= fromDay && day < toDay) ids.push_back(r.getId());
+    }
+    return ids;
+}
+
+InvoiceBatchResult InvoiceBatch::run(const std::vector<int>& reservationIds,
+                                     const std::string& outputDir,
+                                     unsigned threadCount) const {
+    InvoiceBatchResult result;
+    result.invoicesWritten = 0;
+    result.bytesWritten = 0;
+    result.seconds = 0.0;
+    result.invoicesPerSecond = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::error_code ec;
+    std::filesystem::create_directories(outputDir, ec);
+    if (ec) {
+        result.failedIds = reservationIds;
+        return result;
+    }
+
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, reservationIds.size()));
+
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> written(0);
+    std::atomic<size_t> bytes(0);
+    std::mutex failedMutex;
+
+    // Workers pull small runs of ids so uneven invoice sizes balance out
+    const size_t runLength = 16;
+    auto worker = [&]() {
+        // Kept across invoices, so its capacity and day cache are reused
+        ReportBuffer buffer;
+        std::vector<int> failed;
+        while (true) {
+            size_t begin = next.fetch_add(runLength);
+            if (begin >= reservationIds.size()) break;
+            size_t end = std::min(reservationIds.size(), begin + runLength);
+
+            for (size_t i = begin; i < end; ++i) {
+                int id = reservationIds[i];
+                auto resIt = reservationsById.find(id);
+                if (resIt == reservationsById.end()) {
+                    failed.push_back(id);
+                    continue;
+                }
+                const Reservation& r = *resIt->second;
+                auto custIt = customersById.find(r.getCustomerId());
+                auto roomIt = roomsByNumber.find(r.getAssignedRoomNumber());
+                buffer.clear();
+                render(buffer, r,
+                       custIt != customersById.end() ? custIt->second : nullptr,
+                       roomIt != roomsByNumber.end() ? roomIt->second : nullptr);
+                const std::string& text = buffer.text();
+
+                std::string path = outputDir + "/invoice_" + std::to_string(id) + ".txt";
+                std::FILE* file = std::fopen(path.c_str(), "wb");
+                if (!file) {
+                    failed.push_back(id);
+                    continue;
+                }
+                // Whole invoice in one unbuffered write
+                std::setvbuf(file, nullptr, _IONBF, 0);
+                size_t n = std::fwrite(text.data(), 1, text.size(), file);
+                std::fclose(file);
+                if (n != text.size()) {
+                    failed.push_back(id);
+                    continue;
+                }
+                written.fetch_add(1, std::memory_order_relaxed);
+                bytes.fetch_add(n, std::memory_order_relaxed);
+            }
+        }
+        if (!failed.empty()) {
+            std::lock_guard<std::mutex> lock(failedMutex);
+            result.failedIds.insert(result.failedIds.end(), failed.begin(), failed.end());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    if (threadCount > 0) worker();
+    for (auto& t : threads) t.join();
+
+    std::sort(result.failedIds.begin(), result.failedIds.end());
+    result.invoicesWritten = written.load();
+    result.bytesWritten = bytes.load();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result.seconds > 0.0) {
+        result.invoicesPerSecond = result.invoicesWritten / result.seconds;
+    }
+    return result;
+}
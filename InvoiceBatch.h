@@ -0,0 +1,48 @@
+#ifndef INVOICE_BATCH_H
+#define INVOICE_BATCH_H
+
+#include "Customer.h"
+#include "ReportBuffer.h"
+#include "Reservation.h"
+#include "Room.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+struct InvoiceBatchResult {
+    size_t invoicesWritten;
+    size_t bytesWritten;
+    double seconds;
+    double invoicesPerSecond;
+    std::vector<int> failedIds;  // unknown reservations or files that could not be written
+};
+
+// Month-end invoicing: renders many invoices on worker threads, each into
+// its thread's report buffer, and writes every file with a single
+// sequential write.
+// Customer and room lookups are hashed once per batch instead of scanned
+// per invoice.
+class InvoiceBatch {
+private:
+    const std::vector<Reservation>& reservations;
+    std::unordered_map<int, const Customer*> customersById;
+    std::unordered_map<int, const Room*> roomsByNumber;
+    std::unordered_map<int, const Reservation*> reservationsById;
+
+public:
+    InvoiceBatch(const std::vector<Reservation>& reservations,
+                 const std::vector<Customer>& customers,
+                 const std::vector<Room>& rooms);
+
+    // Appends the invoice shown at the interactive check-out
+    static void render(ReportBuffer& out, const Reservation& r, const Customer* c, const Room* room);
+
+    // Checked-out reservations whose check-out day is in [fromDay, toDay)
+    std::vector<int> selectByCheckOut(int fromDay, int toDay) const;
+
+    InvoiceBatchResult run(const std::vector<int>& reservationIds,
+                           const std::string& outputDir,
+                           unsigned threadCount = 0) const;
+};
+
+#endif
@@ -0,0 +1,201 @@
+// Load generator for the reservation server (hotel_system --server PATH).
+// Each connection thread registers a customer, then issues a mix of
+// availability checks, bookings, lookups and cancellations with one
+// request in flight at a time, recording every round-trip latency.
+#include "FrameProtocol.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char* ROOM_TYPES[] = {"single", "double", "suite", "deluxe"};
+
+    struct ClientStats {
+        std::vector<double> latencies;   // microseconds
+        size_t failures = 0;
+        size_t transportErrors = 0;
+    };
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program
+                  << " --socket PATH [--connections N] [--requests N_PER_CONNECTION] [--seed N]\n";
+    }
+
+#ifdef __linux__
+    int connectTo(const std::string& path) {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool roundTrip(int fd, uint32_t requestId, const std::string& command,
+                   ResponseFrame& response, ClientStats& stats) {
+        auto start = std::chrono::steady_clock::now();
+        uint32_t replyId = 0;
+        std::string payload;
+        if (!writeFrame(fd, requestId, command) || !readFrame(fd, replyId, payload) ||
+            replyId != requestId || !decodeResponse(payload, response)) {
+            ++stats.transportErrors;
+            return false;
+        }
+        stats.latencies.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count());
+        // 0 = OK; NO_AVAILABILITY still leaves a PENDING reservation behind
+        if (response.code != 0 && response.code != 4) ++stats.failures;
+        return true;
+    }
+
+    void runClient(const std::string& path, int index, size_t requests, unsigned seed,
+                   int today, ClientStats& stats) {
+        int fd = connectTo(path);
+        if (fd < 0) {
+            ++stats.transportErrors;
+            return;
+        }
+        stats.latencies.reserve(requests + 1);
+
+        std::mt19937 rng(seed + static_cast<unsigned>(index) * 7919u);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> offset(1, 365);
+        std::uniform_int_distribution<int> length(1, 7);
+        std::uniform_int_distribution<int> type(0, 3);
+
+        uint32_t requestId = 1;
+        ResponseFrame response;
+        std::string name = "\"Load Client " + std::to_string(index) + "\"";
+        std::string email = "load" + std::to_string(index) + "@example.com";
+        if (!roundTrip(fd, requestId++, "add_customer " + name + " " + email + " 5550100000",
+                       response, stats) || response.code != 0) {
+            close(fd);
+            return;
+        }
+        int customerId = response.id;
+        std::vector<int> booked;
+
+        for (size_t i = 0; i < requests; ++i) {
+            int first = today + offset(rng);
+            int last = first + length(rng);
+            std::string dates = formatDay(first) + " " + formatDay(last);
+            const char* roomType = ROOM_TYPES[type(rng)];
+
+            // 50% availability, 30% bookings, 15% lookups, 5% cancellations
+            int roll = percent(rng);
+            std::string command;
+            if (roll >= 80 && !booked.empty()) {
+                if (roll < 95) {
+                    command = "lookup " + std::to_string(booked[static_cast<size_t>(roll) % booked.size()]);
+                } else {
+                    command = "cancel " + std::to_string(booked.back());
+                    booked.pop_back();
+                }
+            } else if (roll >= 50 && roll < 80) {
+                command = "create_reservation " + std::to_string(customerId) + " " + roomType + " " + dates;
+            } else {
+                command = std::string("availability ") + roomType + " " + dates;
+            }
+
+            if (!roundTrip(fd, requestId++, command, response, stats)) break;
+            if (command.compare(0, 18, "create_reservation") == 0 && response.id > 0) {
+                booked.push_back(response.id);
+            }
+        }
+        close(fd);
+    }
+#endif
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0.0;
+        size_t rank = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath;
+    int connections = 4;
+    size_t requests = 1000;
+    unsigned seed = 42;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            connections = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+            requests = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atol(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (socketPath.empty() || connections <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+#ifdef __linux__
+    int today = toDayIndex(std::time(nullptr));
+    std::vector<ClientStats> stats(static_cast<size_t>(connections));
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < connections; ++c) {
+        threads.emplace_back(runClient, socketPath, c, requests, seed, today,
+                             std::ref(stats[static_cast<size_t>(c)]));
+    }
+    for (auto& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    size_t failures = 0, transportErrors = 0;
+    for (const auto& s : stats) {
+        all.insert(all.end(), s.latencies.begin(), s.latencies.end());
+        failures += s.failures;
+        transportErrors += s.transportErrors;
+    }
+    std::sort(all.begin(), all.end());
+
+    std::cout << "\n========== LOAD TEST ==========\n";
+    std::cout << "Connections: " << connections << "\n";
+    std::cout << "Requests: " << all.size() << " (" << failures << " rejected, "
+              << transportErrors << " transport errors)\n";
+    std::cout << "Elapsed: " << std::fixed << std::setprecision(3) << seconds << " s\n";
+    if (seconds > 0.0) {
+        std::cout << "Throughput: " << std::setprecision(0) << all.size() / seconds << " req/sec\n";
+    }
+    std::cout << std::setprecision(1);
+    std::cout << "Latency p50: " << percentile(all, 0.50) << " us\n";
+    std::cout << "Latency p99: " << percentile(all, 0.99) << " us\n";
+    std::cout << "Latency max: " << (all.empty() ? 0.0 : all.back()) << " us\n";
+    return transportErrors == 0 ? 0 : 2;
+#else
+    std::cerr << "The load generator requires Unix domain sockets.\n";
+    return 1;
+#endif
+}
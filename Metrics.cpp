@@ -0,0 +1,180 @@
+#include "Metrics.h"
+#include <iomanip>
+
+namespace {
+    const char* const TIMER_NAMES[TIMER_COUNT] = {
+        "load_data",
+        "deserialize.customer",
+        "deserialize.reservation",
+        "deserialize.room",
+        "deserialize.rate",
+        "schedule_reservation",
+        "schedule_reservations",
+        "can_assign_to_room",
+        "save.customers",
+        "save.reservations",
+        "save.rooms",
+        "save.rates",
+        "save.blocks",
+        "file_write"
+    };
+
+    const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+        "overlap_checks",
+        "records_parsed",
+        "bytes_written"
+    };
+
+    LatencyHistogram histograms[TIMER_COUNT];
+    std::atomic<uint64_t> counters[COUNTER_COUNT];
+
+    int bucketFor(uint64_t nanos) {
+        if (nanos == 0) return 0;
+#if defined(__GNUC__)
+        int b = 63 - __builtin_clzll(nanos);
+#else
+        int b = 0;
+        while (nanos >>= 1) ++b;
+#endif
+        return b < LatencyHistogram::BUCKET_COUNT ? b : LatencyHistogram::BUCKET_COUNT - 1;
+    }
+
+#ifndef HOTEL_NO_METRICS
+    double micros(uint64_t nanos) {
+        return static_cast<double>(nanos) / 1000.0;
+    }
+#endif
+}
+
+LatencyHistogram::LatencyHistogram() {
+    for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    uint64_t seen = maxNanos.load(std::memory_order_relaxed);
+    while (nanos > seen && !maxNanos.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() {
+    for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    totalNanos.store(0, std::memory_order_relaxed);
+    maxNanos.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentileNanos(double p) const {
+    uint64_t total = getCount();
+    if (total == 0) return 0;
+    // Rank of the sample we want, 1-based
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKET_COUNT; ++b) {
+        seen += getBucket(b);
+        if (seen >= rank) {
+            uint64_t edge = (uint64_t(1) << (b + 1)) - 1;
+            // The top bucket is never wider than the largest sample
+            return edge < getMaxNanos() ? edge : getMaxNanos();
+        }
+    }
+    return getMaxNanos();
+}
+
+namespace Metrics {
+    void record(Timer timer, uint64_t nanos) {
+        histograms[static_cast<int>(timer)].record(nanos);
+    }
+
+    void add(Counter counter, uint64_t amount) {
+        counters[static_cast<int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    const LatencyHistogram& histogram(Timer timer) {
+        return histograms[static_cast<int>(timer)];
+    }
+
+    uint64_t counter(Counter counter) {
+        return counters[static_cast<int>(counter)].load(std::memory_order_relaxed);
+    }
+
+    const char* timerName(Timer timer) {
+        return TIMER_NAMES[static_cast<int>(timer)];
+    }
+
+    const char* counterName(Counter counter) {
+        return COUNTER_NAMES[static_cast<int>(counter)];
+    }
+
+    void reset() {
+        for (auto& h : histograms) h.reset();
+        for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+    }
+
+    void dumpText(std::ostream& out) {
+        out << "\n========== PERFORMANCE METRICS ==========\n";
+#ifdef HOTEL_NO_METRICS
+        out << "Metrics were compiled out (HOTEL_NO_METRICS).\n";
+#else
+        out << std::left << std::setw(26) << "Operation" << std::right
+            << std::setw(10) << "Count" << std::setw(12) << "Avg us"
+            << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+            << std::setw(12) << "Max us" << "\n";
+        out << std::fixed << std::setprecision(2);
+        for (int t = 0; t < TIMER_COUNT; ++t) {
+            const LatencyHistogram& h = histograms[t];
+            uint64_t n = h.getCount();
+            if (n == 0) continue;
+            out << std::left << std::setw(26) << TIMER_NAMES[t] << std::right
+                << std::setw(10) << n
+                << std::setw(12) << micros(h.getTotalNanos()) / static_cast<double>(n)
+                << std::setw(12) << micros(h.percentileNanos(50))
+                << std::setw(12) << micros(h.percentileNanos(99))
+                << std::setw(12) << micros(h.getMaxNanos()) << "\n";
+        }
+        out << "\n";
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            out << std::left << std::setw(26) << COUNTER_NAMES[c] << std::right
+                << std::setw(10) << counters[c].load(std::memory_order_relaxed) << "\n";
+        }
+        out << "(percentiles are bucket upper bounds: within 2x of the true value)\n";
+#endif
+    }
+
+    void dumpJson(std::ostream& out) {
+#ifdef HOTEL_NO_METRICS
+        out << "{\"enabled\":false}\n";
+#else
+        out << "{\"enabled\":true,\"timers\":{";
+        for (int t = 0; t < TIMER_COUNT; ++t) {
+            const LatencyHistogram& h = histograms[t];
+            if (t > 0) out << ",";
+            out << "\"" << TIMER_NAMES[t] << "\":{"
+                << "\"count\":" << h.getCount()
+                << ",\"total_ns\":" << h.getTotalNanos()
+                << ",\"max_ns\":" << h.getMaxNanos()
+                << ",\"p50_ns\":" << h.percentileNanos(50)
+                << ",\"p90_ns\":" << h.percentileNanos(90)
+                << ",\"p99_ns\":" << h.percentileNanos(99)
+                << ",\"log2_buckets\":[";
+            // Trailing empty buckets are left out
+            int last = LatencyHistogram::BUCKET_COUNT - 1;
+            while (last >= 0 && h.getBucket(last) == 0) --last;
+            for (int b = 0; b <= last; ++b) {
+                if (b > 0) out << ",";
+                out << h.getBucket(b);
+            }
+            out << "]}";
+        }
+        out << "},\"counters\":{";
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            if (c > 0) out << ",";
+            out << "\"" << COUNTER_NAMES[c] << "\":" << counters[c].load(std::memory_order_relaxed);
+        }
+        out << "}}\n";
+#endif
+    }
+}
@@ -0,0 +1,137 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Process-wide latency histograms and counters for the hot paths: loading,
+// parsing, scheduling and saving. Instrumented code uses HOTEL_TIME_SCOPE
+// and HOTEL_COUNT; building with -DHOTEL_NO_METRICS turns both into no-ops,
+// so nothing is timed or counted and the dumps only say so.
+
+enum class Timer {
+    LOAD_DATA,
+    DESERIALIZE_CUSTOMER,
+    DESERIALIZE_RESERVATION,
+    DESERIALIZE_ROOM,
+    DESERIALIZE_RATE,
+    SCHEDULE_RESERVATION,
+    SCHEDULE_RESERVATIONS,
+    CAN_ASSIGN_TO_ROOM,
+    SAVE_CUSTOMERS,
+    SAVE_RESERVATIONS,
+    SAVE_ROOMS,
+    SAVE_RATES,
+    SAVE_BLOCKS,
+    FILE_WRITE          // PersistenceService rewriting one data file
+};
+
+const int TIMER_COUNT = 14;
+
+enum class Counter {
+    OVERLAP_CHECKS,     // neighbouring stays compared in Scheduler::canAssignToRoom
+    RECORDS_PARSED,
+    BYTES_WRITTEN
+};
+
+const int COUNTER_COUNT = 3;
+
+// Bucket b counts samples in [2^b, 2^(b+1)) nanoseconds. Recording is a
+// handful of relaxed atomic adds, so any thread may record at any time.
+class LatencyHistogram {
+public:
+    static const int BUCKET_COUNT = 40;   // up to ~18 minutes
+
+private:
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalNanos{0};
+    std::atomic<uint64_t> maxNanos{0};
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanos);
+    void reset();
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t getTotalNanos() const { return totalNanos.load(std::memory_order_relaxed); }
+    uint64_t getMaxNanos() const { return maxNanos.load(std::memory_order_relaxed); }
+    uint64_t getBucket(int b) const { return buckets[b].load(std::memory_order_relaxed); }
+    // Upper edge of the bucket holding the p-th percentile (p in 0..100)
+    uint64_t percentileNanos(double p) const;
+};
+
+namespace Metrics {
+    void record(Timer timer, uint64_t nanos);
+    void add(Counter counter, uint64_t amount);
+
+    const LatencyHistogram& histogram(Timer timer);
+    uint64_t counter(Counter counter);
+    const char* timerName(Timer timer);
+    const char* counterName(Counter counter);
+
+    void reset();
+    void dumpText(std::ostream& out);
+    void dumpJson(std::ostream& out);
+
+    // Set on this thread while a MetricsPause is alive
+    inline bool& pausedOnThread() {
+        thread_local bool paused = false;
+        return paused;
+    }
+}
+
+// Nothing is timed or counted on this thread while a pause is alive.
+// Simulation trials run the scheduler millions of times; recording them
+// would bury the live numbers and make every trial thread hit the shared
+// atomics.
+class MetricsPause {
+private:
+    bool wasPaused;
+
+public:
+    MetricsPause() : wasPaused(Metrics::pausedOnThread()) { Metrics::pausedOnThread() = true; }
+    ~MetricsPause() { Metrics::pausedOnThread() = wasPaused; }
+
+    MetricsPause(const MetricsPause&) = delete;
+    MetricsPause& operator=(const MetricsPause&) = delete;
+};
+
+class ScopedTimer {
+private:
+    Timer timer;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Timer t) : timer(t), active(!Metrics::pausedOnThread()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+    ~ScopedTimer() {
+        if (!active) return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        Metrics::record(timer, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#define HOTEL_METRICS_JOIN2(a, b) a##b
+#define HOTEL_METRICS_JOIN(a, b) HOTEL_METRICS_JOIN2(a, b)
+
+#ifdef HOTEL_NO_METRICS
+#define HOTEL_TIME_SCOPE(timer) ((void)0)
+#define HOTEL_COUNT(counter, amount) ((void)(amount))
+#else
+// Times the rest of the enclosing scope
+#define HOTEL_TIME_SCOPE(timer) ScopedTimer HOTEL_METRICS_JOIN(scopedTimer_, __LINE__)(timer)
+#define HOTEL_COUNT(counter, amount) \
+    (Metrics::pausedOnThread() ? (void)0 : Metrics::add(counter, static_cast<uint64_t>(amount)))
+#endif
+
+#endif
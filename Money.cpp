@@ -0,0 +1,153 @@
+#include "Money.h"
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+Money Money::fromDouble(double amount) {
+    return Money(static_cast<int64_t>(std::llround(amount * 100.0)));
+}
+
+bool Money::parse(const std::string& text, Money& out) {
+    size_t pos = 0;
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        ++pos;
+    }
+
+    // Collect all significant digits and remember where the decimal point was
+    std::string digits;
+    int fractionDigits = 0;
+    bool seenPoint = false;
+    bool seenDigit = false;
+    for (; pos < text.size(); ++pos) {
+        char c = text[pos];
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            digits += c;
+            seenDigit = true;
+            if (seenPoint) ++fractionDigits;
+        } else if (c == '.' && !seenPoint) {
+            seenPoint = true;
+        } else {
+            break;
+        }
+    }
+    if (!seenDigit) return false;
+
+    int exponent = 0;
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        ++pos;
+        bool expNegative = false;
+        if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+            expNegative = text[pos] == '-';
+            ++pos;
+        }
+        if (pos >= text.size() || !std::isdigit(static_cast<unsigned char>(text[pos]))) return false;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            exponent = exponent * 10 + (text[pos] - '0');
+            if (exponent > 100) return false;
+            ++pos;
+        }
+        if (expNegative) exponent = -exponent;
+    }
+
+    // value = digits * 10^(exponent - fractionDigits); we want value * 100
+    int shift = exponent - fractionDigits + 2;
+    if (shift > 0) {
+        digits.append(static_cast<size_t>(shift), '0');
+        shift = 0;
+    }
+
+    size_t drop = static_cast<size_t>(-shift);
+    size_t keep = drop <= digits.size() ? digits.size() - drop : 0;
+    // The first dropped digit decides rounding; past the digits it is an implicit zero
+    bool roundUp = drop > 0 && drop <= digits.size() && digits[keep] >= '5';
+
+    int64_t value = 0;
+    size_t significant = 0;
+    for (size_t i = 0; i < keep; ++i) {
+        if (value == 0 && digits[i] == '0') continue;
+        if (++significant > 18) return false;
+        value = value * 10 + (digits[i] - '0');
+    }
+    if (roundUp) ++value;
+
+    out = Money(negative ? -value : value);
+    return true;
+}
+
+std::string Money::toString() const {
+    int64_t magnitude = cents < 0 ? -cents : cents;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%s%lld.%02lld", cents < 0 ? "-" : "",
+                  static_cast<long long>(magnitude / 100),
+                  static_cast<long long>(magnitude % 100));
+    return buf;
+}
+
+Money Money::percent(int pct) const {
+    return Money(cents * pct).dividedBy(100);
+}
+
+Money Money::dividedBy(int64_t divisor) const {
+    if (divisor == 0) return Money();
+    int64_t q = cents / divisor;
+    int64_t r = cents % divisor;
+    if (2 * std::llabs(r) >= std::llabs(divisor)) {
+        q += ((cents < 0) == (divisor < 0)) ? 1 : -1;
+    }
+    return Money(q);
+}
+
+std::ostream& operator<<(std::ostream& os, const Money& m) {
+    return os << m.toString();
+}
+
+int64_t sumCents(const int64_t* values, size_t count) {
+    size_t i = 0;
+    int64_t a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+#if defined(__AVX2__)
+    // Two 4-lane accumulators; builds without -mavx2 use the loop below,
+    // which the compiler can still vectorize with SSE2.
+    __m256i v0 = _mm256_setzero_si256();
+    __m256i v1 = _mm256_setzero_si256();
+    for (; i + 8 <= count; i += 8) {
+        v0 = _mm256_add_epi64(v0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+        v1 = _mm256_add_epi64(v1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 4)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(v0, v1));
+    a0 = lanes[0];
+    a1 = lanes[1];
+    a2 = lanes[2];
+    a3 = lanes[3];
+#endif
+    for (; i + 4 <= count; i += 4) {
+        a0 += values[i];
+        a1 += values[i + 1];
+        a2 += values[i + 2];
+        a3 += values[i + 3];
+    }
+    for (; i < count; ++i) a0 += values[i];
+    return (a0 + a1) + (a2 + a3);
+}
+
+int64_t sumCents(const Money* values, size_t count) {
+    int64_t a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        a0 += values[i].getCents();
+        a1 += values[i + 1].getCents();
+        a2 += values[i + 2].getCents();
+        a3 += values[i + 3].getCents();
+    }
+    for (; i < count; ++i) a0 += values[i].getCents();
+    return (a0 + a1) + (a2 + a3);
+}
@@ -0,0 +1,55 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <iostream>
+
+// Fixed-point amount in integer cents. Sums are exact and independent of
+// the order they are taken in, so parallel reductions are deterministic.
+class Money {
+private:
+    int64_t cents;
+
+    explicit Money(int64_t c) : cents(c) {}
+
+public:
+    Money() : cents(0) {}
+
+    static Money fromCents(int64_t c) { return Money(c); }
+    static Money fromDouble(double amount);
+
+    // Exact decimal parse ("150", "99.5", "1.23457e+06"); rounds half away
+    // from zero to the cent. Used for legacy JSON amounts written as double.
+    static bool parse(const std::string& text, Money& out);
+
+    int64_t getCents() const { return cents; }
+    double toDouble() const { return cents / 100.0; }
+    std::string toString() const;
+
+    // this * pct / 100, rounded half away from zero
+    Money percent(int pct) const;
+    // this / divisor, rounded half away from zero
+    Money dividedBy(int64_t divisor) const;
+
+    Money operator+(Money o) const { return Money(cents + o.cents); }
+    Money operator-(Money o) const { return Money(cents - o.cents); }
+    Money operator*(int64_t n) const { return Money(cents * n); }
+    Money& operator+=(Money o) { cents += o.cents; return *this; }
+    Money& operator-=(Money o) { cents -= o.cents; return *this; }
+
+    bool operator==(Money o) const { return cents == o.cents; }
+    bool operator!=(Money o) const { return cents != o.cents; }
+    bool operator<(Money o) const { return cents < o.cents; }
+    bool operator>(Money o) const { return cents > o.cents; }
+};
+
+std::ostream& operator<<(std::ostream& os, const Money& m);
+
+// Summation kernels over contiguous cent columns. Written with independent
+// accumulators so the compiler can keep them in vector registers.
+int64_t sumCents(const int64_t* values, size_t count);
+int64_t sumCents(const Money* values, size_t count);
+
+#endif
@@ -0,0 +1,198 @@
+#include "OccupancyCalendar.h"
+#include <algorithm>
+
+void OccupancyCalendar::ensureRange(TypeSeries& s, int fromDay, int toDay) {
+    // Cells are needed for fromDay .. toDay inclusive (toDay holds the closing delta)
+    if (s.nightsDelta.empty()) {
+        s.baseDay = fromDay;
+        s.nightsDelta.assign(toDay - fromDay + 1, 0);
+        s.revenueDelta.assign(toDay - fromDay + 1, 0);
+    }
+
+    bool shifted = fromDay < s.baseDay;
+    if (shifted) {
+        size_t grow = static_cast<size_t>(s.baseDay - fromDay);
+        s.nightsDelta.insert(s.nightsDelta.begin(), grow, 0);
+        s.revenueDelta.insert(s.revenueDelta.begin(), grow, 0);
+        s.baseDay = fromDay;
+    }
+
+    size_t needed = static_cast<size_t>(toDay - s.baseDay + 1);
+    if (needed > s.nightsDelta.size()) {
+        s.nightsDelta.resize(needed, 0);
+        s.revenueDelta.resize(needed, 0);
+    }
+
+    // Blocks are counted from baseDay, so moving it regroups every cell;
+    // that is O(days) like the insert above
+    size_t blocks = (s.nightsDelta.size() + BLOCK_DAYS - 1) / BLOCK_DAYS;
+    if (shifted) {
+        s.nightsBlock.assign(blocks, 0);
+        s.revenueBlock.assign(blocks, 0);
+        for (size_t i = 0; i < s.nightsDelta.size(); ++i) {
+            s.nightsBlock[i / BLOCK_DAYS] += s.nightsDelta[i];
+            s.revenueBlock[i / BLOCK_DAYS] += s.revenueDelta[i];
+        }
+    } else if (blocks > s.nightsBlock.size()) {
+        s.nightsBlock.resize(blocks, 0);
+        s.revenueBlock.resize(blocks, 0);
+    }
+}
+
+void OccupancyCalendar::addDelta(TypeSeries& s, size_t cell, int nights, int64_t cents) {
+    s.nightsDelta[cell] += nights;
+    s.revenueDelta[cell] += cents;
+    s.nightsBlock[cell / BLOCK_DAYS] += nights;
+    s.revenueBlock[cell / BLOCK_DAYS] += cents;
+}
+
+void OccupancyCalendar::applyStay(RoomType type, int fromDay, int toDay, Money revenue, int sign) {
+    if (toDay <= fromDay) return;
+
+    TypeSeries& s = series[static_cast<int>(type)];
+    ensureRange(s, fromDay, toDay);
+
+    int nights = toDay - fromDay;
+    int64_t perNight = revenue.getCents() / nights;
+    int64_t remainder = revenue.getCents() % nights;
+    size_t first = static_cast<size_t>(fromDay - s.baseDay);
+    size_t last = static_cast<size_t>(toDay - s.baseDay);
+
+    addDelta(s, first, sign, sign * (perNight + remainder));
+    addDelta(s, first + 1, 0, -sign * remainder);
+    addDelta(s, last, -sign, -sign * perNight);
+
+    if (s.dirtyFrom == s.dirtyTo) {
+        s.dirtyFrom = fromDay;
+        s.dirtyTo = toDay;
+    } else {
+        s.dirtyFrom = std::min(s.dirtyFrom, fromDay);
+        s.dirtyTo = std::max(s.dirtyTo, toDay);
+    }
+}
+
+void OccupancyCalendar::addStay(RoomType type, int fromDay, int toDay, Money revenue) {
+    applyStay(type, fromDay, toDay, revenue, +1);
+}
+
+void OccupancyCalendar::removeStay(RoomType type, int fromDay, int toDay, Money revenue) {
+    applyStay(type, fromDay, toDay, revenue, -1);
+}
+
+void OccupancyCalendar::clear() {
+    for (auto& s : series) {
+        s.baseDay = 0;
+        s.nightsDelta.clear();
+        s.revenueDelta.clear();
+        s.nightsBlock.clear();
+        s.revenueBlock.clear();
+        s.dirtyFrom = s.dirtyTo = 0;
+        s.reset = true;
+    }
+}
+
+int OccupancyCalendar::firstDay(RoomType type) const {
+    return series[static_cast<int>(type)].baseDay;
+}
+
+int OccupancyCalendar::endDay(RoomType type) const {
+    const TypeSeries& s = series[static_cast<int>(type)];
+    return s.baseDay + static_cast<int>(s.nightsDelta.size());
+}
+
+void OccupancyCalendar::deltasAt(RoomType type, int day, int& nights, int64_t& revenueCents) const {
+    const TypeSeries& s = series[static_cast<int>(type)];
+    nights = 0;
+    revenueCents = 0;
+    if (day < s.baseDay || day >= s.baseDay + static_cast<int>(s.nightsDelta.size())) return;
+    size_t i = static_cast<size_t>(day - s.baseDay);
+    nights = s.nightsDelta[i];
+    revenueCents = s.revenueDelta[i];
+}
+
+bool OccupancyCalendar::takeDirtyRange(RoomType type, int& fromDay, int& toDay, bool& wasReset) {
+    TypeSeries& s = series[static_cast<int>(type)];
+    wasReset = s.reset;
+    fromDay = s.dirtyFrom;
+    toDay = s.dirtyTo;
+    bool changed = s.reset || s.dirtyFrom != s.dirtyTo;
+    s.dirtyFrom = s.dirtyTo = 0;
+    s.reset = false;
+    return changed;
+}
+
+OccupancyReport OccupancyCalendar::report(int fromDay, int toDay,
+                                          const int roomCounts[ROOM_TYPE_COUNT],
+                                          const bool includeType[ROOM_TYPE_COUNT]) const {
+    OccupancyReport rep;
+    rep.fromDay = fromDay;
+    rep.toDay = toDay;
+    rep.totalRoomNightsSold = 0;
+    rep.totalRoomNightsAvailable = 0;
+    rep.totalRevenue = Money();
+    rep.occupancyRate = 0.0;
+
+    if (toDay <= fromDay) return rep;
+
+    int available = 0;
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        if (includeType[t]) available += roomCounts[t];
+    }
+
+    rep.days.resize(static_cast<size_t>(toDay - fromDay));
+    for (int d = fromDay; d < toDay; ++d) {
+        DailyOccupancy& day = rep.days[static_cast<size_t>(d - fromDay)];
+        day.day = d;
+        day.roomsAvailable = available;
+        day.roomNightsSold = 0;
+        day.occupancyRate = 0.0;
+        day.revenue = Money();
+    }
+
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        if (!includeType[t]) continue;
+        const TypeSeries& s = series[t];
+        if (s.nightsDelta.empty()) continue;
+
+        int start = std::max(fromDay, s.baseDay);
+        int end = std::min(toDay, s.baseDay + static_cast<int>(s.nightsDelta.size()));
+        if (start >= end) continue;
+
+        // Prefix sums up to start: whole blocks, then the cells before
+        // start in its block, then one pass over the range
+        size_t first = static_cast<size_t>(start - s.baseDay);
+        size_t block = first / BLOCK_DAYS;
+        int nights = 0;
+        int64_t revenue = 0;
+        for (size_t b = 0; b < block; ++b) {
+            nights += s.nightsBlock[b];
+            revenue += s.revenueBlock[b];
+        }
+        for (size_t i = block * BLOCK_DAYS; i < first; ++i) {
+            nights += s.nightsDelta[i];
+            revenue += s.revenueDelta[i];
+        }
+        for (int d = start; d < end; ++d) {
+            size_t i = static_cast<size_t>(d - s.baseDay);
+            nights += s.nightsDelta[i];
+            revenue += s.revenueDelta[i];
+
+            DailyOccupancy& day = rep.days[static_cast<size_t>(d - fromDay)];
+            day.roomNightsSold += nights;
+            day.revenue += Money::fromCents(revenue);
+        }
+    }
+
+    for (auto& day : rep.days) {
+        if (day.roomsAvailable > 0) {
+            day.occupancyRate = 100.0 * day.roomNightsSold / day.roomsAvailable;
+        }
+        rep.totalRoomNightsSold += day.roomNightsSold;
+        rep.totalRoomNightsAvailable += day.roomsAvailable;
+        rep.totalRevenue += day.revenue;
+    }
+    if (rep.totalRoomNightsAvailable > 0) {
+        rep.occupancyRate = 100.0 * rep.totalRoomNightsSold / rep.totalRoomNightsAvailable;
+    }
+    return rep;
+}
@@ -0,0 +1,79 @@
+#ifndef OCCUPANCY_CALENDAR_H
+#define OCCUPANCY_CALENDAR_H
+
+#include "Room.h"
+#include "Money.h"
+#include <vector>
+#include <cstdint>
+
+struct DailyOccupancy {
+    int day;               // day index, see DateUtils.h
+    int roomsAvailable;
+    int roomNightsSold;
+    double occupancyRate;  // percent
+    Money revenue;
+};
+
+struct OccupancyReport {
+    int fromDay;
+    int toDay;
+    std::vector<DailyOccupancy> days;
+    int totalRoomNightsSold;
+    int totalRoomNightsAvailable;
+    Money totalRevenue;
+    double occupancyRate;  // percent over the whole range
+};
+
+// Difference-array calendar of sold room-nights and revenue per RoomType.
+// A stay touches only two cells per series, so bookings and cancellations
+// update it in O(1) (amortized). The deltas are also totalled per block of
+// BLOCK_DAYS days, so a report adds up the blocks before its first day and
+// then makes one prefix-sum pass over the requested days, regardless of
+// how many reservations exist. Only the block sum grows with the days of
+// history, at 1/BLOCK_DAYS of a walk over them.
+class OccupancyCalendar {
+private:
+    static const int BLOCK_DAYS = 64;
+
+    struct TypeSeries {
+        int baseDay = 0;
+        std::vector<int> nightsDelta;
+        std::vector<int64_t> revenueDelta;  // cents
+        std::vector<int> nightsBlock;       // delta totals per BLOCK_DAYS cells
+        std::vector<int64_t> revenueBlock;
+        // Days whose nightly totals changed since the last takeDirtyRange
+        int dirtyFrom = 0;
+        int dirtyTo = 0;
+        bool reset = false;
+    };
+
+    TypeSeries series[ROOM_TYPE_COUNT];
+
+    void ensureRange(TypeSeries& s, int fromDay, int toDay);
+    static void addDelta(TypeSeries& s, size_t cell, int nights, int64_t cents);
+    void applyStay(RoomType type, int fromDay, int toDay, Money revenue, int sign);
+
+public:
+    // Revenue is spread evenly over the nights; leftover cents go to the
+    // first night so the nightly amounts always add up to the stay total.
+    void addStay(RoomType type, int fromDay, int toDay, Money revenue);
+    void removeStay(RoomType type, int fromDay, int toDay, Money revenue);
+    void clear();
+
+    // Raw access for incremental consumers (see RevenueAnalytics rollup)
+    int firstDay(RoomType type) const;
+    int endDay(RoomType type) const;
+    void deltasAt(RoomType type, int day, int& nights, int64_t& revenueCents) const;
+
+    // Returns false when nothing changed. wasReset is set when the series
+    // was cleared since the last call and must be re-read completely.
+    bool takeDirtyRange(RoomType type, int& fromDay, int& toDay, bool& wasReset);
+
+    // roomCounts[t] is the number of rooms of type t; only types with
+    // includeType[t] set contribute to the report.
+    OccupancyReport report(int fromDay, int toDay,
+                           const int roomCounts[ROOM_TYPE_COUNT],
+                           const bool includeType[ROOM_TYPE_COUNT]) const;
+};
+
+#endif
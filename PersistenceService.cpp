@@ -0,0 +1,281 @@
+#include "PersistenceService.h"
+#include "Metrics.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+PersistenceService::PersistenceService(const std::string filePaths[DATA_FILE_COUNT],
+                                       std::chrono::milliseconds window)
+    : coalesceWindow(window) {
+    for (int f = 0; f < DATA_FILE_COUNT; ++f) paths[f] = filePaths[f];
+    writer = std::thread(&PersistenceService::writerLoop, this);
+}
+
+PersistenceService::~PersistenceService() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    writer.join();
+}
+
+void PersistenceService::push(Node* node) {
+    // Counted before it is published: once the writer can see the node it
+    // may add it to `written`, which must never pass `enqueued`
+    uint64_t total = enqueued.fetch_add(1, std::memory_order_acq_rel) + 1;
+    size_t depth = static_cast<size_t>(total - written.load(std::memory_order_acquire));
+    size_t seen = maxDepth.load(std::memory_order_relaxed);
+    while (depth > seen && !maxDepth.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {}
+
+    // Treiber push: producers never block each other or the writer
+    node->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(node->next, node,
+                                       std::memory_order_release, std::memory_order_relaxed)) {}
+
+    // Only the push that makes the list non-empty has to wake the writer
+    if (node->next == nullptr) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeUp.notify_one();
+    }
+}
+
+void PersistenceService::upsert(DataFile file, int key, std::string line) {
+    push(new Node{DeltaKind::UPSERT, file, key, std::move(line), {}, nullptr});
+}
+
+void PersistenceService::upsertMany(DataFile file, std::vector<std::pair<int, std::string>> records) {
+    push(new Node{DeltaKind::UPSERT_MANY, file, 0, std::string(), std::move(records), nullptr});
+}
+
+void PersistenceService::erase(DataFile file, int key) {
+    push(new Node{DeltaKind::ERASE, file, key, std::string(), {}, nullptr});
+}
+
+void PersistenceService::replace(DataFile file, std::vector<std::pair<int, std::string>> records) {
+    push(new Node{DeltaKind::REPLACE, file, 0, std::string(), std::move(records), nullptr});
+}
+
+void PersistenceService::adopt(DataFile file, std::vector<std::pair<int, std::string>> records) {
+    push(new Node{DeltaKind::ADOPT, file, 0, std::string(), std::move(records), nullptr});
+}
+
+bool PersistenceService::flush() {
+    uint64_t target = enqueued.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    if (written.load(std::memory_order_acquire) >= target && unwrittenFiles == 0) return true;
+    // A pass is needed either way: for the queued changes, or to retry the
+    // files that could not be written
+    uint64_t pass = passes;
+    flushRequested = true;
+    wakeUp.notify_one();
+    flushed.wait(lock, [&]() { return written.load(std::memory_order_acquire) >= target && passes > pass; });
+    return unwrittenFiles == 0;
+}
+
+void PersistenceService::writerLoop() {
+    while (true) {
+        bool lastPass;
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            auto ready = [&]() {
+                return stopping || flushRequested || head.load(std::memory_order_acquire) != nullptr;
+            };
+            // Files that failed to write are retried even when nothing new arrives
+            if (unwrittenFiles > 0) {
+                wakeUp.wait_for(lock, RETRY_INTERVAL, ready);
+            } else {
+                wakeUp.wait(lock, ready);
+            }
+            // Let a burst of changes pile up unless somebody is waiting on us
+            if (!stopping && !flushRequested) {
+                wakeUp.wait_for(lock, coalesceWindow, [&]() { return stopping || flushRequested; });
+            }
+            flushRequested = false;
+            lastPass = stopping && head.load(std::memory_order_acquire) == nullptr;
+            if (lastPass && unwrittenFiles == 0) break;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Node* list = head.exchange(nullptr, std::memory_order_acquire);
+        std::unordered_set<uint64_t> touched;
+        size_t changes = 0;
+        size_t deltas = applyBatch(list, touched, changes);
+        size_t coalesced = changes > touched.size() ? changes - touched.size() : 0;
+
+        size_t unwritten = 0;
+        for (int f = 0; f < DATA_FILE_COUNT; ++f) {
+            if (images[f].dirty && !writeFile(f)) ++unwritten;
+        }
+        double millis = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        recordPass(coalesced, millis);
+
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            written.fetch_add(deltas, std::memory_order_release);
+            unwrittenFiles = unwritten;
+            ++passes;
+        }
+        flushed.notify_all();
+        // Shutting down: one more try for files that failed, then give up
+        if (lastPass) break;
+    }
+}
+
+size_t PersistenceService::applyBatch(Node* list, std::unordered_set<uint64_t>& touched, size_t& changes) {
+    // The list is newest-first; reverse it to apply changes in order
+    Node* ordered = nullptr;
+    while (list) {
+        Node* next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    size_t count = 0;
+    while (ordered) {
+        Node* next = ordered->next;
+        applyDelta(*ordered, touched);
+        changes += ordered->kind == DeltaKind::UPSERT_MANY ? ordered->records.size() : 1;
+        delete ordered;
+        ordered = next;
+        ++count;
+    }
+    return count;
+}
+
+void PersistenceService::applyDelta(const Node& node, std::unordered_set<uint64_t>& touched) {
+    int f = static_cast<int>(node.file);
+    FileImage& image = images[f];
+    if (node.kind == DeltaKind::UPSERT_MANY) {
+        image.dirty = true;
+        for (const auto& record : node.records) {
+            touched.insert((static_cast<uint64_t>(f) << 32) | static_cast<uint32_t>(record.first));
+            putLine(image, record.first, record.second);
+        }
+        return;
+    }
+    if (node.kind != DeltaKind::ADOPT) {
+        image.dirty = true;
+        // One distinct (file, key) per record that actually reaches the disk
+        touched.insert((static_cast<uint64_t>(f) << 32) | static_cast<uint32_t>(node.key));
+    } else {
+        touched.insert(UINT64_MAX - static_cast<uint64_t>(f));  // not a superseded change
+    }
+
+    if (node.kind == DeltaKind::REPLACE || node.kind == DeltaKind::ADOPT) {
+        image.lines.clear();
+        image.keys.clear();
+        image.position.clear();
+        image.erased = 0;
+        for (const auto& record : node.records) {
+            image.position[record.first] = image.lines.size();
+            image.keys.push_back(record.first);
+            image.lines.push_back(record.second);
+        }
+        return;
+    }
+
+    auto it = image.position.find(node.key);
+    if (node.kind == DeltaKind::ERASE) {
+        if (it == image.position.end()) return;
+        image.lines[it->second].clear();
+        image.position.erase(it);
+        ++image.erased;
+        return;
+    }
+
+    putLine(image, node.key, node.line);
+}
+
+void PersistenceService::putLine(FileImage& image, int key, const std::string& line) {
+    auto it = image.position.find(key);
+    if (it != image.position.end()) {
+        image.lines[it->second] = line;
+    } else {
+        image.position[key] = image.lines.size();
+        image.keys.push_back(key);
+        image.lines.push_back(line);
+    }
+}
+
+bool PersistenceService::writeFile(int f) {
+    HOTEL_TIME_SCOPE(Timer::FILE_WRITE);
+    FileImage& image = images[f];
+
+    if (image.erased > 0) {
+        std::vector<std::string> lines;
+        std::vector<int> keys;
+        image.position.clear();
+        for (size_t i = 0; i < image.lines.size(); ++i) {
+            if (image.lines[i].empty()) continue;
+            image.position[image.keys[i]] = lines.size();
+            keys.push_back(image.keys[i]);
+            lines.push_back(std::move(image.lines[i]));
+        }
+        image.lines.swap(lines);
+        image.keys.swap(keys);
+        image.erased = 0;
+    }
+
+    std::string content;
+    size_t total = 0;
+    for (const auto& line : image.lines) total += line.size() + 1;
+    content.reserve(total);
+    for (const auto& line : image.lines) {
+        content += line;
+        content += '\n';
+    }
+
+    // Write aside and rename over the original so a crash never leaves a torn file
+    std::string temp = paths[f] + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(content.data(), static_cast<std::streamsize>(content.size()))) {
+            std::cerr << "Failed to open " << temp << " for writing.\n";
+            std::lock_guard<std::mutex> lock(statsMutex);
+            ++stats.writeErrors;
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, paths[f], ec);
+    if (ec) {
+        std::cerr << "Failed to replace " << paths[f] << ": " << ec.message() << "\n";
+        std::lock_guard<std::mutex> lock(statsMutex);
+        ++stats.writeErrors;
+        return false;
+    }
+
+    image.dirty = false;
+    HOTEL_COUNT(Counter::BYTES_WRITTEN, content.size());
+    std::lock_guard<std::mutex> lock(statsMutex);
+    ++stats.fileWrites;
+    stats.bytesWritten += content.size();
+    return true;
+}
+
+void PersistenceService::recordPass(size_t coalesced, double millis) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats.deltasCoalesced += coalesced;
+    ++flushPasses;
+    totalFlushMillis += millis;
+    stats.lastFlushMillis = millis;
+    stats.avgFlushMillis = totalFlushMillis / flushPasses;
+    stats.maxFlushMillis = std::max(stats.maxFlushMillis, millis);
+}
+
+PersistenceStats PersistenceService::getStats() const {
+    PersistenceStats out;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        out = stats;
+    }
+    uint64_t total = enqueued.load(std::memory_order_acquire);
+    out.deltasEnqueued = total;
+    out.queueDepth = static_cast<size_t>(total - written.load(std::memory_order_acquire));
+    out.maxQueueDepth = maxDepth.load(std::memory_order_relaxed);
+    return out;
+}
@@ -0,0 +1,130 @@
+#ifndef PERSISTENCE_SERVICE_H
+#define PERSISTENCE_SERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+enum class DataFile {
+    CUSTOMERS,
+    RESERVATIONS,
+    ROOMS,
+    RATES,
+    BLOCKS
+};
+
+const int DATA_FILE_COUNT = 5;
+
+struct PersistenceStats {
+    size_t queueDepth = 0;          // deltas enqueued but not yet on disk
+    size_t maxQueueDepth = 0;
+    uint64_t deltasEnqueued = 0;
+    uint64_t deltasCoalesced = 0;   // superseded by a later delta before being written
+    uint64_t fileWrites = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t writeErrors = 0;
+    double lastFlushMillis = 0.0;   // one writer pass: apply a batch and rewrite its files
+    double avgFlushMillis = 0.0;
+    double maxFlushMillis = 0.0;
+};
+
+// Takes the JSON-lines files off the callers' threads. Mutations enqueue
+// one serialized record per change (upsert/erase, keyed by id) or a whole
+// file image (replace). Producers push onto a lock-free list; a dedicated
+// writer thread takes the whole list at once, applies it to an in-memory
+// image of each file so repeated changes to one record collapse, then
+// rewrites every touched file via a temporary file and rename, so readers
+// never see a half-written file. A file whose write fails stays dirty and
+// is written again on the next pass.
+class PersistenceService {
+private:
+    enum class DeltaKind { UPSERT, UPSERT_MANY, ERASE, REPLACE, ADOPT };
+
+    struct Node {
+        DeltaKind kind;
+        DataFile file;
+        int key;
+        std::string line;
+        std::vector<std::pair<int, std::string>> records;  // UPSERT_MANY, REPLACE and ADOPT
+        Node* next;
+    };
+
+    // Records in first-seen order (the order the live vectors are saved
+    // in); erased slots stay empty until the next compaction
+    struct FileImage {
+        std::vector<std::string> lines;
+        std::vector<int> keys;
+        std::unordered_map<int, size_t> position;
+        size_t erased = 0;
+        bool dirty = false;
+    };
+
+    std::string paths[DATA_FILE_COUNT];
+    FileImage images[DATA_FILE_COUNT];
+
+    std::atomic<Node*> head{nullptr};
+    std::atomic<uint64_t> enqueued{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<size_t> maxDepth{0};
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeUp;
+    std::condition_variable flushed;
+    bool flushRequested = false;
+    bool stopping = false;
+    uint64_t passes = 0;             // writer passes completed
+    size_t unwrittenFiles = 0;       // still dirty after the last pass
+    std::chrono::milliseconds coalesceWindow;
+    static constexpr std::chrono::seconds RETRY_INTERVAL{1};
+
+    mutable std::mutex statsMutex;
+    PersistenceStats stats;
+    double totalFlushMillis = 0.0;
+    uint64_t flushPasses = 0;
+
+    std::thread writer;
+
+    void push(Node* node);
+    void writerLoop();
+    size_t applyBatch(Node* list, std::unordered_set<uint64_t>& touched, size_t& changes);
+    void applyDelta(const Node& node, std::unordered_set<uint64_t>& touched);
+    static void putLine(FileImage& image, int key, const std::string& line);
+    bool writeFile(int file);
+    void recordPass(size_t coalesced, double millis);
+
+public:
+    // paths are indexed by DataFile; changes arriving within the window
+    // share one rewrite per file
+    explicit PersistenceService(const std::string filePaths[DATA_FILE_COUNT],
+                                std::chrono::milliseconds window = std::chrono::milliseconds(10));
+    ~PersistenceService();  // drains the queue before returning
+
+    PersistenceService(const PersistenceService&) = delete;
+    PersistenceService& operator=(const PersistenceService&) = delete;
+
+    void upsert(DataFile file, int key, std::string line);
+    // Several records as one delta: they reach the disk in the same rewrite
+    void upsertMany(DataFile file, std::vector<std::pair<int, std::string>> records);
+    void erase(DataFile file, int key);
+    void replace(DataFile file, std::vector<std::pair<int, std::string>> records);
+    // Like replace, for records that are already on disk (just loaded):
+    // later upserts and erases apply to them without rewriting the file now
+    void adopt(DataFile file, std::vector<std::pair<int, std::string>> records);
+
+    // Returns once everything enqueued before the call has been written;
+    // false while some file still cannot be written (it is retried at
+    // least once a second)
+    bool flush();
+
+    PersistenceStats getStats() const;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "RateCalendar.h"
+#include "Metrics.h"
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    bool extractJsonNumber(const std::string& json, const std::string& key, long long& out) {
+        std::string pattern = "\"" + key + "\"";
+        size_t pos = json.find(pattern);
+        if (pos == std::string::npos) return false;
+        pos = json.find(':', pos);
+        if (pos == std::string::npos) return false;
+        ++pos;
+        while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos]))) ++pos;
+        size_t end = pos;
+        while (end < json.size() &&
+               (std::isdigit(static_cast<unsigned char>(json[end])) ||
+                json[end] == '-' || json[end] == '+' ||
+                json[end] == '.' || json[end] == 'e' || json[end] == 'E')) {
+            ++end;
+        }
+        if (end == pos) return false;
+        try {
+            out = std::stoll(json.substr(pos, end - pos));
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    bool extractJsonMoney(const std::string& json, const std::string& key, Money& out) {
+        std::string pattern = "\"" + key + "\"";
+        size_t pos = json.find(pattern);
+        if (pos == std::string::npos) return false;
+        pos = json.find(':', pos);
+        if (pos == std::string::npos) return false;
+        size_t end = json.find_first_of(",}", pos);
+        return Money::parse(json.substr(pos + 1, end - pos - 1), out);
+    }
+
+    // 1970-01-01 was a Thursday; 0 = Sunday
+    int weekday(int dayIndex) {
+        int w = (dayIndex + 4) % 7;
+        return w < 0 ? w + 7 : w;
+    }
+}
+
+std::string RateRule::getKindString() const {
+    switch (kind) {
+        case RateRuleKind::WEEKEND: return "Weekend";
+        case RateRuleKind::SEASON: return "Season";
+        case RateRuleKind::EVENT: return "Event";
+        default: return "Unknown";
+    }
+}
+
+std::string RateRule::serialize() const {
+    std::ostringstream ss;
+    ss << "{";
+    ss << "\"kind\":" << static_cast<int>(kind) << ",";
+    ss << "\"type\":" << static_cast<int>(type) << ",";
+    ss << "\"fromDay\":" << fromDay << ",";
+    ss << "\"toDay\":" << toDay << ",";
+    ss << "\"surcharge\":" << surcharge;
+    ss << "}";
+    return ss.str();
+}
+
+bool RateRule::deserialize(const std::string& data, RateRule& out) {
+    HOTEL_TIME_SCOPE(Timer::DESERIALIZE_RATE);
+    HOTEL_COUNT(Counter::RECORDS_PARSED, 1);
+    long long kindVal = 0, typeVal = 0, fromVal = 0, toVal = 0;
+    if (!extractJsonNumber(data, "kind", kindVal) ||
+        !extractJsonNumber(data, "type", typeVal) ||
+        !extractJsonNumber(data, "fromDay", fromVal) ||
+        !extractJsonNumber(data, "toDay", toVal) ||
+        !extractJsonMoney(data, "surcharge", out.surcharge)) {
+        return false;
+    }
+    if (typeVal < 0 || typeVal >= ROOM_TYPE_COUNT || toVal <= fromVal) return false;
+
+    out.kind = static_cast<RateRuleKind>(static_cast<int>(kindVal));
+    out.type = static_cast<RoomType>(static_cast<int>(typeVal));
+    out.fromDay = static_cast<int>(fromVal);
+    out.toDay = static_cast<int>(toVal);
+    return true;
+}
+
+void RateCalendar::rebuild() {
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        TypeRates& r = rates[t];
+        r.surcharge.clear();
+
+        int first = 0, last = 0;
+        bool any = false;
+        for (const auto& rule : rules) {
+            if (static_cast<int>(rule.type) != t) continue;
+            first = any ? std::min(first, rule.fromDay) : rule.fromDay;
+            last = any ? std::max(last, rule.toDay) : rule.toDay;
+            any = true;
+        }
+        if (!any) continue;
+
+        r.baseDay = first;
+        r.surcharge.assign(static_cast<size_t>(last - first), 0);
+        for (const auto& rule : rules) {
+            if (static_cast<int>(rule.type) != t) continue;
+            for (int d = rule.fromDay; d < rule.toDay; ++d) {
+                if (rule.kind == RateRuleKind::WEEKEND) {
+                    int w = weekday(d);
+                    if (w != 5 && w != 6) continue;
+                }
+                r.surcharge[static_cast<size_t>(d - first)] += rule.surcharge.getCents();
+            }
+        }
+    }
+}
+
+void RateCalendar::addRule(const RateRule& rule) {
+    rules.push_back(rule);
+    rebuild();
+}
+
+bool RateCalendar::removeRule(size_t index) {
+    if (index >= rules.size()) return false;
+    rules.erase(rules.begin() + static_cast<std::ptrdiff_t>(index));
+    rebuild();
+    return true;
+}
+
+void RateCalendar::setRules(const std::vector<RateRule>& newRules) {
+    rules = newRules;
+    rebuild();
+}
+
+Money RateCalendar::nightlySurcharge(RoomType type, int day) const {
+    const TypeRates& r = rates[static_cast<int>(type)];
+    if (day < r.baseDay || day >= r.baseDay + static_cast<int>(r.surcharge.size())) return Money();
+    return Money::fromCents(r.surcharge[static_cast<size_t>(day - r.baseDay)]);
+}
+
+Money RateCalendar::quoteStay(RoomType type, Money basePrice, int fromDay, int toDay) const {
+    if (toDay <= fromDay) return Money();
+
+    Money cost = basePrice * (toDay - fromDay);
+    const TypeRates& r = rates[static_cast<int>(type)];
+    int first = std::max(fromDay, r.baseDay);
+    int last = std::min(toDay, r.baseDay + static_cast<int>(r.surcharge.size()));
+    if (last > first) {
+        cost += Money::fromCents(sumCents(&r.surcharge[static_cast<size_t>(first - r.baseDay)],
+                                          static_cast<size_t>(last - first)));
+    }
+    return cost;
+}
+
+std::vector<Money> RateCalendar::quoteStays(RoomType type, Money basePrice,
+                                            const std::vector<std::pair<int, int>>& stays) const {
+    std::vector<Money> quotes;
+    quotes.reserve(stays.size());
+    for (const auto& stay : stays) {
+        quotes.push_back(quoteStay(type, basePrice, stay.first, stay.second));
+    }
+    return quotes;
+}
@@ -0,0 +1,60 @@
+#ifndef RATE_CALENDAR_H
+#define RATE_CALENDAR_H
+
+#include "Room.h"
+#include "Money.h"
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+
+enum class RateRuleKind {
+    WEEKEND,  // Friday and Saturday nights inside the range
+    SEASON,   // every night inside the range
+    EVENT     // every night inside the range, listed separately for clarity
+};
+
+// A nightly surcharge (negative for discounts) on top of the room's base
+// price for one RoomType over the nights [fromDay, toDay). Rules stack.
+struct RateRule {
+    RateRuleKind kind;
+    RoomType type;
+    int fromDay;
+    int toDay;
+    Money surcharge;
+
+    std::string getKindString() const;
+    std::string serialize() const;
+    static bool deserialize(const std::string& data, RateRule& out);
+};
+
+// Per-night rate adjustments by RoomType. The rules are materialized into
+// one contiguous cents array per type, so pricing a stay is base * nights
+// plus a vector sum over the slice of nights it covers.
+class RateCalendar {
+private:
+    struct TypeRates {
+        int baseDay = 0;
+        std::vector<int64_t> surcharge;  // cents per night
+    };
+
+    std::vector<RateRule> rules;
+    TypeRates rates[ROOM_TYPE_COUNT];
+
+    void rebuild();
+
+public:
+    const std::vector<RateRule>& getRules() const { return rules; }
+    void addRule(const RateRule& rule);
+    bool removeRule(size_t index);
+    void setRules(const std::vector<RateRule>& newRules);
+
+    // Surcharge for a single night
+    Money nightlySurcharge(RoomType type, int day) const;
+
+    Money quoteStay(RoomType type, Money basePrice, int fromDay, int toDay) const;
+    std::vector<Money> quoteStays(RoomType type, Money basePrice,
+                                  const std::vector<std::pair<int, int>>& stays) const;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "ReportBuffer.h"
+#include "DateUtils.h"
+#include <charconv>
+#include <cerrno>
+#include <cstdint>
+#include <ostream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace {
+    template <typename T>
+    void appendNumber(std::string& out, T value) {
+        char text[24];
+        char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+        out.append(text, static_cast<size_t>(end - text));
+    }
+
+    void appendTwoDigits(std::string& out, int value) {
+        out += static_cast<char>('0' + value / 10);
+        out += static_cast<char>('0' + value % 10);
+    }
+}
+
+bool StreamSink::write(const char* data, size_t size) {
+    out.write(data, static_cast<std::streamsize>(size));
+    return static_cast<bool>(out);
+}
+
+#ifdef __linux__
+bool DescriptorSink::write(const char* data, size_t size) {
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = ::write(fd, data + sent, size - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+#endif
+
+ReportBuffer::ReportBuffer() : flushBytes(0) {}
+
+ReportBuffer::ReportBuffer(ReportSink& target, size_t bytes) : sink(&target), flushBytes(bytes) {}
+
+ReportBuffer::ReportBuffer(std::ostream& out, size_t bytes) : ownedSink(new StreamSink(out)), flushBytes(bytes) {
+    sink = ownedSink.get();
+}
+
+ReportBuffer::~ReportBuffer() {
+    flush();
+}
+
+bool ReportBuffer::flush() {
+    if (sink && !buffer.empty()) {
+        if (!sink->write(buffer.data(), buffer.size())) failed = true;
+        buffer.clear();
+    }
+    return !failed;
+}
+
+ReportBuffer& ReportBuffer::operator<<(const std::string& text) {
+    buffer += text;
+    spill();
+    return *this;
+}
+
+ReportBuffer& ReportBuffer::operator<<(const char* text) {
+    buffer += text;
+    spill();
+    return *this;
+}
+
+ReportBuffer& ReportBuffer::operator<<(char c) {
+    buffer += c;
+    spill();
+    return *this;
+}
+
+ReportBuffer& ReportBuffer::operator<<(int value) { return *this << static_cast<long long>(value); }
+ReportBuffer& ReportBuffer::operator<<(long value) { return *this << static_cast<long long>(value); }
+
+ReportBuffer& ReportBuffer::operator<<(long long value) {
+    appendNumber(buffer, value);
+    spill();
+    return *this;
+}
+
+ReportBuffer& ReportBuffer::operator<<(unsigned value) { return *this << static_cast<unsigned long long>(value); }
+ReportBuffer& ReportBuffer::operator<<(unsigned long value) { return *this << static_cast<unsigned long long>(value); }
+
+ReportBuffer& ReportBuffer::operator<<(unsigned long long value) {
+    appendNumber(buffer, value);
+    spill();
+    return *this;
+}
+
+ReportBuffer& ReportBuffer::operator<<(Money amount) {
+    // Same text as Money::toString()
+    int64_t cents = amount.getCents();
+    uint64_t magnitude = cents < 0 ? 0 - static_cast<uint64_t>(cents) : static_cast<uint64_t>(cents);
+    if (cents < 0) buffer += '-';
+    appendNumber(buffer, magnitude / 100);
+    buffer += '.';
+    appendTwoDigits(buffer, static_cast<int>(magnitude % 100));
+    spill();
+    return *this;
+}
+
+const ReportBuffer::DayText* ReportBuffer::dayOf(time_t t) {
+    if (days.empty()) days.resize(DAY_SLOTS);
+    long long utcDay = static_cast<long long>(t) / 86400 - (static_cast<long long>(t) % 86400 < 0 ? 1 : 0);
+    DayText& slot = days[static_cast<size_t>(utcDay) % DAY_SLOTS];
+    if (t >= slot.start && t < slot.end) return &slot;
+
+    std::tm tm = toLocalTm(t);
+    time_t start = t - (tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec);
+    std::tm first = toLocalTm(start);
+    std::tm last = toLocalTm(start + 86399);
+    // A day with a clock change is not 24 hours long; its timestamps are
+    // converted one at a time
+    if (first.tm_mday != tm.tm_mday || first.tm_hour != 0 || first.tm_min != 0 || first.tm_sec != 0 ||
+        last.tm_mday != tm.tm_mday || last.tm_hour != 23 || last.tm_min != 59 || last.tm_sec != 59) {
+        return nullptr;
+    }
+    slot.start = start;
+    slot.end = start + 86400;
+    std::strftime(slot.date, sizeof(slot.date), "%Y-%m-%d", &tm);
+    return &slot;
+}
+
+ReportBuffer& ReportBuffer::dateTime(time_t t) {
+    if (const DayText* day = dayOf(t)) {
+        int minutes = static_cast<int>((t - day->start) / 60);
+        buffer += day->date;
+        buffer += ' ';
+        appendTwoDigits(buffer, minutes / 60);
+        buffer += ':';
+        appendTwoDigits(buffer, minutes % 60);
+    } else {
+        std::tm tm = toLocalTm(t);
+        char text[32];
+        buffer.append(text, std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M", &tm));
+    }
+    spill();
+    return *this;
+}
+
+ReportBuffer& ReportBuffer::date(time_t t) {
+    if (const DayText* day = dayOf(t)) {
+        buffer += day->date;
+    } else {
+        std::tm tm = toLocalTm(t);
+        char text[32];
+        buffer.append(text, std::strftime(text, sizeof(text), "%Y-%m-%d", &tm));
+    }
+    spill();
+    return *this;
+}
@@ -0,0 +1,105 @@
+#ifndef REPORT_BUFFER_H
+#define REPORT_BUFFER_H
+
+#include "Money.h"
+#include <cstddef>
+#include <ctime>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Where rendered text ends up. A sink sees a few large writes per listing,
+// never single fields.
+class ReportSink {
+public:
+    virtual ~ReportSink() = default;
+    virtual bool write(const char* data, size_t size) = 0;
+};
+
+// std::cout, a file stream or a string stream
+class StreamSink : public ReportSink {
+private:
+    std::ostream& out;
+
+public:
+    explicit StreamSink(std::ostream& out) : out(out) {}
+    bool write(const char* data, size_t size) override;
+};
+
+#ifdef __linux__
+// A socket, pipe or file descriptor; short writes are resumed
+class DescriptorSink : public ReportSink {
+private:
+    int fd;
+
+public:
+    explicit DescriptorSink(int fd) : fd(fd) {}
+    bool write(const char* data, size_t size) override;
+};
+#endif
+
+// Text for listings, schedules and invoices is formatted into one reusable
+// buffer and handed to the sink once flushBytes have built up, on flush()
+// and on destruction. Without a sink the text stays in the buffer for
+// text() / clear(). Numbers and amounts are formatted without locales or
+// temporaries. Timestamps come from a per-day cache: the first timestamp
+// of a local day pays for the localtime() calls, and the others on that
+// day only need their hour and minute added. Not thread-safe; use one
+// buffer per thread.
+class ReportBuffer {
+private:
+    struct DayText {
+        time_t start = 0;  // [start, end) is one local day of 24 hours
+        time_t end = 0;
+        char date[16] = {};
+    };
+
+    static const size_t DAY_SLOTS = 512;
+
+    std::string buffer;
+    ReportSink* sink = nullptr;
+    std::unique_ptr<StreamSink> ownedSink;
+    size_t flushBytes;
+    bool failed = false;
+    std::vector<DayText> days;  // by UTC day, allocated on the first timestamp
+
+    void spill() {
+        if (sink && buffer.size() >= flushBytes) flush();
+    }
+    const DayText* dayOf(time_t t);
+
+public:
+    static const size_t DEFAULT_FLUSH_BYTES = 64 * 1024;
+
+    ReportBuffer();
+    explicit ReportBuffer(ReportSink& sink, size_t flushBytes = DEFAULT_FLUSH_BYTES);
+    explicit ReportBuffer(std::ostream& out, size_t flushBytes = DEFAULT_FLUSH_BYTES);
+    ~ReportBuffer();
+
+    ReportBuffer(const ReportBuffer&) = delete;
+    ReportBuffer& operator=(const ReportBuffer&) = delete;
+
+    ReportBuffer& operator<<(const std::string& text);
+    ReportBuffer& operator<<(const char* text);
+    ReportBuffer& operator<<(char c);
+    ReportBuffer& operator<<(int value);
+    ReportBuffer& operator<<(long value);
+    ReportBuffer& operator<<(long long value);
+    ReportBuffer& operator<<(unsigned value);
+    ReportBuffer& operator<<(unsigned long value);
+    ReportBuffer& operator<<(unsigned long long value);
+    ReportBuffer& operator<<(Money amount);
+
+    // Local "%Y-%m-%d %H:%M" and "%Y-%m-%d"
+    ReportBuffer& dateTime(time_t t);
+    ReportBuffer& date(time_t t);
+
+    // Hands the buffered text to the sink; false once any write has failed
+    bool flush();
+
+    const std::string& text() const { return buffer; }
+    void clear() { buffer.clear(); }
+};
+
+#endif
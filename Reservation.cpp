@@ -1,11 +1,13 @@
 #include "Reservation.h"
+#include "Metrics.h"
+#include "DateUtils.h"
+#include "ReportBuffer.h"
 #include <sstream>
-#include <iomanip>
 #include <vector>
 #include <cmath>
 #include <cctype>
 
-int Reservation::nextId = 1;
+IdAllocator<Reservation> Reservation::ids;
 
 namespace {
     bool extractJsonNumber(const std::string& json, const std::string& key, long long& out) {
@@ -32,7 +34,7 @@ namespace {
         return true;
     }
 
-    bool extractJsonDouble(const std::string& json, const std::string& key, double& out) {
+    bool extractJsonMoney(const std::string& json, const std::string& key, Money& out) {
         std::string pattern = "\"" + key + "\"";
         size_t pos = json.find(pattern);
         if (pos == std::string::npos) return false;
@@ -48,52 +50,34 @@ namespace {
             ++end;
         }
         if (end == pos) return false;
-        try {
-            out = std::stod(json.substr(pos, end - pos));
-        } catch (...) {
-            return false;
-        }
-        return true;
+        return Money::parse(json.substr(pos, end - pos), out);
     }
 }
 
 Reservation::Reservation() 
     : id(0), customerId(0), checkInTime(0), checkOutTime(0), 
-      assignedRoomNumber(-1), status(ReservationStatus::PENDING), totalCost(0.0) {}
+      assignedRoomNumber(-1), status(ReservationStatus::PENDING), totalCost(), requestedType(-1) {}
 
 Reservation::Reservation(int customerId, time_t checkIn, time_t checkOut)
-    : id(nextId++), customerId(customerId), checkInTime(checkIn), 
+    : id(ids.allocate()), customerId(customerId), checkInTime(checkIn), 
       checkOutTime(checkOut), assignedRoomNumber(-1), 
-      status(ReservationStatus::PENDING), totalCost(0.0) {}
+      status(ReservationStatus::PENDING), totalCost(), requestedType(-1) {}
 
 Reservation::Reservation(int id, int customerId, time_t checkIn, time_t checkOut,
-                         int roomNumber, ReservationStatus status, double cost)
+                         int roomNumber, ReservationStatus status, Money cost)
     : id(id), customerId(customerId), checkInTime(checkIn), 
       checkOutTime(checkOut), assignedRoomNumber(roomNumber), 
-      status(status), totalCost(cost) {
-    if (id >= nextId) nextId = id + 1;
-}
+      status(status), totalCost(cost), requestedType(-1) {}
 
 bool Reservation::overlaps(const Reservation& other) const {
     return !(checkOutTime <= other.checkInTime || checkInTime >= other.checkOutTime);
 }
 
 int Reservation::getDuration() const {
-    std::tm in_tm  = *std::localtime(&checkInTime);
-    std::tm out_tm = *std::localtime(&checkOutTime);
-
-    in_tm.tm_hour = in_tm.tm_min = in_tm.tm_sec = 0;
-    out_tm.tm_hour = out_tm.tm_min = out_tm.tm_sec = 0;
-
-    time_t in_midnight  = std::mktime(&in_tm);
-    time_t out_midnight = std::mktime(&out_tm);
-
-    if (out_midnight <= in_midnight) {
-        return 0;  // defensive: invalid or zero-length stay
-    }
-
-    double diffDays = std::difftime(out_midnight, in_midnight) / 86400.0;
-    return static_cast<int>(diffDays);  // exact whole number of nights
+    // Local calendar nights; day indices avoid mktime, which serializes
+    // threads on the time zone lock, and are exact across DST changes
+    int nights = toDayIndex(checkOutTime) - toDayIndex(checkInTime);
+    return nights > 0 ? nights : 0;  // defensive: invalid or zero-length stay
 }
 
 std::string Reservation::getStatusString() const {
@@ -108,16 +92,24 @@ std::string Reservation::getStatusString() const {
 }
 
 void Reservation::display() const {
-    time_t in = checkInTime;
-    time_t out = checkOutTime;
-    std::cout << "Reservation ID: " << id << "\n"
-              << "Customer ID: " << customerId << "\n"
-              << "Check-in: " << std::put_time(std::localtime(&in), "%Y-%m-%d %H:%M") << "\n"
-              << "Check-out: " << std::put_time(std::localtime(&out), "%Y-%m-%d %H:%M") << "\n"
-              << "Duration: " << getDuration() << " days\n"
-              << "Assigned Room: " << (assignedRoomNumber > 0 ? std::to_string(assignedRoomNumber) : "Not Assigned") << "\n"
-              << "Status: " << getStatusString() << "\n"
-              << "Total Cost: $" << totalCost << "\n";
+    ReportBuffer out(std::cout);
+    render(out);
+}
+
+void Reservation::render(ReportBuffer& out) const {
+    out << "Reservation ID: " << id << "\n"
+        << "Customer ID: " << customerId << "\n"
+        << "Check-in: ";
+    out.dateTime(checkInTime);
+    out << "\nCheck-out: ";
+    out.dateTime(checkOutTime);
+    out << "\nDuration: " << getDuration() << " days\n"
+        << "Assigned Room: ";
+    if (assignedRoomNumber > 0) out << assignedRoomNumber;
+    else out << "Not Assigned";
+    out << "\n"
+        << "Status: " << getStatusString() << "\n"
+        << "Total Cost: $" << totalCost << "\n";
 }
 
 std::string Reservation::serialize() const {
@@ -130,18 +122,23 @@ std::string Reservation::serialize() const {
     ss << "\"assignedRoomNumber\":" << assignedRoomNumber << ",";
     ss << "\"status\":" << static_cast<int>(status) << ",";
     ss << "\"totalCost\":" << totalCost;
+    // Older files have no requested type; it is only written when known
+    if (requestedType >= 0) ss << ",\"requestedType\":" << requestedType;
     ss << "}";
     return ss.str();
 }
 
 Reservation Reservation::deserialize(const std::string& data) {
+    HOTEL_TIME_SCOPE(Timer::DESERIALIZE_RESERVATION);
+    HOTEL_COUNT(Counter::RECORDS_PARSED, 1);
     long long idVal = 0;
     long long customerIdVal = 0;
     long long checkInVal = 0;
     long long checkOutVal = 0;
     long long roomVal = -1;
     long long statusVal = 0;
-    double costVal = 0.0;
+    long long requestedVal = -1;
+    Money costVal;
 
     if (!extractJsonNumber(data, "id", idVal)) {
         return Reservation();
@@ -151,9 +148,10 @@ Reservation Reservation::deserialize(const std::string& data) {
     extractJsonNumber(data, "checkOutTime", checkOutVal);
     extractJsonNumber(data, "assignedRoomNumber", roomVal);
     extractJsonNumber(data, "status", statusVal);
-    extractJsonDouble(data, "totalCost", costVal);
+    extractJsonMoney(data, "totalCost", costVal);
+    extractJsonNumber(data, "requestedType", requestedVal);
 
-    return Reservation(
+    Reservation r(
         static_cast<int>(idVal),
         static_cast<int>(customerIdVal),
         static_cast<time_t>(checkInVal),
@@ -162,4 +160,6 @@ Reservation Reservation::deserialize(const std::string& data) {
         static_cast<ReservationStatus>(static_cast<int>(statusVal)),
         costVal
     );
+    r.setRequestedType(static_cast<int>(requestedVal));
+    return r;
 }
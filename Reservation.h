@@ -4,6 +4,10 @@
 #include <ctime>
 #include <string>
 #include <iostream>
+#include "Money.h"
+#include "IdAllocator.h"
+
+class ReportBuffer;
 
 enum class ReservationStatus {
     PENDING,
@@ -21,14 +25,15 @@ private:
     time_t checkOutTime;
     int assignedRoomNumber;
     ReservationStatus status;
-    double totalCost;
-    static int nextId;
+    Money totalCost;
+    int requestedType;   // RoomType index the guest asked for, -1 if unknown
+    static IdAllocator<Reservation> ids;
 
 public:
     Reservation();
     Reservation(int customerId, time_t checkIn, time_t checkOut);
     Reservation(int id, int customerId, time_t checkIn, time_t checkOut,
-                int roomNumber, ReservationStatus status, double cost);
+                int roomNumber, ReservationStatus status, Money cost);
 
     int getId() const { return id; }
     int getCustomerId() const { return customerId; }
@@ -36,18 +41,21 @@ public:
     time_t getCheckOutTime() const { return checkOutTime; }
     int getAssignedRoomNumber() const { return assignedRoomNumber; }
     ReservationStatus getStatus() const { return status; }
-    double getTotalCost() const { return totalCost; }
+    Money getTotalCost() const { return totalCost; }
+    int getRequestedType() const { return requestedType; }
 
     void setAssignedRoomNumber(int roomNumber) { assignedRoomNumber = roomNumber; }
     void setStatus(ReservationStatus s) { status = s; }
-    void setTotalCost(double cost) { totalCost = cost; }
-    static void setNextId(int id) { nextId = id; }
+    void setTotalCost(Money cost) { totalCost = cost; }
+    void setRequestedType(int type) { requestedType = type; }
+    static void setNextId(int id) { ids.reset(id); }
 
     bool overlaps(const Reservation& other) const;
     int getDuration() const;
 
     std::string getStatusString() const;
     void display() const;
+    void render(ReportBuffer& out) const;
 
     std::string serialize() const;
     static Reservation deserialize(const std::string& data);
@@ -0,0 +1,101 @@
+#include "ReservationQuery.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    struct RowOrder {
+        template <typename Row>
+        bool operator()(const Row& a, const Row& b) const {
+            return a.key != b.key ? a.key < b.key : a.id < b.id;
+        }
+    };
+}
+
+ReservationPager::ReservationPager(const ReservationQuery& q, const std::unordered_map<int, RoomType>& types)
+    : query(q), roomTypes(types) {
+    query.pageSize = std::max<size_t>(1, query.pageSize);
+    // Comparing instants instead of converting every check-in to a day
+    if (query.filter.checkInFromDay != INT_MIN) checkInFrom = fromDayIndex(query.filter.checkInFromDay);
+    if (query.filter.checkInToDay != INT_MAX) checkInTo = fromDayIndex(query.filter.checkInToDay);
+
+    if (!query.cursor.empty()) {
+        long long key = 0, id = 0;
+        char extra = 0;
+        cursorValid = std::sscanf(query.cursor.c_str(), "%lld:%lld%c", &key, &id, &extra) == 2;
+        hasCursor = cursorValid;
+        cursorKey = query.descending ? -key : key;
+        cursorId = query.descending ? -id : id;
+    }
+    heap.reserve(query.pageSize + 1);
+}
+
+int64_t ReservationPager::sortKey(const Reservation& r) const {
+    switch (query.sort) {
+        case ReservationSort::CHECK_IN: return static_cast<int64_t>(r.getCheckInTime());
+        case ReservationSort::CHECK_OUT: return static_cast<int64_t>(r.getCheckOutTime());
+        case ReservationSort::TOTAL_COST: return r.getTotalCost().getCents();
+        case ReservationSort::ID: break;
+    }
+    return r.getId();
+}
+
+bool ReservationPager::matches(const Reservation& r) const {
+    const ReservationFilter& f = query.filter;
+    if (f.statusMask != 0 && (f.statusMask & ReservationFilter::statusBit(r.getStatus())) == 0) return false;
+    if (f.customerId != 0 && r.getCustomerId() != f.customerId) return false;
+    if (f.roomNumber > 0 && r.getAssignedRoomNumber() != f.roomNumber) return false;
+    if (f.checkInFromDay != INT_MIN && r.getCheckInTime() < checkInFrom) return false;
+    if (f.checkInToDay != INT_MAX && r.getCheckInTime() >= checkInTo) return false;
+    if (f.roomType >= 0) {
+        int type = r.getRequestedType();
+        if (type < 0) {
+            auto it = roomTypes.find(r.getAssignedRoomNumber());
+            type = it == roomTypes.end() ? -1 : static_cast<int>(it->second);
+        }
+        if (type != f.roomType) return false;
+    }
+    return true;
+}
+
+void ReservationPager::offer(const Reservation& r) {
+    ++examined;
+    if (!matches(r)) return;
+    ++matched;
+
+    int64_t key = sortKey(r), id = r.getId();
+    if (query.descending) {
+        key = -key;
+        id = -id;
+    }
+    if (hasCursor && (key < cursorKey || (key == cursorKey && id <= cursorId))) return;
+
+    RowOrder order;
+    if (heap.size() == query.pageSize + 1) {
+        const Row& worst = heap.front();
+        if (key > worst.key || (key == worst.key && id > worst.id)) return;
+        std::pop_heap(heap.begin(), heap.end(), order);
+        heap.pop_back();
+    }
+    heap.push_back({key, id, r});
+    std::push_heap(heap.begin(), heap.end(), order);
+}
+
+ReservationPage ReservationPager::finish(const std::string& plan) {
+    std::sort_heap(heap.begin(), heap.end(), RowOrder());
+    ReservationPage page;
+    page.plan = plan;
+    page.matched = matched;
+    page.examined = examined;
+    // The extra row only says that another page exists
+    bool more = heap.size() > query.pageSize;
+    if (more) heap.pop_back();
+    page.rows.reserve(heap.size());
+    for (auto& row : heap) page.rows.push_back(std::move(row.reservation));
+    if (more) {
+        const Reservation& last = page.rows.back();
+        page.nextCursor = std::to_string(sortKey(last)) + ":" + std::to_string(last.getId());
+    }
+    heap.clear();
+    return page;
+}
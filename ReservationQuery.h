@@ -0,0 +1,88 @@
+#ifndef RESERVATION_QUERY_H
+#define RESERVATION_QUERY_H
+
+#include "Reservation.h"
+#include "Room.h"
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class ReservationSort {
+    ID,
+    CHECK_IN,
+    CHECK_OUT,
+    TOTAL_COST
+};
+
+// Every field that is set must match
+struct ReservationFilter {
+    unsigned statusMask = 0;        // statusBit()s; 0: any status
+    int checkInFromDay = INT_MIN;   // local check-in day in [from, to)
+    int checkInToDay = INT_MAX;
+    int roomNumber = -1;
+    int roomType = -1;              // the requested type, else the assigned room's
+    int customerId = 0;
+
+    static unsigned statusBit(ReservationStatus status) { return 1u << static_cast<int>(status); }
+    bool hasDayRange() const { return checkInFromDay != INT_MIN || checkInToDay != INT_MAX; }
+};
+
+struct ReservationQuery {
+    ReservationFilter filter;
+    ReservationSort sort = ReservationSort::ID;
+    bool descending = false;
+    size_t pageSize = 20;
+    std::string cursor;             // nextCursor of the previous page; empty: first page
+};
+
+struct ReservationPage {
+    std::vector<Reservation> rows;
+    std::string nextCursor;         // empty on the last page
+    size_t matched = 0;             // rows matching the filter, on all pages
+    size_t examined = 0;            // reservations the plan had to look at
+    std::string plan;               // the index used, or "scan"
+};
+
+// Builds one page from candidate reservations offered in any order. Rows
+// that pass the filter and sort after the cursor go through a bounded heap
+// of pageSize + 1, so a page costs O(candidates log pageSize) and copies
+// only the rows it returns, however deep into the results it is. The
+// cursor is "KEY:ID" of the last row shown, so it stays valid while rows
+// are added or changed between pages.
+class ReservationPager {
+private:
+    struct Row {
+        int64_t key;  // sort key, negated for descending order
+        int64_t id;
+        Reservation reservation;
+    };
+
+    ReservationQuery query;
+    const std::unordered_map<int, RoomType>& roomTypes;
+    time_t checkInFrom = 0;  // day range as instants
+    time_t checkInTo = 0;
+    bool hasCursor = false;
+    int64_t cursorKey = 0;
+    int64_t cursorId = 0;
+    bool cursorValid = true;
+    std::vector<Row> heap;   // max-heap of the best pageSize + 1 rows
+    size_t matched = 0;
+    size_t examined = 0;
+
+    int64_t sortKey(const Reservation& r) const;
+
+public:
+    // roomTypes maps room numbers to types for stays without a requested type
+    ReservationPager(const ReservationQuery& query, const std::unordered_map<int, RoomType>& roomTypes);
+
+    // false when the cursor could not be parsed
+    bool ok() const { return cursorValid; }
+    bool matches(const Reservation& r) const;
+    void offer(const Reservation& r);
+    ReservationPage finish(const std::string& plan);
+};
+
+#endif
@@ -0,0 +1,379 @@
+#include "ReservationServer.h"
+#include "FrameProtocol.h"
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void handleStopSignal(int) {
+        stopRequested = 1;
+    }
+}
+
+ReservationServer::ReservationServer(HotelSystem& hotelRef, const std::string& path, unsigned workers)
+    : executor(hotelRef), socketPath(path), workerCount(workers) {
+    if (workerCount == 0) {
+        workerCount = std::max(2u, std::thread::hardware_concurrency());
+    }
+}
+
+void ReservationServer::stop() {
+    stopRequested = 1;
+}
+
+#ifdef __linux__
+
+namespace {
+    // Administrative commands (reschedule, blocks, save, ...) are left to
+    // the menu and batch files
+    const char* const SERVED_OPERATIONS[] = {
+        "add_customer", "create_reservation", "create_group", "cancel",
+        "check_in", "check_out", "availability", "lookup"
+    };
+
+    bool isServed(const std::string& command) {
+        size_t start = command.find_first_not_of(" \t");
+        if (start == std::string::npos) return false;
+        size_t end = command.find_first_of(" \t\r\n", start);
+        std::string operation = command.substr(start, end == std::string::npos ? end : end - start);
+        for (const char* served : SERVED_OPERATIONS) {
+            if (operation == served) return true;
+        }
+        return false;
+    }
+
+    bool setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+}
+
+ReservationServer::~ReservationServer() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& t : workers) t.join();
+
+    for (auto& entry : connections) close(entry.second.fd);
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    if (wakeFd >= 0) close(wakeFd);
+    if (epollFd >= 0) close(epollFd);
+}
+
+bool ReservationServer::openSocket() {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Invalid socket path: " << socketPath << "\n";
+        return false;
+    }
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    // A stale socket file from a previous run would make bind fail
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenFd, 128) < 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "Failed to listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    epollFd = epoll_create1(0);
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0) {
+        std::cerr << "epoll/eventfd: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    // Connection ids start at 1, so 0 tags the listener and UINT64_MAX the eventfd
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.u64 = UINT64_MAX;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+    return true;
+}
+
+void ReservationServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: backlog drained
+
+        uint64_t id = nextConnectionId++;
+        Connection& conn = connections[id];
+        conn.fd = fd;
+        conn.events = EPOLLIN | EPOLLRDHUP;
+
+        epoll_event ev;
+        ev.events = conn.events;
+        ev.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+void ReservationServer::readClient(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& conn = it->second;
+    if (conn.closing) {
+        // Input is no longer watched, so this is a hangup or an error: the
+        // peer is gone and nothing left to send can reach it
+        closeClient(id);
+        return;
+    }
+
+    char chunk[16384];
+    bool peerClosed = false;
+    while (conn.input.size() < MAX_INPUT_BYTES) {
+        ssize_t n = read(conn.fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            conn.input.append(chunk, static_cast<size_t>(n));
+            continue;
+        }
+        if (n == 0) peerClosed = true;
+        else if (errno == EINTR) continue;
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeClient(id);
+            return;
+        }
+        break;
+    }
+
+    dispatchFrames(id, conn);
+    // A half-close only ends the requests; their replies still go out
+    if (peerClosed) conn.closing = true;
+    flushClient(id);
+}
+
+void ReservationServer::dispatchFrames(uint64_t id, Connection& conn) {
+    // Hand complete frames to the workers in one batch, up to the cap; the
+    // rest stay in input until replies have gone out
+    size_t offset = 0;
+    uint32_t requestId = 0;
+    std::string command;
+    std::vector<Job> batch;
+    int status = 0;
+    while (conn.pending + batch.size() < MAX_PENDING_JOBS &&
+           (status = decodeFrame(conn.input, offset, requestId, command)) == 1) {
+        batch.push_back(Job{id, requestId, command});
+    }
+    conn.input.erase(0, offset);
+
+    if (!batch.empty()) {
+        conn.pending += batch.size();
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            for (auto& job : batch) jobs.push_back(std::move(job));
+        }
+        if (batch.size() == 1) jobReady.notify_one();
+        else jobReady.notify_all();
+    }
+
+    if (status < 0) {
+        // Oversized length prefix: the stream can't be resynchronized
+        ResponseFrame response;
+        response.code = static_cast<int>(ResultCode::BAD_COMMAND);
+        response.message = "Frame too large.";
+        appendFrame(conn.output, 0, encodeResponse(response));
+        conn.closing = true;
+        conn.input.clear();
+    }
+}
+
+void ReservationServer::flushClient(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& conn = it->second;
+    // Frames held back by the caps go once the connection has caught up
+    if (!conn.input.empty() && !conn.throttled()) dispatchFrames(id, conn);
+
+    size_t sent = 0;
+    while (sent < conn.output.size()) {
+        ssize_t n = send(conn.fd, conn.output.data() + sent, conn.output.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        closeClient(id);
+        return;
+    }
+    conn.output.erase(0, sent);
+
+    if (conn.closing && conn.output.empty() && conn.pending == 0) {
+        closeClient(id);
+        return;
+    }
+
+    // Stop reading once closing or while over a cap; only watch for
+    // writability while there is a backlog
+    uint32_t events = conn.closing || conn.throttled() ? 0 : EPOLLIN | EPOLLRDHUP;
+    if (!conn.output.empty()) events |= EPOLLOUT;
+    if (events != conn.events) {
+        epoll_event ev;
+        ev.events = events;
+        ev.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev);
+        conn.events = events;
+    }
+}
+
+void ReservationServer::closeClient(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    // Responses still in flight for this id are dropped in deliverCompletions
+    connections.erase(it);
+}
+
+void ReservationServer::deliverCompletions() {
+    uint64_t counter;
+    while (read(wakeFd, &counter, sizeof(counter)) > 0) {}
+
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        ready.swap(completions);
+    }
+
+    std::vector<uint64_t> touched;
+    for (const auto& c : ready) {
+        auto it = connections.find(c.connectionId);
+        if (it == connections.end()) continue;
+        --it->second.pending;
+        if (it->second.output.empty()) touched.push_back(c.connectionId);
+        appendFrame(it->second.output, c.requestId, c.payload);
+    }
+    for (uint64_t id : touched) flushClient(id);
+}
+
+void ReservationServer::workerLoop() {
+    std::string operation;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        // HotelSystem's API does its own shard locking (see HotelLocks.h)
+        OperationResult result;
+        if (!isServed(job.command)) {
+            result.code = ResultCode::BAD_COMMAND;
+            result.message = "Not available over the server.";
+        } else {
+            try {
+                result = executor.execute(job.command, operation);
+            } catch (const std::exception& e) {
+                result = OperationResult();
+                result.code = ResultCode::INVALID_STATE;
+                result.message = std::string("Request failed: ") + e.what();
+            } catch (...) {
+                result = OperationResult();
+                result.code = ResultCode::INVALID_STATE;
+                result.message = "Request failed.";
+            }
+        }
+
+        ResponseFrame response;
+        response.code = static_cast<int>(result.code);
+        response.id = result.id;
+        response.roomNumber = result.roomNumber;
+        response.cents = result.totalCost.getCents();
+        response.message = result.message;
+
+        bool wasEmpty;
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            wasEmpty = completions.empty();
+            completions.push_back(Completion{job.connectionId, job.requestId, encodeResponse(response)});
+        }
+        ++requestsServed;
+        // One wake-up covers everything queued before the loop drains it
+        if (wasEmpty) {
+            uint64_t one = 1;
+            ssize_t ignored = write(wakeFd, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+}
+
+bool ReservationServer::run() {
+    if (!openSocket()) return false;
+
+    stopRequested = 0;
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ReservationServer::workerLoop, this);
+    }
+    std::cout << "Listening on " << socketPath << " with " << workerCount << " workers.\n";
+
+    const int maxEvents = 64;
+    epoll_event events[maxEvents];
+    while (!stopRequested) {
+        // The timeout only bounds how long a stop signal can go unnoticed
+        int count = epoll_wait(epollFd, events, maxEvents, 250);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            uint64_t tag = events[i].data.u64;
+            uint32_t flags = events[i].events;
+            if (tag == 0) {
+                acceptClients();
+            } else if (tag == UINT64_MAX) {
+                deliverCompletions();
+            } else {
+                if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) readClient(tag);
+                if (flags & EPOLLOUT) flushClient(tag);
+            }
+        }
+    }
+
+    std::cout << "Shutting down after " << requestsServed.load() << " requests.\n";
+    return true;
+}
+
+#else
+
+ReservationServer::~ReservationServer() {}
+
+bool ReservationServer::run() {
+    std::cerr << "Server mode requires Linux (epoll).\n";
+    return false;
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef RESERVATION_SERVER_H
+#define RESERVATION_SERVER_H
+
+#include "HotelSystem.h"
+#include "BatchExecutor.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Serves HotelSystem to several front-desk clients over a local Unix
+// socket. One epoll thread owns every connection and does all socket I/O;
+// complete request frames (see FrameProtocol.h) are handed to a worker
+// pool, and workers post responses back through an eventfd. Requests are
+// BatchExecutor command lines limited to front-desk work: add_customer,
+// create_reservation, create_group, cancel, check_in, check_out,
+// availability and lookup. A connection with too many requests in flight
+// or too many unsent replies is not read from until it catches up.
+class ReservationServer {
+private:
+    static const size_t MAX_PENDING_JOBS = 256;          // per connection
+    static const size_t MAX_OUTPUT_BYTES = 1024 * 1024;  // unsent replies
+    static const size_t MAX_INPUT_BYTES = 1024 * 1024;   // read ahead of decoding
+
+    struct Connection {
+        int fd = -1;
+        std::string input;
+        std::string output;
+        uint32_t events = 0;       // as registered with epoll
+        size_t pending = 0;        // jobs queued or running for this connection
+        bool closing = false;      // peer half-closed or sent a bad frame; no more
+                                   // reads, close once pending replies are sent
+
+        bool throttled() const { return pending >= MAX_PENDING_JOBS || output.size() >= MAX_OUTPUT_BYTES; }
+    };
+
+    struct Job {
+        uint64_t connectionId;
+        uint32_t requestId;
+        std::string command;
+    };
+
+    struct Completion {
+        uint64_t connectionId;
+        uint32_t requestId;
+        std::string payload;
+    };
+
+    BatchExecutor executor;
+    std::string socketPath;
+    unsigned workerCount;
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;               // eventfd signalled when completions are queued
+
+    std::map<uint64_t, Connection> connections;
+    uint64_t nextConnectionId = 1;
+
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<Job> jobs;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+
+    std::atomic<uint64_t> requestsServed{0};
+
+    bool openSocket();
+    void acceptClients();
+    void readClient(uint64_t id);
+    void dispatchFrames(uint64_t id, Connection& conn);
+    void flushClient(uint64_t id);
+    void closeClient(uint64_t id);
+    void deliverCompletions();
+    void workerLoop();
+
+public:
+    ReservationServer(HotelSystem& hotel, const std::string& socketPath, unsigned workers = 0);
+    ~ReservationServer();
+
+    // Blocks until SIGINT/SIGTERM or stop(). Returns false if the socket
+    // could not be set up (or on platforms without epoll).
+    bool run();
+    static void stop();
+
+    uint64_t getRequestsServed() const { return requestsServed.load(); }
+};
+
+#endif
@@ -0,0 +1,276 @@
+#include "RevenueAnalytics.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    struct PartialSummary {
+        int64_t revenueByType[ROOM_TYPE_COUNT] = {};
+        int roomNightsByType[ROOM_TYPE_COUNT] = {};
+        std::map<int, int64_t> revenueByMonth;
+    };
+
+    int monthKey(int dayIndex) {
+        int year, month, day;
+        civilFromDayIndex(dayIndex, year, month, day);
+        return year * 100 + month;
+    }
+
+    int nextMonthStart(int dayIndex) {
+        int year, month, day;
+        civilFromDayIndex(dayIndex, year, month, day);
+        return month == 12 ? dayIndexFromCivil(year + 1, 1, 1)
+                           : dayIndexFromCivil(year, month + 1, 1);
+    }
+
+    // Spreads perNight over the nights [fromDay, toDay), one map update per
+    // month; firstNightExtra carries the remainder cents of the first night
+    void addByMonth(std::map<int, int64_t>& byMonth, int fromDay, int toDay,
+                    int64_t perNight, int64_t firstNightExtra) {
+        int d = fromDay;
+        while (d < toDay) {
+            int monthEnd = std::min(toDay, nextMonthStart(d));
+            byMonth[monthKey(d)] += perNight * (monthEnd - d) + firstNightExtra;
+            firstNightExtra = 0;
+            d = monthEnd;
+        }
+    }
+
+    bool isSold(ReservationStatus status) {
+        return status == ReservationStatus::CONFIRMED ||
+               status == ReservationStatus::CHECKED_IN ||
+               status == ReservationStatus::CHECKED_OUT;
+    }
+
+    void initSummary(RevenueSummary& s, int fromDay, int toDay) {
+        s.fromDay = fromDay;
+        s.toDay = toDay;
+        s.totalRevenue = Money();
+        s.roomNightsSold = 0;
+        s.roomNightsAvailable = 0;
+        s.adr = Money();
+        s.revpar = Money();
+        for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+            s.revenueByType[t] = Money();
+            s.roomNightsByType[t] = 0;
+        }
+        s.revenueByMonth.clear();
+    }
+
+    void finishSummary(RevenueSummary& s, size_t roomCount) {
+        for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+            s.totalRevenue += s.revenueByType[t];
+            s.roomNightsSold += s.roomNightsByType[t];
+        }
+        s.roomNightsAvailable = static_cast<int>(roomCount) * std::max(0, s.toDay - s.fromDay);
+        s.adr = s.totalRevenue.dividedBy(s.roomNightsSold);
+        s.revpar = s.totalRevenue.dividedBy(s.roomNightsAvailable);
+    }
+
+    // Parallel scan shared by both compute() overloads; at(i) yields the
+    // i-th reservation of whichever table is being read
+    template <typename At>
+    void scanReservations(size_t count, At at, const std::unordered_map<int, int>& roomTypes,
+                          int fromDay, int toDay, unsigned threadCount, RevenueSummary& summary) {
+        // Chunks are large enough that thread start-up is noise next to the
+        // localtime conversions each reservation needs.
+        const size_t minChunk = 4096;
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        size_t chunks = std::min<size_t>(threadCount, count / minChunk + 1);
+        size_t chunkSize = (count + chunks - 1) / chunks;
+
+        std::vector<PartialSummary> partials(chunks);
+        auto worker = [&](size_t chunk) {
+            PartialSummary& p = partials[chunk];
+            size_t begin = chunk * chunkSize;
+            size_t end = std::min(count, begin + chunkSize);
+            for (size_t i = begin; i < end; ++i) {
+                const Reservation& r = at(i);
+                if (!isSold(r.getStatus())) continue;
+                auto it = roomTypes.find(r.getAssignedRoomNumber());
+                if (it == roomTypes.end()) continue;
+
+                int inDay = toDayIndex(r.getCheckInTime());
+                int outDay = toDayIndex(r.getCheckOutTime());
+                int first = std::max(inDay, fromDay);
+                int last = std::min(outDay, toDay);
+                if (last <= first) continue;
+
+                // Same split as OccupancyCalendar: remainder cents on the first night
+                int64_t cost = r.getTotalCost().getCents();
+                int64_t perNight = cost / (outDay - inDay);
+                int64_t extra = first == inDay ? cost % (outDay - inDay) : 0;
+                p.revenueByType[it->second] += perNight * (last - first) + extra;
+                p.roomNightsByType[it->second] += last - first;
+                addByMonth(p.revenueByMonth, first, last, perNight, extra);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t c = 1; c < chunks; ++c) {
+            threads.emplace_back(worker, c);
+        }
+        worker(0);
+        for (auto& t : threads) t.join();
+
+        // Integer cents: the merged totals are exact whatever the chunking
+        for (const auto& p : partials) {
+            for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+                summary.revenueByType[t] += Money::fromCents(p.revenueByType[t]);
+                summary.roomNightsByType[t] += p.roomNightsByType[t];
+            }
+            for (const auto& m : p.revenueByMonth) {
+                summary.revenueByMonth[m.first] += Money::fromCents(m.second);
+            }
+        }
+    }
+}
+
+RevenueSummary RevenueAnalytics::compute(const std::vector<Reservation>& reservations,
+                                         const std::vector<Room>& rooms,
+                                         int fromDay, int toDay,
+                                         unsigned threadCount) const {
+    RevenueSummary summary;
+    initSummary(summary, fromDay, toDay);
+    if (toDay <= fromDay) return summary;
+
+    std::unordered_map<int, int> roomTypes;
+    for (const auto& room : rooms) {
+        roomTypes[room.getRoomNumber()] = static_cast<int>(room.getType());
+    }
+    scanReservations(reservations.size(), [&](size_t i) -> const Reservation& { return reservations[i]; },
+                     roomTypes, fromDay, toDay, threadCount, summary);
+    finishSummary(summary, rooms.size());
+    return summary;
+}
+
+RevenueSummary RevenueAnalytics::compute(const HotelSnapshot& snapshot,
+                                         int fromDay, int toDay,
+                                         unsigned threadCount) const {
+    RevenueSummary summary;
+    initSummary(summary, fromDay, toDay);
+    if (toDay <= fromDay) return summary;
+
+    std::unordered_map<int, int> roomTypes;
+    for (size_t i = 0; i < snapshot.getRoomCount(); ++i) {
+        const Room& room = snapshot.roomAt(i);
+        roomTypes[room.getRoomNumber()] = static_cast<int>(room.getType());
+    }
+    scanReservations(snapshot.getReservationCount(),
+                     [&](size_t i) -> const Reservation& { return snapshot.reservationAt(i); },
+                     roomTypes, fromDay, toDay, threadCount, summary);
+    finishSummary(summary, snapshot.getRoomCount());
+    return summary;
+}
+
+void RevenueAnalytics::rebuildSeries(const OccupancyCalendar& calendar, RoomType type) {
+    DayRollup& r = rollup[static_cast<int>(type)];
+    int first = calendar.firstDay(type);
+    int end = calendar.endDay(type);
+
+    r.baseDay = first;
+    r.nights.assign(static_cast<size_t>(end - first), 0);
+    r.revenue.assign(static_cast<size_t>(end - first), 0);
+
+    int nights = 0;
+    int64_t revenue = 0;
+    for (int d = first; d < end; ++d) {
+        int dn;
+        int64_t dr;
+        calendar.deltasAt(type, d, dn, dr);
+        nights += dn;
+        revenue += dr;
+        r.nights[static_cast<size_t>(d - first)] = nights;
+        r.revenue[static_cast<size_t>(d - first)] = revenue;
+    }
+}
+
+void RevenueAnalytics::refreshSeries(const OccupancyCalendar& calendar, RoomType type,
+                                     int fromDay, int toDay) {
+    DayRollup& r = rollup[static_cast<int>(type)];
+    int first = calendar.firstDay(type);
+    int end = calendar.endDay(type);
+
+    // Follow the calendar if it grew; new cells start at zero and any that
+    // carry stays are inside the dirty range.
+    if (r.nights.empty()) {
+        r.baseDay = first;
+    } else if (first < r.baseDay) {
+        size_t grow = static_cast<size_t>(r.baseDay - first);
+        r.nights.insert(r.nights.begin(), grow, 0);
+        r.revenue.insert(r.revenue.begin(), grow, 0);
+        r.baseDay = first;
+    }
+    size_t needed = static_cast<size_t>(end - r.baseDay);
+    if (needed > r.nights.size()) {
+        r.nights.resize(needed, 0);
+        r.revenue.resize(needed, 0);
+    }
+
+    // Days before fromDay are unchanged, so resume the prefix sum from there
+    size_t i = static_cast<size_t>(fromDay - r.baseDay);
+    int nights = i > 0 ? r.nights[i - 1] : 0;
+    int64_t revenue = i > 0 ? r.revenue[i - 1] : 0;
+    for (int d = fromDay; d < toDay; ++d, ++i) {
+        int dn;
+        int64_t dr;
+        calendar.deltasAt(type, d, dn, dr);
+        nights += dn;
+        revenue += dr;
+        r.nights[i] = nights;
+        r.revenue[i] = revenue;
+    }
+}
+
+void RevenueAnalytics::refreshRollup(OccupancyCalendar& calendar) {
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        RoomType type = static_cast<RoomType>(t);
+        int fromDay, toDay;
+        bool wasReset;
+        bool changed = calendar.takeDirtyRange(type, fromDay, toDay, wasReset);
+
+        if (!rollupBuilt || wasReset) {
+            rebuildSeries(calendar, type);
+        } else if (changed) {
+            refreshSeries(calendar, type, fromDay, toDay);
+        }
+    }
+    rollupBuilt = true;
+}
+
+RevenueSummary RevenueAnalytics::computeCached(OccupancyCalendar& calendar,
+                                               const std::vector<Room>& rooms,
+                                               int fromDay, int toDay) {
+    refreshRollup(calendar);
+
+    RevenueSummary summary;
+    initSummary(summary, fromDay, toDay);
+    if (toDay <= fromDay) return summary;
+
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        const DayRollup& r = rollup[t];
+        int first = std::max(fromDay, r.baseDay);
+        int last = std::min(toDay, r.baseDay + static_cast<int>(r.nights.size()));
+
+        // One kernel call per month segment of the contiguous revenue column
+        int d = first;
+        while (d < last) {
+            int monthEnd = std::min(last, nextMonthStart(d));
+            size_t i = static_cast<size_t>(d - r.baseDay);
+            size_t n = static_cast<size_t>(monthEnd - d);
+
+            int nights = 0;
+            for (size_t k = 0; k < n; ++k) nights += r.nights[i + k];
+            Money revenue = Money::fromCents(sumCents(&r.revenue[i], n));
+
+            summary.roomNightsByType[t] += nights;
+            summary.revenueByType[t] += revenue;
+            if (nights > 0) summary.revenueByMonth[monthKey(d)] += revenue;
+            d = monthEnd;
+        }
+    }
+
+    finishSummary(summary, rooms.size());
+    return summary;
+}
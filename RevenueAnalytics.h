@@ -0,0 +1,62 @@
+#ifndef REVENUE_ANALYTICS_H
+#define REVENUE_ANALYTICS_H
+
+#include "Reservation.h"
+#include "Room.h"
+#include "OccupancyCalendar.h"
+#include "HotelSnapshot.h"
+#include "Money.h"
+#include <vector>
+#include <map>
+#include <cstdint>
+
+struct RevenueSummary {
+    int fromDay;
+    int toDay;
+    Money totalRevenue;
+    int roomNightsSold;
+    int roomNightsAvailable;
+    Money adr;     // average daily rate: revenue / room-nights sold
+    Money revpar;  // revenue per available room-night
+    Money revenueByType[ROOM_TYPE_COUNT];
+    int roomNightsByType[ROOM_TYPE_COUNT];
+    std::map<int, Money> revenueByMonth;  // key: YYYYMM
+};
+
+// Financial reporting over the reservation set. compute() is a parallel
+// chunked scan over the hot reservation columns; computeCached() answers
+// from a per-day rollup that is refreshed only for the days the occupancy
+// calendar reports as touched since the previous call.
+class RevenueAnalytics {
+private:
+    struct DayRollup {
+        int baseDay = 0;
+        std::vector<int> nights;
+        std::vector<int64_t> revenue;  // cents
+    };
+
+    DayRollup rollup[ROOM_TYPE_COUNT];
+    bool rollupBuilt = false;
+
+    void refreshRollup(OccupancyCalendar& calendar);
+    void rebuildSeries(const OccupancyCalendar& calendar, RoomType type);
+    void refreshSeries(const OccupancyCalendar& calendar, RoomType type, int fromDay, int toDay);
+
+public:
+    RevenueSummary compute(const std::vector<Reservation>& reservations,
+                           const std::vector<Room>& rooms,
+                           int fromDay, int toDay,
+                           unsigned threadCount = 0) const;
+    // Same scan over a pinned snapshot; needs no hotel locks
+    RevenueSummary compute(const HotelSnapshot& snapshot,
+                           int fromDay, int toDay,
+                           unsigned threadCount = 0) const;
+
+    RevenueSummary computeCached(OccupancyCalendar& calendar,
+                                 const std::vector<Room>& rooms,
+                                 int fromDay, int toDay);
+
+    void invalidate() { rollupBuilt = false; }
+};
+
+#endif
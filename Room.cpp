@@ -1,4 +1,6 @@
 #include "Room.h"
+#include "Metrics.h"
+#include "ReportBuffer.h"
 #include <sstream>
 #include <algorithm>
 #include <cctype>
@@ -29,9 +31,9 @@ namespace {
     }
 }
 
-Room::Room() : roomNumber(0), type(RoomType::SINGLE), pricePerNight(0.0) {}
+Room::Room() : roomNumber(0), type(RoomType::SINGLE), pricePerNight() {}
 
-Room::Room(int number, RoomType type, double price)
+Room::Room(int number, RoomType type, Money price)
     : roomNumber(number), type(type), pricePerNight(price) {}
 
 void Room::addReservation(int reservationId) {
@@ -56,10 +58,15 @@ std::string Room::getTypeString() const {
 }
 
 void Room::display() const {
-    std::cout << "Room Number: " << roomNumber << "\n"
-              << "Type: " << getTypeString() << "\n"
-              << "Price per Night: $" << pricePerNight << "\n"
-              << "Active Reservations: " << reservationIds.size() << "\n";
+    ReportBuffer out(std::cout);
+    render(out);
+}
+
+void Room::render(ReportBuffer& out) const {
+    out << "Room Number: " << roomNumber << "\n"
+        << "Type: " << getTypeString() << "\n"
+        << "Price per Night: $" << pricePerNight << "\n"
+        << "Active Reservations: " << reservationIds.size() << "\n";
 }
 
 std::string Room::serialize() const {
@@ -79,10 +86,12 @@ std::string Room::serialize() const {
 }
 
 Room Room::deserialize(const std::string& data) {
+    HOTEL_TIME_SCOPE(Timer::DESERIALIZE_ROOM);
+    HOTEL_COUNT(Counter::RECORDS_PARSED, 1);
     Room room;
     long long roomNum = 0;
     long long typeVal = 0;
-    double priceVal = 0.0;
+    Money priceVal;
 
     if (extractJsonNumber(data, "roomNumber", roomNum)) {
         room.roomNumber = static_cast<int>(roomNum);
@@ -106,10 +115,9 @@ Room Room::deserialize(const std::string& data) {
                         data[end] == '.' || data[end] == 'e' || data[end] == 'E')) {
                     ++end;
                 }
-                try {
-                    priceVal = std::stod(data.substr(pos, end - pos));
-                } catch (...) {
-                    priceVal = 0.0;
+                // Exact decimal parse: legacy files hold the price as a double
+                if (!Money::parse(data.substr(pos, end - pos), priceVal)) {
+                    priceVal = Money();
                 }
             }
         }
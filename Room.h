@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include "Money.h"
+
+class ReportBuffer;
 
 enum class RoomType {
     SINGLE,
@@ -12,26 +15,29 @@ enum class RoomType {
     DELUXE
 };
 
+const int ROOM_TYPE_COUNT = 4;
+
 class Room {
 private:
     int roomNumber;
     RoomType type;
-    double pricePerNight;
+    Money pricePerNight;
     std::vector<int> reservationIds;
 
 public:
     Room();
-    Room(int number, RoomType type, double price);
+    Room(int number, RoomType type, Money price);
 
     int getRoomNumber() const { return roomNumber; }
     RoomType getType() const { return type; }
-    double getPricePerNight() const { return pricePerNight; }
+    Money getPricePerNight() const { return pricePerNight; }
     const std::vector<int>& getReservationIds() const { return reservationIds; }
 
     void addReservation(int reservationId);
     void removeReservation(int reservationId);
 
     void display() const;
+    void render(ReportBuffer& out) const;
     std::string getTypeString() const;
 
     std::string serialize() const;
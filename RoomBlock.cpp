@@ -0,0 +1,138 @@
+#include "RoomBlock.h"
+#include "DateUtils.h"
+#include <sstream>
+#include <cctype>
+
+namespace {
+    std::string escapeJson(const std::string& input) {
+        std::string out;
+        out.reserve(input.size());
+        for (char c : input) {
+            switch (c) {
+                case '\"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:   out += c; break;
+            }
+        }
+        return out;
+    }
+
+    std::string unescapeJson(const std::string& input) {
+        std::string out;
+        out.reserve(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            char c = input[i];
+            if (c == '\\' && i + 1 < input.size()) {
+                char n = input[++i];
+                switch (n) {
+                    case '\"': out += '\"'; break;
+                    case '\\': out += '\\'; break;
+                    case 'b':  out += '\b'; break;
+                    case 'f':  out += '\f'; break;
+                    case 'n':  out += '\n'; break;
+                    case 'r':  out += '\r'; break;
+                    case 't':  out += '\t'; break;
+                    default:   out += n; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    bool extractJsonString(const std::string& json, const std::string& key, std::string& out) {
+        std::string pattern = "\"" + key + "\"";
+        size_t pos = json.find(pattern);
+        if (pos == std::string::npos) return false;
+        pos = json.find(':', pos);
+        if (pos == std::string::npos) return false;
+        pos = json.find('\"', pos);
+        if (pos == std::string::npos) return false;
+        ++pos; // move past opening quote
+        size_t end = pos;
+        bool escaped = false;
+        while (end < json.size()) {
+            char c = json[end];
+            if (c == '\\' && !escaped) {
+                escaped = true;
+            } else if (c == '\"' && !escaped) {
+                break;
+            } else {
+                escaped = false;
+            }
+            ++end;
+        }
+        if (end >= json.size()) return false;
+        out = unescapeJson(json.substr(pos, end - pos));
+        return true;
+    }
+
+    bool extractJsonNumber(const std::string& json, const std::string& key, long long& out) {
+        std::string pattern = "\"" + key + "\"";
+        size_t pos = json.find(pattern);
+        if (pos == std::string::npos) return false;
+        pos = json.find(':', pos);
+        if (pos == std::string::npos) return false;
+        ++pos;
+        while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos]))) ++pos;
+        size_t end = pos;
+        while (end < json.size() &&
+               (std::isdigit(static_cast<unsigned char>(json[end])) ||
+                json[end] == '-' || json[end] == '+' ||
+                json[end] == '.' || json[end] == 'e' || json[end] == 'E')) {
+            ++end;
+        }
+        if (end == pos) return false;
+        try {
+            out = std::stoll(json.substr(pos, end - pos));
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+}
+
+time_t RoomBlock::startTime() const {
+    return fromDayIndex(fromDay, HANDOVER_HOUR);
+}
+
+time_t RoomBlock::endTime() const {
+    return fromDayIndex(toDay, HANDOVER_HOUR);
+}
+
+std::string RoomBlock::serialize() const {
+    std::ostringstream ss;
+    ss << "{";
+    ss << "\"id\":" << id << ",";
+    ss << "\"roomNumber\":" << roomNumber << ",";
+    ss << "\"fromDay\":" << fromDay << ",";
+    ss << "\"toDay\":" << toDay << ",";
+    ss << "\"reason\":\"" << escapeJson(reason) << "\"";
+    ss << "}";
+    return ss.str();
+}
+
+bool RoomBlock::deserialize(const std::string& data, RoomBlock& out) {
+    long long idVal = 0, roomVal = 0, fromVal = 0, toVal = 0;
+    if (!extractJsonNumber(data, "id", idVal) ||
+        !extractJsonNumber(data, "roomNumber", roomVal) ||
+        !extractJsonNumber(data, "fromDay", fromVal) ||
+        !extractJsonNumber(data, "toDay", toVal)) {
+        return false;
+    }
+    if (idVal <= 0 || toVal <= fromVal) return false;
+
+    out.id = static_cast<int>(idVal);
+    out.roomNumber = static_cast<int>(roomVal);
+    out.fromDay = static_cast<int>(fromVal);
+    out.toDay = static_cast<int>(toVal);
+    out.reason.clear();
+    extractJsonString(data, "reason", out.reason);
+    return true;
+}
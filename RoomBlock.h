@@ -0,0 +1,29 @@
+#ifndef ROOM_BLOCK_H
+#define ROOM_BLOCK_H
+
+#include <ctime>
+#include <string>
+
+// A room taken out of service (maintenance, renovation) for the nights
+// [fromDay, toDay), day indices as in DateUtils.h. The Scheduler keeps
+// blocks in the same per-room interval index as stays, so every booking
+// path and availability query steps around them.
+struct RoomBlock {
+    // Blocks start and end at noon, between the usual 11:00 check-out and
+    // 14:00 check-in, so stays ending or starting on a boundary day still fit
+    static const int HANDOVER_HOUR = 12;
+
+    int id = 0;
+    int roomNumber = 0;
+    int fromDay = 0;
+    int toDay = 0;
+    std::string reason;
+
+    time_t startTime() const;
+    time_t endTime() const;
+
+    std::string serialize() const;
+    static bool deserialize(const std::string& data, RoomBlock& out);
+};
+
+#endif
@@ -1,45 +1,324 @@
 #include "Scheduler.h"
+#include "DateUtils.h"
+#include "Metrics.h"
+#include "ReportBuffer.h"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <unordered_set>
 
-Scheduler::Scheduler(std::vector<Room>& roomsRef,
-                     std::vector<Reservation>& reservationsRef)
-    : rooms(roomsRef), reservations(reservationsRef) {}
+namespace {
+    // Chooses the intervals [start, end) with the largest total value such
+    // that no more than capacity of them are open at any moment. This is a
+    // min-cost flow of capacity units along the sorted time points: a unit
+    // either idles to the next point at no cost, or takes an interval edge
+    // whose cost is minus its value. Edges only go forward in time, so one
+    // pass in time order gives the first potentials. After that, each
+    // augmentation is a Dijkstra search on reduced costs, and there are at
+    // most capacity augmentations.
+    std::vector<bool> selectMostValuable(const std::vector<std::pair<time_t, time_t>>& intervals,
+                                         const std::vector<int64_t>& values, int capacity) {
+        std::vector<bool> chosen(intervals.size(), false);
+        if (intervals.empty() || capacity <= 0) return chosen;
 
-bool Scheduler::canAssignToRoom(const Reservation& res, const Room& room) const {
-    // Check if this reservation overlaps with any reservation already in this room
-    for (int resId : room.getReservationIds()) {
-        for (const auto& existingRes : reservations) {
-            if (existingRes.getId() == resId &&
-                existingRes.getStatus() != ReservationStatus::CANCELLED &&
-                existingRes.getStatus() != ReservationStatus::CHECKED_OUT) {
-                if (res.overlaps(existingRes)) {
-                    return false;
+        std::vector<time_t> times;
+        times.reserve(intervals.size() * 2);
+        for (const auto& iv : intervals) {
+            times.push_back(iv.first);
+            times.push_back(iv.second);
+        }
+        std::sort(times.begin(), times.end());
+        times.erase(std::unique(times.begin(), times.end()), times.end());
+        auto node = [&](time_t t) {
+            return static_cast<int>(std::lower_bound(times.begin(), times.end(), t) - times.begin());
+        };
+
+        struct Edge {
+            int to;
+            int capacity;
+            int64_t cost;
+        };
+        const int nodes = static_cast<int>(times.size());
+        std::vector<Edge> edges;  // edge e and its reverse e ^ 1
+        std::vector<std::vector<int>> out(nodes);
+        auto addEdge = [&](int from, int to, int cap, int64_t cost) {
+            out[from].push_back(static_cast<int>(edges.size()));
+            edges.push_back({to, cap, cost});
+            out[to].push_back(static_cast<int>(edges.size()));
+            edges.push_back({from, 0, -cost});
+        };
+        for (int v = 0; v + 1 < nodes; ++v) addEdge(v, v + 1, capacity, 0);
+        std::vector<int> intervalEdge(intervals.size());
+        for (size_t i = 0; i < intervals.size(); ++i) {
+            intervalEdge[i] = static_cast<int>(edges.size());
+            addEdge(node(intervals[i].first), node(intervals[i].second), 1, -values[i]);
+        }
+
+        const int64_t unreachable = std::numeric_limits<int64_t>::max();
+        std::vector<int64_t> potential(nodes, unreachable);
+        potential[0] = 0;
+        for (int v = 0; v < nodes; ++v) {
+            for (int e : out[v]) {
+                if (edges[e].capacity > 0 && potential[v] + edges[e].cost < potential[edges[e].to]) {
+                    potential[edges[e].to] = potential[v] + edges[e].cost;
                 }
             }
         }
+
+        typedef std::pair<int64_t, int> Entry;
+        std::vector<int64_t> dist(nodes);
+        std::vector<int> via(nodes);
+        int remaining = capacity;
+        while (remaining > 0) {
+            std::fill(dist.begin(), dist.end(), unreachable);
+            std::fill(via.begin(), via.end(), -1);
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+            dist[0] = 0;
+            queue.push({0, 0});
+            while (!queue.empty()) {
+                Entry top = queue.top();
+                queue.pop();
+                int v = top.second;
+                if (top.first > dist[v]) continue;
+                for (int e : out[v]) {
+                    const Edge& edge = edges[e];
+                    if (edge.capacity <= 0) continue;
+                    int64_t d = dist[v] + edge.cost + potential[v] - potential[edge.to];
+                    if (d < dist[edge.to]) {
+                        dist[edge.to] = d;
+                        via[edge.to] = e;
+                        queue.push({d, edge.to});
+                    }
+                }
+            }
+            if (dist[nodes - 1] == unreachable) break;
+            for (int v = 0; v < nodes; ++v) {
+                if (dist[v] != unreachable) potential[v] += dist[v];
+            }
+
+            int push = remaining;
+            for (int v = nodes - 1; v != 0; v = edges[via[v] ^ 1].to) push = std::min(push, edges[via[v]].capacity);
+            for (int v = nodes - 1; v != 0; v = edges[via[v] ^ 1].to) {
+                edges[via[v]].capacity -= push;
+                edges[via[v] ^ 1].capacity += push;
+            }
+            remaining -= push;
+        }
+
+        for (size_t i = 0; i < intervals.size(); ++i) chosen[i] = edges[intervalEdge[i]].capacity == 0;
+        return chosen;
+    }
+}
+
+Scheduler::Scheduler(std::vector<Room>& roomsRef,
+                     std::vector<Reservation>& reservationsRef,
+                     std::vector<RoomBlock>& blocksRef)
+    : rooms(roomsRef), reservations(reservationsRef), blocks(blocksRef) {
+    rebuildCalendar();
+}
+
+const Room* Scheduler::findRoom(int roomNumber) const {
+    for (const auto& room : rooms) {
+        if (room.getRoomNumber() == roomNumber) return &room;
+    }
+    return nullptr;
+}
+
+Reservation* Scheduler::findReservation(int reservationId) {
+    return const_cast<Reservation*>(static_cast<const Scheduler*>(this)->findReservation(reservationId));
+}
+
+const Reservation* Scheduler::findReservation(int reservationId) const {
+    // Ids are handed out in order, so until something is deleted a
+    // reservation sits at position id - 1
+    size_t guess = static_cast<size_t>(reservationId) - 1;
+    if (reservationId > 0 && guess < reservations.size() && reservations[guess].getId() == reservationId) {
+        return &reservations[guess];
+    }
+    for (const auto& r : reservations) {
+        if (r.getId() == reservationId) return &r;
+    }
+    return nullptr;
+}
+
+bool Scheduler::countsAsSold(const Reservation& res) {
+    // Checked-out stays remain sold room-nights for reporting purposes
+    return res.getAssignedRoomNumber() > 0 &&
+           (res.getStatus() == ReservationStatus::CONFIRMED ||
+            res.getStatus() == ReservationStatus::CHECKED_IN ||
+            res.getStatus() == ReservationStatus::CHECKED_OUT);
+}
+
+bool Scheduler::blocksRoom(const Reservation& res) {
+    return res.getAssignedRoomNumber() > 0 &&
+           (res.getStatus() == ReservationStatus::CONFIRMED ||
+            res.getStatus() == ReservationStatus::CHECKED_IN);
+}
+
+bool Scheduler::canAssignToRoom(const Reservation& res, const Room& room, Fit* fit) const {
+    HOTEL_TIME_SCOPE(Timer::CAN_ASSIGN_TO_ROOM);
+    // Stays in one room never overlap, so only the neighbours of the new
+    // check-in time can collide with it
+    const RoomStays& stays = roomStays[roomIndex(room)];
+    uint64_t overlapChecks = 0;
+    bool free = true;
+    Fit measured;
+    auto next = stays.lower_bound(res.getCheckInTime());
+    if (next != stays.end()) {
+        ++overlapChecks;
+        free = next->first >= res.getCheckOutTime();
+        measured.leftover += next->first - res.getCheckOutTime();
+    } else {
+        ++measured.openSides;
+    }
+    if (free && next != stays.begin()) {
+        ++overlapChecks;
+        time_t previousOut = std::prev(next)->second.checkOut;
+        free = previousOut <= res.getCheckInTime();
+        measured.leftover += res.getCheckInTime() - previousOut;
+    } else {
+        ++measured.openSides;
+    }
+    HOTEL_COUNT(Counter::OVERLAP_CHECKS, overlapChecks);
+    if (fit) *fit = measured;
+    return free;
+}
+
+Room* Scheduler::chooseRoom(const Reservation& res, int type) {
+    Room* best = nullptr;
+    Fit bestFit;
+    auto consider = [&](Room& room) {
+        Fit fit;
+        if (!canAssignToRoom(res, room, policy == AssignmentPolicy::BEST_FIT ? &fit : nullptr)) return false;
+        if (policy == AssignmentPolicy::FIRST_FIT) {
+            best = &room;
+            return true;
+        }
+        if (!best || fit.openSides < bestFit.openSides ||
+            (fit.openSides == bestFit.openSides && fit.leftover < bestFit.leftover)) {
+            best = &room;
+            bestFit = fit;
+        }
+        return fit.openSides == 0 && fit.leftover == 0;  // cannot do better than a perfect fit
+    };
+
+    if (type >= 0) {
+        for (size_t index : roomsOfType[type]) {
+            if (consider(rooms[index])) break;
+        }
+    } else {
+        for (auto& room : rooms) {
+            if (consider(room)) break;
+        }
+    }
+    return best;
+}
+
+bool Scheduler::removeStay(size_t room, time_t checkIn, int reservationId) {
+    RoomStays& stays = roomStays[room];
+    auto range = stays.equal_range(checkIn);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.reservationId == reservationId) {
+            stays.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unordered_map<int, size_t> Scheduler::indexRoomsByNumber() const {
+    std::unordered_map<int, size_t> byNumber;
+    for (size_t i = 0; i < rooms.size(); ++i) byNumber[rooms[i].getRoomNumber()] = i;
+    return byNumber;
+}
+
+void Scheduler::addToWaitlist(const Reservation& res) {
+    if (res.getRequestedType() < 0 || res.getRequestedType() >= ROOM_TYPE_COUNT) return;
+    waitlist.add(static_cast<RoomType>(res.getRequestedType()), res.getId(), reservationIndex(res),
+                 res.getCheckInTime(), res.getCheckOutTime());
+}
+
+void Scheduler::promoteInto(size_t room, time_t freedIn, time_t freedOut, std::vector<size_t>* promoted) {
+    RoomStays& stays = roomStays[room];
+    RoomType type = rooms[room].getType();
+
+    // The free gap around the released nights, bounded by the neighbours
+    auto next = stays.lower_bound(freedIn);
+    time_t gapEnd = next == stays.end() ? std::numeric_limits<time_t>::max() : next->first;
+    time_t gapStart = next == stays.begin() ? std::numeric_limits<time_t>::min()
+                                            : std::prev(next)->second.checkOut;
+    // Nothing on the waitlist may start in the past, and nights that have
+    // begun stay sold to whoever held them (a checked-out guest included)
+    time_t now = time(nullptr);
+    gapStart = std::max(gapStart, now);
+    freedIn = std::max(freedIn, gapStart);
+    freedOut = std::min(freedOut, gapEnd);
+
+    struct Gap {
+        time_t start, end, freedIn, freedOut;
+    };
+    std::vector<Gap> gaps = {{gapStart, gapEnd, freedIn, freedOut}};
+    while (!gaps.empty()) {
+        Gap gap = gaps.back();
+        gaps.pop_back();
+        if (gap.freedIn >= gap.freedOut) continue;
+
+        Waitlist::Entry entry;
+        if (!waitlist.takeBestFit(type, gap.start, gap.end, gap.freedIn, gap.freedOut, entry)) continue;
+
+        if (entry.index >= reservations.size() ||
+            reservations[entry.index].getId() != entry.reservationId ||
+            reservations[entry.index].getStatus() != ReservationStatus::PENDING) {
+            gaps.push_back(gap);  // stale entry; it is off the list now, so look again
+            continue;
+        }
+        assignToRoom(reservations[entry.index], rooms[room]);
+        if (promoted) promoted->push_back(entry.index);
+
+        // The stay splits the gap; either side may still fit someone
+        gaps.push_back({gap.start, entry.checkIn, gap.freedIn, std::min(gap.freedOut, entry.checkIn)});
+        gaps.push_back({entry.checkOut, gap.end, std::max(gap.freedIn, entry.checkOut), gap.freedOut});
     }
-    return true;
 }
 
 // Helper to assign a reservation to a concrete room
-static void assignToRoom(Reservation& res, Room& room) {
+void Scheduler::assignToRoom(Reservation& res, Room& room) {
     room.addReservation(res.getId());
     res.setAssignedRoomNumber(room.getRoomNumber());
     res.setStatus(ReservationStatus::CONFIRMED);
-    double cost = res.getDuration() * room.getPricePerNight();
+    int inDay = toDayIndex(res.getCheckInTime());
+    int outDay = toDayIndex(res.getCheckOutTime());
+    Money cost = rateCalendar
+        ? rateCalendar->quoteStay(room.getType(), room.getPricePerNight(), inDay, outDay)
+        : room.getPricePerNight() * res.getDuration();
     res.setTotalCost(cost);
+    calendar.addStay(room.getType(), inDay, outDay, cost);
+    roomStays[roomIndex(room)].emplace(res.getCheckInTime(), Stay{res.getCheckOutTime(), res.getId()});
 }
 
 void Scheduler::scheduleReservations() {
+    HOTEL_TIME_SCOPE(Timer::SCHEDULE_RESERVATIONS);
+    // The caller has emptied the rooms of all but the in-house guests;
+    // index what is left and start a fresh waitlist from whatever this pass
+    // cannot place
+    rebuildIndex();
+    waitlist.clear();
+
     // Left Edge algorithm over ALL rooms (no type preference)
     std::vector<Reservation*> active;
     active.reserve(reservations.size());
 
     for (auto& r : reservations) {
         if (r.getStatus() == ReservationStatus::CANCELLED ||
-            r.getStatus() == ReservationStatus::CHECKED_OUT) {
+            r.getStatus() == ReservationStatus::CHECKED_OUT ||
+            r.getStatus() == ReservationStatus::CHECKED_IN) {
             continue;
         }
         active.push_back(&r);
@@ -52,90 +331,194 @@ void Scheduler::scheduleReservations() {
 
     for (auto* resPtr : active) {
         Reservation& res = *resPtr;
-        bool assigned = false;
+        Room* room = chooseRoom(res, -1);
+        if (room) {
+            assignToRoom(res, *room);
+        } else {
+            res.setAssignedRoomNumber(-1);
+            res.setStatus(ReservationStatus::PENDING);
+            res.setTotalCost(Money());
+            addToWaitlist(res);
+        }
+    }
 
-        for (auto& room : rooms) {
-            if (canAssignToRoom(res, room)) {
-                assignToRoom(res, room);
-                assigned = true;
-                break;
+    // Bulk pass: cheaper to recount once than to patch the calendar per move
+    rebuildCalendar();
+}
+
+void Scheduler::scheduleReservationsForRevenue() {
+    HOTEL_TIME_SCOPE(Timer::SCHEDULE_RESERVATIONS);
+    // In-house guests keep their rooms: rebuildIndex() puts their stays in
+    // roomStays, where the solver below treats them like blocks
+    std::vector<Reservation*> byType[ROOM_TYPE_COUNT];
+    std::vector<Reservation*> untyped;
+    std::vector<Reservation*> empty;
+    for (auto& r : reservations) {
+        if (r.getStatus() == ReservationStatus::CANCELLED ||
+            r.getStatus() == ReservationStatus::CHECKED_OUT ||
+            r.getStatus() == ReservationStatus::CHECKED_IN) {
+            continue;
+        }
+        r.setAssignedRoomNumber(-1);
+        r.setStatus(ReservationStatus::PENDING);
+        r.setTotalCost(Money());
+        int type = r.getRequestedType();
+        if (r.getCheckOutTime() <= r.getCheckInTime()) {
+            empty.push_back(&r);
+        } else if (type >= 0 && type < ROOM_TYPE_COUNT) {
+            byType[type].push_back(&r);
+        } else {
+            untyped.push_back(&r);
+        }
+    }
+    rebuildIndex();
+    waitlist.clear();
+    // Stays without nights are not offered to the solver; they wait like
+    // the stays it leaves out
+    for (Reservation* r : empty) addToWaitlist(*r);
+
+    auto byCheckIn = [](const Reservation* a, const Reservation* b) {
+        return a->getCheckInTime() < b->getCheckInTime();
+    };
+
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        if (roomsOfType[t].empty() || byType[t].empty()) continue;
+        RoomType type = static_cast<RoomType>(t);
+        Money price = rooms[roomsOfType[t].front()].getPricePerNight();
+        for (size_t index : roomsOfType[t]) price = std::min(price, rooms[index].getPricePerNight());
+
+        // Blocks enter as intervals worth more than every stay together, so
+        // the solver always keeps them and only fills the rooms around them
+        std::vector<std::pair<time_t, time_t>> intervals;
+        std::vector<int64_t> values;
+        int64_t total = 0;
+        for (const Reservation* r : byType[t]) {
+            int inDay = toDayIndex(r->getCheckInTime());
+            int outDay = toDayIndex(r->getCheckOutTime());
+            Money quote = rateCalendar ? rateCalendar->quoteStay(type, price, inDay, outDay)
+                                       : price * r->getDuration();
+            intervals.push_back({r->getCheckInTime(), r->getCheckOutTime()});
+            values.push_back(quote.getCents());
+            total += quote.getCents();
+        }
+        for (size_t index : roomsOfType[t]) {
+            for (const auto& stay : roomStays[index]) {
+                intervals.push_back({stay.first, stay.second.checkOut});
+                values.push_back(total + 1);
             }
         }
+        std::vector<bool> chosen = selectMostValuable(intervals, values, static_cast<int>(roomsOfType[t].size()));
 
-        if (!assigned) {
-            res.setAssignedRoomNumber(-1);
-            res.setStatus(ReservationStatus::PENDING);
-            res.setTotalCost(0.0);
+        // Left edge over the chosen stays. There are never more of them open
+        // at once than rooms, so only blocks can leave one without a room
+        std::vector<Reservation*> keep, wait;
+        for (size_t i = 0; i < byType[t].size(); ++i) (chosen[i] ? keep : wait).push_back(byType[t][i]);
+        std::sort(keep.begin(), keep.end(), byCheckIn);
+        for (Reservation* r : keep) {
+            if (Room* room = chooseRoom(*r, t)) {
+                assignToRoom(*r, *room);
+            } else {
+                addToWaitlist(*r);
+            }
         }
+        for (Reservation* r : wait) addToWaitlist(*r);
     }
+
+    // Stays that never named a type take whatever room is left
+    std::sort(untyped.begin(), untyped.end(), byCheckIn);
+    for (Reservation* r : untyped) {
+        if (Room* room = chooseRoom(*r, -1)) assignToRoom(*r, *room);
+    }
+
+    rebuildCalendar();
 }
 
 bool Scheduler::scheduleReservation(int reservationId) {
+    HOTEL_TIME_SCOPE(Timer::SCHEDULE_RESERVATION);
     // Old behaviour: no type filter
-    Reservation* res = nullptr;
-    for (auto& r : reservations) {
-        if (r.getId() == reservationId) {
-            res = &r;
-            break;
-        }
-    }
+    Reservation* res = findReservation(reservationId);
     if (!res) return false;
 
-    for (auto& room : rooms) {
-        if (canAssignToRoom(*res, room)) {
-            assignToRoom(*res, room);
-            return true;
-        }
+    if (Room* room = chooseRoom(*res, -1)) {
+        assignToRoom(*res, *room);
+        return true;
     }
 
     res->setAssignedRoomNumber(-1);
     res->setStatus(ReservationStatus::PENDING);
-    res->setTotalCost(0.0);
+    res->setTotalCost(Money());
+    addToWaitlist(*res);
     return false;
 }
 
 bool Scheduler::scheduleReservation(int reservationId, RoomType preferredType) {
+    HOTEL_TIME_SCOPE(Timer::SCHEDULE_RESERVATION);
     // NEW behaviour: only consider rooms of the chosen type
-    Reservation* res = nullptr;
-    for (auto& r : reservations) {
-        if (r.getId() == reservationId) {
-            res = &r;
-            break;
-        }
-    }
+    Reservation* res = findReservation(reservationId);
     if (!res) return false;
 
-    // Left-Edge style: first suitable room of that type
-    for (auto& room : rooms) {
-        if (room.getType() != preferredType) continue;
-        if (canAssignToRoom(*res, room)) {
-            assignToRoom(*res, room);
-            return true;
-        }
+    // Left-Edge style: a suitable room of that type, picked by the policy
+    if (Room* room = chooseRoom(*res, static_cast<int>(preferredType))) {
+        assignToRoom(*res, *room);
+        return true;
     }
 
-    // No room of that type available in that time range
+    // No room of that type available in that time range: wait for one
     res->setAssignedRoomNumber(-1);
     res->setStatus(ReservationStatus::PENDING);
-    res->setTotalCost(0.0);
+    res->setTotalCost(Money());
+    res->setRequestedType(static_cast<int>(preferredType));
+    addToWaitlist(*res);
     return false;
 }
 
-void Scheduler::removeReservation(int reservationId) {
-    // Find reservation
-    Reservation* res = nullptr;
-    for (auto& r : reservations) {
-        if (r.getId() == reservationId) {
-            res = &r;
-            break;
-        }
+std::vector<size_t> Scheduler::findGroupRooms(const std::vector<RoomType>& types,
+                                              time_t checkIn, time_t checkOut) const {
+    HOTEL_TIME_SCOPE(Timer::SCHEDULE_RESERVATION);
+    std::vector<size_t> wanted[ROOM_TYPE_COUNT];  // positions in types, per type
+    for (size_t i = 0; i < types.size(); ++i) wanted[static_cast<int>(types[i])].push_back(i);
+    size_t needed[ROOM_TYPE_COUNT];
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) needed[t] = wanted[t].size();
+
+    Reservation probe(0, 0, checkIn, checkOut, -1, ReservationStatus::PENDING, Money());
+    std::vector<size_t> picked(types.size());
+    size_t remaining = types.size();
+    for (size_t r = 0; r < rooms.size() && remaining > 0; ++r) {
+        int t = static_cast<int>(rooms[r].getType());
+        if (needed[t] == 0 || !canAssignToRoom(probe, rooms[r])) continue;
+        picked[wanted[t][wanted[t].size() - needed[t]]] = r;
+        --needed[t];
+        --remaining;
     }
+    if (remaining > 0) picked.clear();
+    return picked;
+}
+
+void Scheduler::assignGroup(const std::vector<size_t>& reservationIndices,
+                            const std::vector<size_t>& roomIndices) {
+    for (size_t i = 0; i < reservationIndices.size() && i < roomIndices.size(); ++i) {
+        assignToRoom(reservations[reservationIndices[i]], rooms[roomIndices[i]]);
+    }
+}
+
+void Scheduler::removeReservation(int reservationId, std::vector<size_t>* promoted) {
+    Reservation* res = findReservation(reservationId);
     if (!res) return;
 
+    if (res->getStatus() == ReservationStatus::PENDING && res->getRequestedType() >= 0) {
+        waitlist.remove(static_cast<RoomType>(res->getRequestedType()), reservationId);
+    }
+
     // Remove from its room (if any)
+    size_t freedRoom = rooms.size();
     if (res->getAssignedRoomNumber() != -1) {
         for (auto& room : rooms) {
             if (room.getRoomNumber() == res->getAssignedRoomNumber()) {
+                if (countsAsSold(*res)) {
+                    calendar.removeStay(room.getType(), toDayIndex(res->getCheckInTime()),
+                                        toDayIndex(res->getCheckOutTime()), res->getTotalCost());
+                }
+                if (removeStay(roomIndex(room), res->getCheckInTime(), reservationId)) freedRoom = roomIndex(room);
                 room.removeReservation(reservationId);
                 break;
             }
@@ -144,69 +527,416 @@ void Scheduler::removeReservation(int reservationId) {
 
     res->setAssignedRoomNumber(-1);
     res->setStatus(ReservationStatus::CANCELLED);
-    res->setTotalCost(0.0);
+    res->setTotalCost(Money());
+
+    if (freedRoom < rooms.size()) {
+        promoteInto(freedRoom, res->getCheckInTime(), res->getCheckOutTime(), promoted);
+    }
 }
 
-void Scheduler::displaySchedule() const {
-    std::cout << "\n====== COMPLETE ROOM SCHEDULE ======\n";
+void Scheduler::releaseReservation(int reservationId, std::vector<size_t>* promoted) {
+    const Reservation* res = findReservation(reservationId);
+    if (!res) return;
     for (const auto& room : rooms) {
-        std::cout << "Room " << room.getRoomNumber()
-                  << " (" << room.getTypeString() << ", $"
-                  << room.getPricePerNight() << "/night)\n";
+        if (room.getRoomNumber() != res->getAssignedRoomNumber()) continue;
+        size_t index = roomIndex(room);
+        if (removeStay(index, res->getCheckInTime(), reservationId)) promoteInto(index, res->getCheckInTime(), res->getCheckOutTime(), promoted);
+        return;
+    }
+}
 
-        if (room.getReservationIds().empty()) {
-            std::cout << "  [No reservations]\n\n";
+Scheduler::BlockOutcome Scheduler::blockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay,
+                                              const std::string& reason, std::vector<size_t>* changed) {
+    BlockOutcome outcome;
+    if (toDay <= fromDay) return outcome;
+
+    std::unordered_map<int, size_t> roomByNumber = indexRoomsByNumber();
+    std::unordered_map<int, size_t> reservationById;
+    for (size_t i = 0; i < reservations.size(); ++i) reservationById[reservations[i].getId()] = i;
+
+    RoomBlock block;
+    block.fromDay = fromDay;
+    block.toDay = toDay;
+    block.reason = reason;
+    time_t start = block.startTime();
+    time_t end = block.endTime();
+
+    std::vector<std::pair<size_t, RoomType>> displaced;
+    for (int number : roomNumbers) {
+        auto found = roomByNumber.find(number);
+        if (found == roomByNumber.end()) {
+            ++outcome.unknown;
             continue;
         }
+        Room& room = rooms[found->second];
+        RoomStays& stays = roomStays[found->second];
 
-        for (int resId : room.getReservationIds()) {
-            for (const auto& r : reservations) {
-                if (r.getId() == resId) {
-                    std::cout << "  - Reservation #" << r.getId()
-                              << " [Customer " << r.getCustomerId() << "] "
-                              << r.getStatusString() << "\n";
-                    break;
-                }
+        // Whatever overlaps [start, end): the stay before start if it runs
+        // past it, then everything checking in before end
+        auto first = stays.lower_bound(start);
+        if (first != stays.begin() && std::prev(first)->second.checkOut > start) --first;
+        auto last = stays.lower_bound(end);
+
+        bool movable = true;
+        for (auto it = first; it != last && movable; ++it) {
+            int id = it->second.reservationId;
+            movable = id > 0 && reservations[reservationById[id]].getStatus() == ReservationStatus::CONFIRMED;
+        }
+        if (!movable) {
+            ++outcome.skipped;
+            continue;
+        }
+
+        for (auto it = first; it != last; it = stays.erase(it)) {
+            size_t index = reservationById[it->second.reservationId];
+            Reservation& res = reservations[index];
+            calendar.removeStay(room.getType(), toDayIndex(res.getCheckInTime()),
+                                toDayIndex(res.getCheckOutTime()), res.getTotalCost());
+            room.removeReservation(res.getId());
+            res.setAssignedRoomNumber(-1);
+            res.setStatus(ReservationStatus::PENDING);
+            res.setTotalCost(Money());
+            displaced.emplace_back(index, room.getType());
+        }
+
+        block.id = nextBlockId++;
+        block.roomNumber = number;
+        stays.emplace(start, Stay{end, -block.id});
+        blocks.push_back(block);
+        ++outcome.blocked;
+    }
+
+    // Only now are all the blocks in place, so no stay lands in a room
+    // that is about to be blocked
+    for (const auto& d : displaced) {
+        if (scheduleReservation(reservations[d.first].getId(), d.second)) ++outcome.moved;
+        else ++outcome.waitlisted;
+        if (changed) changed->push_back(d.first);
+    }
+    return outcome;
+}
+
+int Scheduler::unblockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay,
+                            std::vector<size_t>* promoted) {
+    std::unordered_set<int> targets(roomNumbers.begin(), roomNumbers.end());
+    std::vector<RoomBlock> lifted;
+    size_t kept = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const RoomBlock& b = blocks[i];
+        if (targets.count(b.roomNumber) && b.fromDay < toDay && b.toDay > fromDay) {
+            lifted.push_back(b);
+        } else {
+            if (kept != i) blocks[kept] = std::move(blocks[i]);
+            ++kept;
+        }
+    }
+    blocks.resize(kept);
+
+    std::unordered_map<int, size_t> roomByNumber = indexRoomsByNumber();
+    for (const auto& b : lifted) {
+        // A block may outlive its room (see rebuildIndex); it is just dropped
+        auto it = roomByNumber.find(b.roomNumber);
+        if (it == roomByNumber.end()) continue;
+        size_t index = it->second;
+        if (removeStay(index, b.startTime(), -b.id)) promoteInto(index, b.startTime(), b.endTime(), promoted);
+    }
+    return static_cast<int>(lifted.size());
+}
+
+struct Scheduler::DefragSearch {
+    typedef std::chrono::steady_clock Clock;
+
+    const Scheduler& scheduler;
+    const std::vector<size_t>& candidates;           // room positions of the type
+    const std::unordered_map<int, size_t>& byId;     // reservation id -> position
+    time_t now;
+    Clock::time_point deadline;
+    std::atomic<size_t>& bound;                      // a plan must have fewer moves than this
+
+    std::unordered_set<int> lifted;                  // ids moved out of their room by the plan
+    std::unordered_map<size_t, std::vector<std::pair<time_t, time_t>>> placed;  // stays the plan put in
+    std::vector<std::pair<size_t, size_t>> moves;    // reservation, destination room
+    std::vector<std::pair<size_t, size_t>> best;
+    bool foundAny = false;
+    bool timedOut = false;
+    uint32_t steps = 0;
+
+    DefragSearch(const Scheduler& s, const std::vector<size_t>& rooms,
+                 const std::unordered_map<int, size_t>& ids, time_t nowTime,
+                 Clock::time_point end, std::atomic<size_t>& sharedBound)
+        : scheduler(s), candidates(rooms), byId(ids), now(nowTime), deadline(end), bound(sharedBound) {}
+
+    // Stays in room overlapping [in, out) as the plan has left it; false
+    // if one of them may not move (a block, a guest in house, a past stay)
+    bool blockers(size_t room, time_t in, time_t out, std::vector<size_t>& found) const {
+        auto placedHere = placed.find(room);
+        if (placedHere != placed.end()) {
+            for (const auto& stay : placedHere->second) {
+                if (stay.first < out && stay.second > in) return false;
+            }
+        }
+        const RoomStays& stays = scheduler.roomStays[room];
+        auto it = stays.lower_bound(in);
+        if (it != stays.begin() && std::prev(it)->second.checkOut > in) --it;
+        for (; it != stays.end() && it->first < out; ++it) {
+            int id = it->second.reservationId;
+            if (lifted.count(id)) continue;
+            if (id < 0) return false;
+            auto index = byId.find(id);
+            if (index == byId.end()) return false;
+            const Reservation& r = scheduler.reservations[index->second];
+            if (r.getStatus() != ReservationStatus::CONFIRMED || r.getCheckInTime() <= now) return false;
+            found.push_back(index->second);
+        }
+        return true;
+    }
+
+    // Every stay in queue from next on still needs a room
+    void solve(std::vector<size_t>& queue, size_t next,
+               const std::unordered_map<int, size_t>& roomByNumber) {
+        if (timedOut) return;
+        if ((++steps & 255) == 0 && Clock::now() > deadline) {
+            timedOut = true;
+            return;
+        }
+        if (moves.size() + (queue.size() - next) >= bound.load(std::memory_order_relaxed)) return;
+        if (next == queue.size()) {
+            best = moves;
+            foundAny = true;
+            size_t current = bound.load(std::memory_order_relaxed);
+            while (moves.size() < current &&
+                   !bound.compare_exchange_weak(current, moves.size(), std::memory_order_relaxed)) {
+            }
+            return;
+        }
+
+        const Reservation& r = scheduler.reservations[queue[next]];
+        size_t from = roomByNumber.at(r.getAssignedRoomNumber());
+        time_t in = r.getCheckInTime(), out = r.getCheckOutTime();
+
+        // Rooms that displace the fewest others first
+        std::vector<std::pair<size_t, std::vector<size_t>>> options;
+        for (size_t room : candidates) {
+            if (room == from) continue;
+            std::vector<size_t> displaced;
+            if (blockers(room, in, out, displaced)) options.emplace_back(room, std::move(displaced));
+        }
+        std::stable_sort(options.begin(), options.end(), [](const auto& a, const auto& b) {
+            return a.second.size() < b.second.size();
+        });
+
+        for (const auto& option : options) {
+            size_t room = option.first;
+            const std::vector<size_t>& displaced = option.second;
+            if (moves.size() + 1 + (queue.size() - next - 1) + displaced.size() >=
+                bound.load(std::memory_order_relaxed)) {
+                break;
+            }
+
+            for (size_t d : displaced) {
+                lifted.insert(scheduler.reservations[d].getId());
+                queue.push_back(d);
+            }
+            placed[room].emplace_back(in, out);
+            moves.emplace_back(queue[next], room);
+
+            solve(queue, next + 1, roomByNumber);
+
+            moves.pop_back();
+            placed[room].pop_back();
+            for (size_t d : displaced) lifted.erase(scheduler.reservations[d].getId());
+            queue.resize(queue.size() - displaced.size());
+            if (timedOut) return;
+        }
+    }
+};
+
+Scheduler::DefragPlan Scheduler::planDefragmentation(const Reservation& res, RoomType type, time_t now,
+                                                     std::chrono::milliseconds budget, int maxMoves) const {
+    typedef DefragSearch::Clock Clock;
+    DefragPlan plan;
+    const std::vector<size_t>& candidates = roomsOfType[static_cast<int>(type)];
+    if (candidates.empty() || maxMoves < 0) return plan;
+
+    std::unordered_map<int, size_t> byId;
+    for (size_t i = 0; i < reservations.size(); ++i) byId[reservations[i].getId()] = i;
+    std::unordered_map<int, size_t> roomByNumber = indexRoomsByNumber();
+
+    // Moves cannot help if at some midnight of the stay every room of the
+    // type is taken: whatever moves, those stays still cover that instant
+    for (int day = toDayIndex(res.getCheckInTime()) + 1; day <= toDayIndex(res.getCheckOutTime()); ++day) {
+        time_t midnight = fromDayIndex(day);
+        if (midnight <= res.getCheckInTime() || midnight >= res.getCheckOutTime()) continue;
+        Reservation night(0, 0, midnight, midnight + 1, -1, ReservationStatus::PENDING, Money());
+        bool anyFree = false;
+        for (size_t room : candidates) {
+            if (canAssignToRoom(night, rooms[room])) {
+                anyFree = true;
+                break;
             }
         }
-        std::cout << "\n";
+        if (!anyFree) return plan;
     }
+
+    std::atomic<size_t> bound{static_cast<size_t>(maxMoves) + 1};
+    Clock::time_point deadline = Clock::now() + budget;
+
+    // Rooms that need the fewest direct moves first, so the bound tightens early
+    std::vector<std::pair<size_t, size_t>> order;  // direct conflicts, room
+    {
+        DefragSearch probe(*this, candidates, byId, now, deadline, bound);
+        for (size_t room : candidates) {
+            std::vector<size_t> conflicts;
+            if (probe.blockers(room, res.getCheckInTime(), res.getCheckOutTime(), conflicts)) {
+                order.emplace_back(conflicts.size(), room);
+            }
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    std::mutex resultMutex;
+    std::atomic<size_t> nextRoom{0};
+    std::atomic<size_t> searched{0};
+    auto worker = [&]() {
+        DefragSearch search(*this, candidates, byId, now, deadline, bound);
+        while (true) {
+            size_t position = nextRoom.fetch_add(1);
+            if (position >= order.size() || search.timedOut) break;
+            size_t target = order[position].second;
+            if (order[position].first >= bound.load(std::memory_order_relaxed)) continue;
+
+            std::vector<size_t> queue;
+            search.blockers(target, res.getCheckInTime(), res.getCheckOutTime(), queue);
+            for (size_t d : queue) search.lifted.insert(reservations[d].getId());
+            search.placed[target].emplace_back(res.getCheckInTime(), res.getCheckOutTime());
+            search.foundAny = false;
+            search.solve(queue, 0, roomByNumber);
+            search.lifted.clear();
+            search.placed.clear();
+            searched.fetch_add(1);
+
+            if (!search.foundAny) continue;
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (plan.found && plan.moves.size() <= search.best.size()) continue;
+            plan.found = true;
+            plan.targetRoom = rooms[target].getRoomNumber();
+            plan.moves.clear();
+            for (const auto& move : search.best) {
+                plan.moves.push_back({move.first, reservations[move.first].getAssignedRoomNumber(),
+                                      rooms[move.second].getRoomNumber()});
+            }
+        }
+        if (search.timedOut) {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            plan.timedOut = true;
+        }
+    };
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, order.size()));
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    plan.roomsSearched = searched.load();
+    return plan;
 }
 
-void Scheduler::displayRoomSchedule(int roomNumber) const {
-    std::cout << "\n====== SCHEDULE FOR ROOM " << roomNumber << " ======\n";
+void Scheduler::applyDefragmentation(size_t reservationIndex, const DefragPlan& plan) {
+    if (!plan.found) return;
+    std::unordered_map<int, size_t> roomByNumber = indexRoomsByNumber();
 
-    const Room* roomPtr = nullptr;
-    for (const auto& room : rooms) {
-        if (room.getRoomNumber() == roomNumber) {
-            roomPtr = &room;
-            break;
+    // Lift every moved stay before placing any: a move may go into nights
+    // another move frees
+    for (const auto& move : plan.moves) {
+        Reservation& r = reservations[move.reservation];
+        Room& from = rooms[roomByNumber.at(move.fromRoom)];
+        calendar.removeStay(from.getType(), toDayIndex(r.getCheckInTime()),
+                            toDayIndex(r.getCheckOutTime()), r.getTotalCost());
+        removeStay(roomIndex(from), r.getCheckInTime(), r.getId());
+        from.removeReservation(r.getId());
+    }
+    for (const auto& move : plan.moves) {
+        assignToRoom(reservations[move.reservation], rooms[roomByNumber.at(move.toRoom)]);
+    }
+
+    Reservation& res = reservations[reservationIndex];
+    if (res.getStatus() == ReservationStatus::PENDING && res.getRequestedType() >= 0) {
+        waitlist.remove(static_cast<RoomType>(res.getRequestedType()), res.getId());
+    }
+    assignToRoom(res, rooms[roomByNumber.at(plan.targetRoom)]);
+}
+
+void Scheduler::displaySchedule(const HotelSnapshot& snapshot) {
+    std::unordered_map<int, size_t> byId = snapshot.indexById();
+
+    ReportBuffer out(std::cout);
+    out << "\n====== COMPLETE ROOM SCHEDULE ======\n";
+    for (size_t i = 0; i < snapshot.getRoomCount(); ++i) {
+        const Room& room = snapshot.roomAt(i);
+        out << "Room " << room.getRoomNumber()
+            << " (" << room.getTypeString() << ", $"
+            << room.getPricePerNight() << "/night)\n";
+
+        if (room.getReservationIds().empty()) {
+            out << "  [No reservations]\n\n";
+            continue;
         }
+
+        for (int resId : room.getReservationIds()) {
+            auto it = byId.find(resId);
+            if (it == byId.end()) continue;
+            const Reservation& r = snapshot.reservationAt(it->second);
+            out << "  - Reservation #" << r.getId()
+                << " [Customer " << r.getCustomerId() << "] "
+                << r.getStatusString() << "\n";
+        }
+        out << "\n";
     }
+}
 
+void Scheduler::displayRoomSchedule(int roomNumber) const {
+    ReportBuffer out(std::cout);
+    out << "\n====== SCHEDULE FOR ROOM " << roomNumber << " ======\n";
+
+    const Room* roomPtr = findRoom(roomNumber);
     if (!roomPtr) {
-        std::cout << "Room not found.\n";
+        out << "Room not found.\n";
         return;
     }
 
     const Room& room = *roomPtr;
 
+    for (const auto& b : blocks) {
+        if (b.roomNumber != roomNumber) continue;
+        out << "Out of service " << formatDay(b.fromDay) << " to " << formatDay(b.toDay)
+            << " (exclusive)" << (b.reason.empty() ? "" : ": " + b.reason) << "\n";
+    }
+
     if (room.getReservationIds().empty()) {
-        std::cout << "No reservations for this room.\n";
+        out << "No reservations for this room.\n";
         return;
     }
 
     for (int resId : room.getReservationIds()) {
-        for (const auto& r : reservations) {
-            if (r.getId() == resId) {
-                r.display();
-                std::cout << "\n";
-                break;
-            }
+        if (const Reservation* r = findReservation(resId)) {
+            r->render(out);
+            out << "\n";
         }
     }
 }
 
+std::vector<int> Scheduler::getAvailableRooms(RoomType type, time_t checkIn, time_t checkOut) const {
+    // Probe reservation with id 0 so the global id counter is untouched
+    Reservation probe(0, 0, checkIn, checkOut, -1, ReservationStatus::PENDING, Money());
+    std::vector<int> available;
+    for (size_t index : roomsOfType[static_cast<int>(type)]) {
+        if (canAssignToRoom(probe, rooms[index])) available.push_back(rooms[index].getRoomNumber());
+    }
+    return available;
+}
+
 int Scheduler::getTotalRoomsUsed() const {
     int count = 0;
     for (const auto& room : rooms) {
@@ -239,3 +969,61 @@ std::map<int, std::vector<int>> Scheduler::getRoomAssignments() const {
     }
     return assignments;
 }
+
+OccupancyReport Scheduler::getOccupancySeries(int fromDay, int toDay) const {
+    int roomCounts[ROOM_TYPE_COUNT] = {};
+    bool includeType[ROOM_TYPE_COUNT];
+    for (const auto& room : rooms) {
+        ++roomCounts[static_cast<int>(room.getType())];
+    }
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) includeType[t] = true;
+    return calendar.report(fromDay, toDay, roomCounts, includeType);
+}
+
+OccupancyReport Scheduler::getOccupancySeries(int fromDay, int toDay, RoomType type) const {
+    int roomCounts[ROOM_TYPE_COUNT] = {};
+    bool includeType[ROOM_TYPE_COUNT] = {};
+    for (const auto& room : rooms) {
+        ++roomCounts[static_cast<int>(room.getType())];
+    }
+    includeType[static_cast<int>(type)] = true;
+    return calendar.report(fromDay, toDay, roomCounts, includeType);
+}
+
+void Scheduler::rebuildIndex() {
+    roomStays.assign(rooms.size(), RoomStays());
+    std::unordered_map<int, size_t> roomByNumber = indexRoomsByNumber();
+    for (auto& list : roomsOfType) list.clear();
+    for (size_t i = 0; i < rooms.size(); ++i) roomsOfType[static_cast<int>(rooms[i].getType())].push_back(i);
+
+    nextBlockId = 1;
+    for (const auto& b : blocks) {
+        auto it = roomByNumber.find(b.roomNumber);
+        if (it != roomByNumber.end()) roomStays[it->second].emplace(b.startTime(), Stay{b.endTime(), -b.id});
+        nextBlockId = std::max(nextBlockId, b.id + 1);
+    }
+
+    waitlist.clear();
+    for (const auto& r : reservations) {
+        if (blocksRoom(r)) {
+            auto it = roomByNumber.find(r.getAssignedRoomNumber());
+            if (it != roomByNumber.end()) {
+                roomStays[it->second].emplace(r.getCheckInTime(), Stay{r.getCheckOutTime(), r.getId()});
+            }
+        } else if (r.getStatus() == ReservationStatus::PENDING) {
+            addToWaitlist(r);  // vector order is booking order
+        }
+    }
+}
+
+void Scheduler::rebuildCalendar() {
+    rebuildIndex();
+    calendar.clear();
+    for (const auto& r : reservations) {
+        if (!countsAsSold(r)) continue;
+        const Room* room = findRoom(r.getAssignedRoomNumber());
+        if (!room) continue;
+        calendar.addStay(room->getType(), toDayIndex(r.getCheckInTime()),
+                         toDayIndex(r.getCheckOutTime()), r.getTotalCost());
+    }
+}
@@ -3,33 +3,184 @@
 
 #include "Reservation.h"
 #include "Room.h"
+#include "OccupancyCalendar.h"
+#include "RateCalendar.h"
+#include "HotelSnapshot.h"
+#include "Waitlist.h"
+#include "RoomBlock.h"
 #include <vector>
 #include <map>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+// How a booking picks among the free rooms it could go into
+enum class AssignmentPolicy {
+    FIRST_FIT,  // first free room in vector order
+    BEST_FIT    // free room where the stay leaves the smallest gaps to its neighbours
+};
 
 class Scheduler {
 private:
     std::vector<Room>& rooms;
     std::vector<Reservation>& reservations;
+    std::vector<RoomBlock>& blocks;
+    OccupancyCalendar calendar;
+    const RateCalendar* rateCalendar = nullptr;
+    AssignmentPolicy policy = AssignmentPolicy::FIRST_FIT;
+
+    // Stays that block a room (CONFIRMED or CHECKED_IN) and RoomBlocks,
+    // per room in the order of `rooms`, keyed by check-in time. Overlap
+    // checks and free-gap lookups are O(log n) per room.
+    struct Stay {
+        time_t checkOut;
+        int reservationId;  // -id for a RoomBlock
+    };
+    typedef std::multimap<time_t, Stay> RoomStays;
+    std::vector<RoomStays> roomStays;
+    std::vector<size_t> roomsOfType[ROOM_TYPE_COUNT];  // positions in rooms
+    Waitlist waitlist;
+    int nextBlockId = 1;
+
+    // Free nights left between a stay and its neighbours in one room. A
+    // side with no neighbour is open; fewer open sides is a tighter fit.
+    struct Fit {
+        int openSides = 0;
+        time_t leftover = 0;
+    };
+
+    bool canAssignToRoom(const Reservation& res, const Room& room, Fit* fit = nullptr) const;
+    // Free room for res under the current policy; type -1 allows any type
+    Room* chooseRoom(const Reservation& res, int type);
+    void assignToRoom(Reservation& res, Room& room);
+    const Room* findRoom(int roomNumber) const;
+    Reservation* findReservation(int reservationId);
+    const Reservation* findReservation(int reservationId) const;
+    static bool countsAsSold(const Reservation& res);
+    static bool blocksRoom(const Reservation& res);
+    size_t roomIndex(const Room& room) const { return static_cast<size_t>(&room - rooms.data()); }
+    size_t reservationIndex(const Reservation& res) const {
+        return static_cast<size_t>(&res - reservations.data());
+    }
+    bool removeStay(size_t room, time_t checkIn, int reservationId);
+    std::unordered_map<int, size_t> indexRoomsByNumber() const;
+    void addToWaitlist(const Reservation& res);
+    // Fills the gap left by [freedIn, freedOut) in one room from the
+    // waitlist; only nights from now on are offered
+    void promoteInto(size_t room, time_t freedIn, time_t freedOut, std::vector<size_t>* promoted);
+    void rebuildIndex();
 
-    bool canAssignToRoom(const Reservation& res, const Room& room) const;
+    struct DefragSearch;  // one worker's branch-and-bound state (Scheduler.cpp)
 
 public:
-    Scheduler(std::vector<Room>& rooms, std::vector<Reservation>& reservations);
+    struct BlockOutcome {
+        int blocked = 0;
+        int skipped = 0;     // a guest is checked in or the room is already blocked
+        int unknown = 0;     // no such room number
+        int moved = 0;       // displaced stays placed in another room of their type
+        int waitlisted = 0;  // displaced stays that found no room
+    };
+
+    struct RoomMove {
+        size_t reservation;  // position in the reservations vector
+        int fromRoom;
+        int toRoom;
+    };
+
+    struct DefragPlan {
+        bool found = false;
+        int targetRoom = -1;
+        std::vector<RoomMove> moves;
+        size_t roomsSearched = 0;
+        bool timedOut = false;
+    };
+
+    Scheduler(std::vector<Room>& rooms, std::vector<Reservation>& reservations,
+              std::vector<RoomBlock>& blocks);
+
+    // When set, stay costs include the calendar's nightly surcharges
+    void setRateCalendar(const RateCalendar* rates) { rateCalendar = rates; }
+
+    void setAssignmentPolicy(AssignmentPolicy p) { policy = p; }
+    AssignmentPolicy getAssignmentPolicy() const { return policy; }
 
     void scheduleReservations();
+    // Bulk pass for overbooked periods: per requested room type, confirms
+    // the stays with the highest total revenue rather than the earliest
+    // check-ins (weighted interval scheduling as a min-cost flow, O(n log n)
+    // per room of the type). Reservations without a requested type then take
+    // any room left, in check-in order. Both passes leave checked-in guests
+    // in their rooms. Stays are valued at the cheapest room of their type,
+    // so when prices within a type differ the objective is a lower bound on
+    // the revenue booked, which is charged at each assigned room's price.
+    void scheduleReservationsForRevenue();
 
     bool scheduleReservation(int reservationId);
 
+    // A stay that finds no room is waitlisted under preferredType
     bool scheduleReservation(int reservationId, RoomType preferredType);
 
-    void removeReservation(int reservationId);
+    // Group bookings: one free room per entry of types for [checkIn,
+    // checkOut), found in a single pass over the rooms. Returns the room
+    // positions in the order of types, or nothing if any entry has no room.
+    std::vector<size_t> findGroupRooms(const std::vector<RoomType>& types,
+                                       time_t checkIn, time_t checkOut) const;
+    // Confirms reservations[reservationIndices[i]] into rooms[roomIndices[i]]
+    void assignGroup(const std::vector<size_t>& reservationIndices, const std::vector<size_t>& roomIndices);
+
+    // Cancels; the freed nights go to waitlisted stays that fit them.
+    // promoted receives the positions (in the reservations vector) of
+    // every reservation confirmed that way.
+    void removeReservation(int reservationId, std::vector<size_t>* promoted = nullptr);
+    // After check-out the stay stops blocking its room, as for a
+    // cancellation; only its nights still to come go to the waitlist
+    void releaseReservation(int reservationId, std::vector<size_t>* promoted = nullptr);
+
+    size_t getWaitlistSize(RoomType type) const { return waitlist.size(type); }
+
+    // Looks for the fewest moves of other stays between rooms of the same
+    // type that free a room of that type for all of res's nights. Only
+    // CONFIRMED stays checking in after now may move. Branch and bound
+    // over the candidate rooms, several rooms at a time on worker threads,
+    // capped at maxMoves and stopped at the budget with the best plan so far.
+    DefragPlan planDefragmentation(const Reservation& res, RoomType type, time_t now,
+                                   std::chrono::milliseconds budget, int maxMoves) const;
+    // Carries out a plan made under the same lock, then confirms the
+    // reservation at reservationIndex into plan.targetRoom
+    void applyDefragmentation(size_t reservationIndex, const DefragPlan& plan);
+
+    // Takes each listed room out of service for the nights [fromDay, toDay).
+    // Confirmed stays in the way move to another room of the same type or
+    // go on the waitlist; changed receives their positions in the
+    // reservations vector. Only the listed rooms are touched.
+    BlockOutcome blockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay,
+                            const std::string& reason, std::vector<size_t>* changed = nullptr);
+    // Lifts every block on the listed rooms that overlaps [fromDay, toDay)
+    // and offers the freed nights to the waitlist; returns the blocks lifted
+    int unblockRooms(const std::vector<int>& roomNumbers, int fromDay, int toDay,
+                     std::vector<size_t>* promoted = nullptr);
+    const std::vector<RoomBlock>& getBlocks() const { return blocks; }
 
-    void displaySchedule() const;
+    // Reads a pinned snapshot, so it never holds up bookings
+    static void displaySchedule(const HotelSnapshot& snapshot);
     void displayRoomSchedule(int roomNumber) const;
 
+    // Room numbers of the given type free for the whole [checkIn, checkOut)
+    std::vector<int> getAvailableRooms(RoomType type, time_t checkIn, time_t checkOut) const;
+
     int getTotalRoomsUsed() const;
     double getOccupancyRate() const;
     std::map<int, std::vector<int>> getRoomAssignments() const;
+
+    // Nightly occupancy over [fromDay, toDay) (day indices, see DateUtils.h)
+    OccupancyReport getOccupancySeries(int fromDay, int toDay) const;
+    OccupancyReport getOccupancySeries(int fromDay, int toDay, RoomType type) const;
+
+    OccupancyCalendar& getCalendar() { return calendar; }
+
+    // Recomputes the occupancy calendar, room stay index (blocks included)
+    // and waitlist from scratch (after loads/restores)
+    void rebuildCalendar();
 };
 
 #endif
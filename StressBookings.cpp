@@ -0,0 +1,172 @@
+// Booking stress run for HotelSystem's shard locking (see HotelLocks.h).
+// For 1, 2, 4, ... threads it builds a fresh hotel with the same rooms,
+// books the same stays through the public API, then checks that no room
+// ended up double-booked.
+// Booking throughput can scale up to one thread per RoomType; availability
+// queries only take shared locks and scale with every core.
+#include "HotelSystem.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct RunResult {
+        double seconds = 0.0;
+        size_t confirmed = 0;
+        size_t pending = 0;
+        size_t queries = 0;
+        bool consistent = true;
+    };
+
+    void writeRooms(const std::string& dir, int roomsPerType) {
+        std::ofstream file(dir + "/rooms.json");
+        const int64_t prices[ROOM_TYPE_COUNT] = {10000, 15000, 25000, 35000};
+        for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+            for (int i = 0; i < roomsPerType; ++i) {
+                Room room((t + 1) * 1000 + i, static_cast<RoomType>(t), Money::fromCents(prices[t]));
+                file << room.serialize() << "\n";
+            }
+        }
+    }
+
+    RunResult runOnce(unsigned threads, int roomsPerType, size_t bookings, int queriesPerBooking) {
+        std::string dir = (std::filesystem::temp_directory_path() /
+                           ("hotel_stress_" + std::to_string(threads))).string();
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        writeRooms(dir, roomsPerType);
+
+        RunResult result;
+        std::vector<std::vector<int>> created(threads);
+        {
+            HotelSystem hotel(dir);
+            hotel.setAutoSave(false);
+            int customerId = hotel.addCustomer("Stress Guest", "stress@example.com", "5550100000").id;
+            int today = toDayIndex(std::time(nullptr));
+
+            // Booking i is the same stay in every run; thread t takes every
+            // threads-th booking, so with up to four threads each one keeps
+            // to its own RoomType shard
+            auto worker = [&](unsigned index) {
+                std::uniform_int_distribution<int> offset(1, 365);
+                std::uniform_int_distribution<int> length(1, 5);
+                for (size_t i = index; i < bookings; i += threads) {
+                    std::mt19937 rng(static_cast<unsigned>(i) * 2654435761u);
+                    RoomType type = static_cast<RoomType>(i % ROOM_TYPE_COUNT);
+                    int first = today + offset(rng);
+                    time_t checkIn = fromDayIndex(first, 14);
+                    time_t checkOut = fromDayIndex(first + length(rng), 11);
+                    for (int q = 0; q < queriesPerBooking; ++q) {
+                        hotel.findAvailableRooms(type, checkIn, checkOut);
+                    }
+                    OperationResult r = hotel.createReservation(customerId, type, checkIn, checkOut);
+                    if (r.id > 0) created[index].push_back(r.id);
+                }
+            };
+
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+            worker(0);
+            for (auto& t : pool) t.join();
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.queries = bookings * static_cast<size_t>(queriesPerBooking);
+
+            // No two confirmed stays may overlap in the same room
+            std::map<int, std::vector<Reservation>> byRoom;
+            for (const auto& ids : created) {
+                for (int id : ids) {
+                    Reservation r;
+                    if (!hotel.lookupReservation(id, r)) {
+                        result.consistent = false;
+                        continue;
+                    }
+                    if (r.getStatus() == ReservationStatus::CONFIRMED) {
+                        ++result.confirmed;
+                        byRoom[r.getAssignedRoomNumber()].push_back(r);
+                    } else {
+                        ++result.pending;
+                    }
+                }
+            }
+            for (auto& entry : byRoom) {
+                auto& stays = entry.second;
+                std::sort(stays.begin(), stays.end(), [](const Reservation& a, const Reservation& b) {
+                    return a.getCheckInTime() < b.getCheckInTime();
+                });
+                for (size_t i = 1; i < stays.size(); ++i) {
+                    if (stays[i - 1].overlaps(stays[i])) result.consistent = false;
+                }
+            }
+        }
+        std::filesystem::remove_all(dir);
+        return result;
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program
+                  << " [--bookings N] [--rooms-per-type N] [--queries-per-booking N] [--max-threads N]\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t bookings = 2000;
+    int roomsPerType = 40;
+    int queriesPerBooking = 4;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bookings") == 0 && i + 1 < argc) {
+            bookings = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--rooms-per-type") == 0 && i + 1 < argc) {
+            roomsPerType = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--queries-per-booking") == 0 && i + 1 < argc) {
+            queriesPerBooking = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            maxThreads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (bookings == 0 || roomsPerType <= 0 || queriesPerBooking < 0 || maxThreads == 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "\n========== BOOKING STRESS ==========\n";
+    std::cout << bookings << " bookings, " << roomsPerType << " rooms per type, "
+              << queriesPerBooking << " availability queries per booking\n\n";
+    std::cout << std::setw(8) << "Threads" << std::setw(12) << "Seconds"
+              << std::setw(14) << "Bookings/s" << std::setw(14) << "Queries/s"
+              << std::setw(10) << "Speedup" << std::setw(12) << "Confirmed"
+              << std::setw(10) << "Pending" << std::setw(8) << "Valid" << "\n";
+
+    double baseline = 0.0;
+    bool allConsistent = true;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        RunResult r = runOnce(threads, roomsPerType, bookings, queriesPerBooking);
+        if (threads == 1) baseline = r.seconds;
+        allConsistent = allConsistent && r.consistent;
+
+        std::cout << std::fixed << std::setw(8) << threads
+                  << std::setw(12) << std::setprecision(3) << r.seconds
+                  << std::setw(14) << std::setprecision(0) << bookings / r.seconds
+                  << std::setw(14) << r.queries / r.seconds
+                  << std::setw(9) << std::setprecision(2) << baseline / r.seconds << "x"
+                  << std::setw(12) << r.confirmed << std::setw(10) << r.pending
+                  << std::setw(8) << (r.consistent ? "yes" : "NO") << "\n";
+    }
+    return allConsistent ? 0 : 2;
+}
@@ -0,0 +1,118 @@
+#include "SyntheticHotel.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+namespace {
+    // Share of rooms, and of requests, per RoomType
+    const double TYPE_SHARE[ROOM_TYPE_COUNT] = {0.40, 0.30, 0.20, 0.10};
+    const int64_t TYPE_PRICE[ROOM_TYPE_COUNT] = {10000, 15000, 25000, 35000};
+
+    // Nights per stay, 1..14: mostly short stays with a week-long bump
+    const double STAY_WEIGHT[14] = {22, 24, 18, 12, 7, 4, 5, 2, 1, 1, 1, 1, 0.5, 1.5};
+
+    const int MAX_LEAD_DAYS = 330;
+
+    // mt19937_64's output is fixed by the standard but the <random>
+    // distributions are not, so draws are made by hand to keep every
+    // platform on the same hotel
+    class Draw {
+    private:
+        std::mt19937_64 rng;
+
+    public:
+        explicit Draw(uint64_t seed) : rng(seed) {}
+
+        double unit() { return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0); }
+        size_t below(size_t n) { return static_cast<size_t>(unit() * static_cast<double>(n)); }
+        double exponential(double mean) { return -mean * std::log(1.0 - unit()); }
+
+        size_t weighted(const double* weights, size_t count) {
+            double total = 0.0;
+            for (size_t i = 0; i < count; ++i) total += weights[i];
+            double x = unit() * total;
+            for (size_t i = 0; i < count; ++i) {
+                if (x < weights[i]) return i;
+                x -= weights[i];
+            }
+            return count - 1;
+        }
+    };
+}
+
+SyntheticHotel generateSyntheticHotel(const SyntheticSpec& spec) {
+    SyntheticHotel hotel;
+    Draw draw(spec.seed);
+
+    size_t roomCount = spec.rooms ? spec.rooms : std::max<size_t>(8, spec.reservations / 40);
+    size_t customerCount = spec.customers ? spec.customers : std::max<size_t>(1, spec.reservations / 3);
+    int firstDay = spec.firstDay ? spec.firstDay : dayIndexFromCivil(2030, 1, 1);
+    int horizon = std::max(1, spec.horizonDays);
+
+    // Rooms: each type gets its share (at least one), numbered per type
+    hotel.rooms.reserve(roomCount);
+    size_t assigned = 0;
+    for (int t = 0; t < ROOM_TYPE_COUNT; ++t) {
+        size_t count = t == ROOM_TYPE_COUNT - 1
+            ? (roomCount > assigned ? roomCount - assigned : 1)
+            : std::max<size_t>(1, static_cast<size_t>(std::llround(roomCount * TYPE_SHARE[t])));
+        for (size_t i = 0; i < count; ++i) {
+            hotel.rooms.push_back(Room((t + 1) * 1000000 + static_cast<int>(i) + 1,
+                                       static_cast<RoomType>(t), Money::fromCents(TYPE_PRICE[t])));
+        }
+        assigned += count;
+    }
+
+    hotel.customers.reserve(customerCount);
+    for (size_t i = 1; i <= customerCount; ++i) {
+        std::string n = std::to_string(i);
+        hotel.customers.push_back(Customer(static_cast<int>(i), "Guest " + n, "guest" + n + "@example.com",
+                                           "555" + std::string(7 - std::min<size_t>(7, n.size()), '0') + n));
+    }
+
+    // Booking order is id order, as if the reservations had been taken live
+    std::vector<int> bookingDays(spec.reservations);
+    for (auto& d : bookingDays) d = static_cast<int>(draw.below(static_cast<size_t>(horizon)));
+    std::sort(bookingDays.begin(), bookingDays.end());
+
+    // mktime is slow, so stamp each possible day once
+    int lastDay = horizon + MAX_LEAD_DAYS + 15;
+    std::vector<time_t> checkInAt(lastDay), checkOutAt(lastDay);
+    for (int d = 0; d < lastDay; ++d) {
+        checkInAt[d] = fromDayIndex(firstDay + d, 14);
+        checkOutAt[d] = fromDayIndex(firstDay + d, 11);
+    }
+
+    hotel.reservations.reserve(spec.reservations);
+    hotel.requestedTypes.reserve(spec.reservations);
+    for (size_t i = 0; i < spec.reservations; ++i) {
+        int lead = std::min(MAX_LEAD_DAYS, static_cast<int>(draw.exponential(spec.meanLeadDays)));
+        int nights = static_cast<int>(draw.weighted(STAY_WEIGHT, 14)) + 1;
+        RoomType type = static_cast<RoomType>(draw.weighted(TYPE_SHARE, ROOM_TYPE_COUNT));
+        int customerId = static_cast<int>(draw.below(customerCount)) + 1;
+        bool cancelled = draw.unit() < spec.cancelRate;
+
+        int arrival = bookingDays[i] + lead;
+        hotel.reservations.push_back(Reservation(static_cast<int>(i) + 1, customerId,
+                                                 checkInAt[arrival], checkOutAt[arrival + nights], -1,
+                                                 cancelled ? ReservationStatus::CANCELLED
+                                                           : ReservationStatus::PENDING,
+                                                 Money()));
+        hotel.requestedTypes.push_back(type);
+    }
+    return hotel;
+}
+
+bool SyntheticHotel::writeTo(const std::string& directory) const {
+    std::ofstream customerFile(directory + "/customers.json");
+    std::ofstream reservationFile(directory + "/reservations.json");
+    std::ofstream roomFile(directory + "/rooms.json");
+    if (!customerFile.is_open() || !reservationFile.is_open() || !roomFile.is_open()) return false;
+
+    for (const auto& c : customers) customerFile << c.serialize() << "\n";
+    for (const auto& r : reservations) reservationFile << r.serialize() << "\n";
+    for (const auto& r : rooms) roomFile << r.serialize() << "\n";
+    return customerFile.good() && reservationFile.good() && roomFile.good();
+}
@@ -0,0 +1,41 @@
+#ifndef SYNTHETIC_HOTEL_H
+#define SYNTHETIC_HOTEL_H
+
+#include "Customer.h"
+#include "Reservation.h"
+#include "Room.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Shape of a generated hotel. Zero sizes are derived from the reservation
+// count so one number picks a whole scale.
+struct SyntheticSpec {
+    size_t reservations = 1000;
+    size_t rooms = 0;              // 0: one room per 40 reservations, at least 8
+    size_t customers = 0;          // 0: one customer per 3 reservations
+    int firstDay = 0;              // day index bookings start from; 0: 2030-01-01
+    int horizonDays = 365;         // bookings are made over this many days
+    double meanLeadDays = 21.0;    // booking to check-in, exponential
+    double cancelRate = 0.10;
+    uint64_t seed = 42;
+};
+
+// A deterministic hotel: the same spec always yields the same rooms,
+// customers and reservations (ids from 1, in booking order). Reservations
+// are PENDING or CANCELLED and not yet assigned to rooms; requestedTypes
+// holds the RoomType each one asked for.
+struct SyntheticHotel {
+    std::vector<Customer> customers;
+    std::vector<Room> rooms;
+    std::vector<Reservation> reservations;
+    std::vector<RoomType> requestedTypes;
+
+    // Writes customers.json, reservations.json and rooms.json as HotelSystem
+    // saves them; returns false if a file could not be written
+    bool writeTo(const std::string& directory) const;
+};
+
+SyntheticHotel generateSyntheticHotel(const SyntheticSpec& spec);
+
+#endif
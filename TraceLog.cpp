@@ -0,0 +1,279 @@
+#include "TraceLog.h"
+#include <climits>
+
+namespace {
+    const char TRACE_MAGIC[4] = {'H', 'T', 'R', 'C'};
+    const uint8_t TRACE_VERSION = 1;
+    const size_t FLUSH_BYTES = 64 * 1024;
+
+    void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void putSigned(std::string& out, int64_t value) {
+        putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void putString(std::string& out, const std::string& s) {
+        putVarint(out, s.size());
+        out += s;
+    }
+
+    void putList(std::string& out, const std::vector<int>& values) {
+        putVarint(out, values.size());
+        for (int v : values) putSigned(out, v);
+    }
+
+    bool getVarint(std::istream& in, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int c = in.get();
+            if (c == EOF) return false;
+            value |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if (!(c & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool getSigned(std::istream& in, int64_t& value) {
+        uint64_t raw;
+        if (!getVarint(in, raw)) return false;
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+
+    bool getString(std::istream& in, std::string& s) {
+        uint64_t size;
+        if (!getVarint(in, size) || size > (1u << 20)) return false;
+        s.resize(static_cast<size_t>(size));
+        return size == 0 || static_cast<bool>(in.read(&s[0], static_cast<std::streamsize>(size)));
+    }
+
+    bool getInt(std::istream& in, int& value) {
+        int64_t raw;
+        if (!getSigned(in, raw) || raw < INT_MIN || raw > INT_MAX) return false;
+        value = static_cast<int>(raw);
+        return true;
+    }
+
+    bool getList(std::istream& in, std::vector<int>& values) {
+        uint64_t size;
+        if (!getVarint(in, size) || size > (1u << 16)) return false;
+        values.resize(static_cast<size_t>(size));
+        for (int& v : values) {
+            if (!getInt(in, v)) return false;
+        }
+        return true;
+    }
+
+    bool getByte(std::istream& in, uint8_t& value) {
+        int c = in.get();
+        if (c == EOF) return false;
+        value = static_cast<uint8_t>(c);
+        return true;
+    }
+}
+
+const char* traceOpName(TraceOp op) {
+    switch (op) {
+        case TraceOp::ADD_CUSTOMER: return "add_customer";
+        case TraceOp::MODIFY_CUSTOMER: return "modify_customer";
+        case TraceOp::DELETE_CUSTOMER: return "delete_customer";
+        case TraceOp::CREATE_RESERVATION: return "create_reservation";
+        case TraceOp::CANCEL_RESERVATION: return "cancel";
+        case TraceOp::CHECK_IN: return "check_in";
+        case TraceOp::CHECK_OUT: return "check_out";
+        case TraceOp::FIND_AVAILABLE: return "availability";
+        case TraceOp::LOOKUP_RESERVATION: return "lookup";
+        case TraceOp::LOOKUP_CUSTOMER: return "lookup_customer";
+        case TraceOp::CREATE_GROUP: return "create_group";
+        case TraceOp::MAKE_ROOM_FOR: return "make_room";
+        case TraceOp::RESCHEDULE: return "reschedule";
+        case TraceOp::BLOCK_ROOMS: return "block";
+        case TraceOp::UNBLOCK_ROOMS: return "unblock";
+    }
+    return "unknown";
+}
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+bool TraceWriter::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    start = std::chrono::steady_clock::now();
+    int64_t unixMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    buffer.assign(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    buffer.push_back(static_cast<char>(TRACE_VERSION));
+    for (int i = 0; i < 8; ++i) {
+        buffer.push_back(static_cast<char>((static_cast<uint64_t>(unixMicros) >> (8 * i)) & 0xFF));
+    }
+    records = 0;
+    return true;
+}
+
+void TraceWriter::flushBuffer() {
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+void TraceWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) return;
+    flushBuffer();
+    file.close();
+}
+
+uint64_t TraceWriter::elapsedMicros() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+void TraceWriter::append(const TraceRecord& r) {
+    std::string encoded;
+    encoded.push_back(static_cast<char>(r.op));
+    encoded.push_back(static_cast<char>(r.code));
+    putVarint(encoded, r.offsetMicros);
+    putVarint(encoded, r.latencyNanos);
+    putSigned(encoded, r.resultId);
+
+    switch (r.op) {
+        case TraceOp::ADD_CUSTOMER:
+            putString(encoded, r.name);
+            putString(encoded, r.email);
+            putString(encoded, r.phone);
+            break;
+        case TraceOp::MODIFY_CUSTOMER:
+            putSigned(encoded, r.id);
+            putString(encoded, r.name);
+            putString(encoded, r.email);
+            putString(encoded, r.phone);
+            break;
+        case TraceOp::CREATE_RESERVATION:
+            putSigned(encoded, r.id);
+            encoded.push_back(static_cast<char>(r.type));
+            putSigned(encoded, static_cast<int64_t>(r.checkIn));
+            putSigned(encoded, static_cast<int64_t>(r.checkOut));
+            break;
+        case TraceOp::FIND_AVAILABLE:
+            encoded.push_back(static_cast<char>(r.type));
+            putSigned(encoded, static_cast<int64_t>(r.checkIn));
+            putSigned(encoded, static_cast<int64_t>(r.checkOut));
+            break;
+        case TraceOp::CREATE_GROUP:
+            putSigned(encoded, r.id);
+            putList(encoded, r.values);
+            putSigned(encoded, static_cast<int64_t>(r.checkIn));
+            putSigned(encoded, static_cast<int64_t>(r.checkOut));
+            putList(encoded, r.createdIds);
+            break;
+        case TraceOp::BLOCK_ROOMS:
+        case TraceOp::UNBLOCK_ROOMS:
+            putList(encoded, r.values);
+            putSigned(encoded, r.fromDay);
+            putSigned(encoded, r.toDay);
+            if (r.op == TraceOp::BLOCK_ROOMS) putString(encoded, r.name);
+            break;
+        default:
+            putSigned(encoded, r.id);
+            break;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) return;
+    buffer += encoded;
+    ++records;
+    if (buffer.size() >= FLUSH_BYTES) flushBuffer();
+}
+
+uint64_t TraceWriter::getRecordCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+bool TraceReader::open(const std::string& path) {
+    file.open(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[4];
+    uint8_t version;
+    if (!file.read(magic, 4) || std::string(magic, 4) != std::string(TRACE_MAGIC, 4) ||
+        !getByte(file, version) || version != TRACE_VERSION) {
+        corrupt = true;
+        return false;
+    }
+    uint64_t raw = 0;
+    for (int i = 0; i < 8; ++i) {
+        uint8_t b;
+        if (!getByte(file, b)) {
+            corrupt = true;
+            return false;
+        }
+        raw |= static_cast<uint64_t>(b) << (8 * i);
+    }
+    startUnixMicros = static_cast<int64_t>(raw);
+    return true;
+}
+
+bool TraceReader::next(TraceRecord& r) {
+    uint8_t op;
+    if (!getByte(file, op)) return false;  // clean end of trace
+    r = TraceRecord();
+    r.op = static_cast<TraceOp>(op);
+
+    int64_t id = 0, checkIn = 0, checkOut = 0;
+    uint8_t type = 0;
+    bool ok = op < TRACE_OP_COUNT && getByte(file, r.code) &&
+              getVarint(file, r.offsetMicros) && getVarint(file, r.latencyNanos) &&
+              getSigned(file, r.resultId);
+    if (ok) {
+        switch (r.op) {
+            case TraceOp::ADD_CUSTOMER:
+                ok = getString(file, r.name) && getString(file, r.email) && getString(file, r.phone);
+                break;
+            case TraceOp::MODIFY_CUSTOMER:
+                ok = getSigned(file, id) && getString(file, r.name) &&
+                     getString(file, r.email) && getString(file, r.phone);
+                break;
+            case TraceOp::CREATE_RESERVATION:
+                ok = getSigned(file, id) && getByte(file, type) &&
+                     getSigned(file, checkIn) && getSigned(file, checkOut);
+                break;
+            case TraceOp::FIND_AVAILABLE:
+                ok = getByte(file, type) && getSigned(file, checkIn) && getSigned(file, checkOut);
+                break;
+            case TraceOp::CREATE_GROUP:
+                ok = getSigned(file, id) && getList(file, r.values) && getSigned(file, checkIn) &&
+                     getSigned(file, checkOut) && getList(file, r.createdIds);
+                for (size_t i = 0; ok && i < r.values.size(); ++i) {
+                    ok = r.values[i] >= 0 && r.values[i] < ROOM_TYPE_COUNT;
+                }
+                break;
+            case TraceOp::BLOCK_ROOMS:
+            case TraceOp::UNBLOCK_ROOMS:
+                ok = getList(file, r.values) && getInt(file, r.fromDay) && getInt(file, r.toDay) &&
+                     (r.op == TraceOp::UNBLOCK_ROOMS || getString(file, r.name));
+                break;
+            default:
+                ok = getSigned(file, id);
+                break;
+        }
+    }
+    if (!ok || type >= ROOM_TYPE_COUNT) {
+        corrupt = true;
+        return false;
+    }
+    r.id = static_cast<int>(id);
+    r.type = static_cast<RoomType>(type);
+    r.checkIn = static_cast<time_t>(checkIn);
+    r.checkOut = static_cast<time_t>(checkOut);
+    return true;
+}
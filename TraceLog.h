@@ -0,0 +1,107 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include "Room.h"
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Binary session traces of HotelSystem's non-interactive API.
+//
+// File: "HTRC", a version byte, then the session's wall-clock start as 8
+// little-endian bytes (microseconds since the epoch). Each record is
+//   op byte, result code byte, start offset in microseconds, latency in
+//   nanoseconds, result id, then the op's parameters
+// with integers as LEB128 varints (signed ones zigzagged) and strings as a
+// varint length followed by the bytes, lists as a varint count followed by
+// signed varints. A typical booking takes ~20 bytes.
+
+enum class TraceOp : uint8_t {
+    ADD_CUSTOMER,         // name, email, phone
+    MODIFY_CUSTOMER,      // id, name, email, phone
+    DELETE_CUSTOMER,      // id
+    CREATE_RESERVATION,   // id (customer), type, checkIn, checkOut
+    CANCEL_RESERVATION,   // id
+    CHECK_IN,             // id
+    CHECK_OUT,            // id
+    FIND_AVAILABLE,       // type, checkIn, checkOut
+    LOOKUP_RESERVATION,   // id
+    LOOKUP_CUSTOMER,      // id
+    CREATE_GROUP,         // id (customer), values (room types), checkIn, checkOut, createdIds
+    MAKE_ROOM_FOR,        // id
+    RESCHEDULE,           // id (1: maximize revenue)
+    BLOCK_ROOMS,          // values (room numbers), fromDay, toDay, name (reason)
+    UNBLOCK_ROOMS         // values (room numbers), fromDay, toDay
+};
+
+const int TRACE_OP_COUNT = 15;
+
+const char* traceOpName(TraceOp op);
+
+struct TraceRecord {
+    TraceOp op = TraceOp::LOOKUP_RESERVATION;
+    uint8_t code = 0;              // ResultCode of the call
+    uint64_t offsetMicros = 0;     // call start, from the start of the session
+    uint64_t latencyNanos = 0;
+    int64_t resultId = 0;          // id created/touched; room count for FIND_AVAILABLE, 1/0 for lookups
+
+    int id = 0;
+    std::string name;
+    std::string email;
+    std::string phone;
+    RoomType type = RoomType::SINGLE;
+    time_t checkIn = 0;
+    time_t checkOut = 0;
+    int fromDay = 0;               // local day indices (DateUtils.h)
+    int toDay = 0;
+    std::vector<int> values;
+    std::vector<int> createdIds;   // reservations a group booking created, in order
+};
+
+// Appends records from any number of threads. Encoding happens outside the
+// lock; the file is written in 64 KB blocks and on close.
+class TraceWriter {
+private:
+    std::ofstream file;
+    std::string buffer;
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point start;
+    uint64_t records = 0;
+
+    void flushBuffer();
+
+public:
+    TraceWriter() = default;
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t elapsedMicros() const;
+    void append(const TraceRecord& record);
+    uint64_t getRecordCount();
+};
+
+class TraceReader {
+private:
+    std::ifstream file;
+    int64_t startUnixMicros = 0;
+    bool corrupt = false;
+
+public:
+    bool open(const std::string& path);
+    // False at the end of the trace or on a damaged record (see isCorrupt)
+    bool next(TraceRecord& out);
+
+    int64_t getStartUnixMicros() const { return startUnixMicros; }
+    bool isCorrupt() const { return corrupt; }
+};
+
+#endif
@@ -0,0 +1,245 @@
+// Replays a session trace recorded with "hotel_system --record" (see
+// TraceLog.h) against a copy of the data files, one call at a time in
+// recorded order, and reports per-operation latency next to the recorded
+// figures. Ids created during the session are mapped to the ids the replay
+// creates, so later calls touch the same customers and reservations.
+// By default calls run back to back; --paced keeps the original spacing
+// (scaled by --speed).
+#include "HotelSystem.h"
+#include "Metrics.h"
+#include "TraceLog.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const char* const DATA_FILES[] = {"customers.json", "reservations.json", "rooms.json", "rates.json",
+                                      "blocks.json"};
+
+    struct OpStats {
+        LatencyHistogram replayed;
+        LatencyHistogram recorded;
+        uint64_t mismatches = 0;   // replayed result code differs from the recorded one
+    };
+
+    bool copyDataFiles(const std::string& from, const std::string& to) {
+        std::error_code ec;
+        std::filesystem::remove_all(to, ec);
+        std::filesystem::create_directories(to, ec);
+        if (ec) return false;
+        for (const char* name : DATA_FILES) {
+            std::filesystem::path src = std::filesystem::path(from) / name;
+            if (!std::filesystem::exists(src)) continue;
+            std::filesystem::copy_file(src, std::filesystem::path(to) / name,
+                                       std::filesystem::copy_options::overwrite_existing, ec);
+            if (ec) return false;
+        }
+        return true;
+    }
+
+    int mapped(const std::unordered_map<int, int>& ids, int id) {
+        auto it = ids.find(id);
+        return it == ids.end() ? id : it->second;
+    }
+
+    // Runs one recorded call; returns its ResultCode
+    ResultCode execute(HotelSystem& hotel, const TraceRecord& r, time_t shift,
+                       std::unordered_map<int, int>& customerIds,
+                       std::unordered_map<int, int>& reservationIds) {
+        switch (r.op) {
+            case TraceOp::ADD_CUSTOMER: {
+                OperationResult result = hotel.addCustomer(r.name, r.email, r.phone);
+                if (result.ok() && r.resultId > 0) customerIds[static_cast<int>(r.resultId)] = result.id;
+                return result.code;
+            }
+            case TraceOp::MODIFY_CUSTOMER:
+                return hotel.modifyCustomer(mapped(customerIds, r.id), r.name, r.email, r.phone).code;
+            case TraceOp::DELETE_CUSTOMER:
+                return hotel.deleteCustomer(mapped(customerIds, r.id)).code;
+            case TraceOp::CREATE_RESERVATION: {
+                OperationResult result = hotel.createReservation(mapped(customerIds, r.id), r.type,
+                                                                 r.checkIn + shift, r.checkOut + shift);
+                if (result.id > 0 && r.resultId > 0) reservationIds[static_cast<int>(r.resultId)] = result.id;
+                return result.code;
+            }
+            case TraceOp::CANCEL_RESERVATION:
+                return hotel.cancelReservation(mapped(reservationIds, r.id)).code;
+            case TraceOp::CHECK_IN:
+                return hotel.checkInReservation(mapped(reservationIds, r.id)).code;
+            case TraceOp::CHECK_OUT:
+                return hotel.checkOutReservation(mapped(reservationIds, r.id)).code;
+            case TraceOp::FIND_AVAILABLE:
+                hotel.findAvailableRooms(r.type, r.checkIn + shift, r.checkOut + shift);
+                return ResultCode::OK;
+            case TraceOp::LOOKUP_RESERVATION: {
+                Reservation out;
+                return hotel.lookupReservation(mapped(reservationIds, r.id), out) ? ResultCode::OK
+                                                                                   : ResultCode::NOT_FOUND;
+            }
+            case TraceOp::LOOKUP_CUSTOMER: {
+                Customer out;
+                return hotel.lookupCustomer(mapped(customerIds, r.id), out) ? ResultCode::OK
+                                                                             : ResultCode::NOT_FOUND;
+            }
+            case TraceOp::CREATE_GROUP: {
+                std::vector<RoomType> types;
+                for (int t : r.values) types.push_back(static_cast<RoomType>(t));
+                std::vector<int> created;
+                OperationResult result = hotel.createGroupReservation(mapped(customerIds, r.id), types,
+                                                                      r.checkIn + shift, r.checkOut + shift,
+                                                                      &created);
+                for (size_t i = 0; i < created.size() && i < r.createdIds.size(); ++i) {
+                    reservationIds[r.createdIds[i]] = created[i];
+                }
+                return result.code;
+            }
+            case TraceOp::MAKE_ROOM_FOR:
+                return hotel.makeRoomFor(mapped(reservationIds, r.id)).code;
+            case TraceOp::RESCHEDULE:
+                return hotel.reschedule(r.id != 0).code;
+            case TraceOp::BLOCK_ROOMS: {
+                int days = static_cast<int>(shift / 86400);
+                return hotel.blockRooms(r.values, r.fromDay + days, r.toDay + days, r.name).code;
+            }
+            case TraceOp::UNBLOCK_ROOMS: {
+                int days = static_cast<int>(shift / 86400);
+                return hotel.unblockRooms(r.values, r.fromDay + days, r.toDay + days).code;
+            }
+        }
+        return ResultCode::BAD_COMMAND;
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program
+                  << " --trace FILE [--data DIR] [--work DIR] [--paced] [--speed X] [--shift-dates] [--no-save]\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string traceFile;
+    std::string dataDir = ".";
+    std::string workDir = (std::filesystem::temp_directory_path() / "hotel_replay").string();
+    bool paced = false;
+    double speed = 1.0;
+    bool shiftDates = false;
+    bool autoSave = true;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            dataDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--work") == 0 && i + 1 < argc) {
+            workDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--paced") == 0) {
+            paced = true;
+        } else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = std::atof(argv[++i]);
+            paced = true;
+        } else if (std::strcmp(argv[i], "--shift-dates") == 0) {
+            shiftDates = true;
+        } else if (std::strcmp(argv[i], "--no-save") == 0) {
+            autoSave = false;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (traceFile.empty() || speed <= 0.0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    TraceReader reader;
+    if (!reader.open(traceFile)) {
+        std::cerr << (reader.isCorrupt() ? "Not a session trace: " : "Failed to open ") << traceFile << "\n";
+        return 1;
+    }
+    if (!copyDataFiles(dataDir, workDir)) {
+        std::cerr << "Failed to copy the data files from " << dataDir << " to " << workDir << "\n";
+        return 1;
+    }
+
+    // Stays keep their distance from "now", so old traces still book future dates
+    time_t shift = 0;
+    if (shiftDates) {
+        time_t recordedAt = static_cast<time_t>(reader.getStartUnixMicros() / 1000000);
+        shift = (std::time(nullptr) - recordedAt) / 86400 * 86400;
+    }
+
+    OpStats stats[TRACE_OP_COUNT];
+    uint64_t total = 0;
+    uint64_t maxLagMicros = 0;
+    std::unordered_map<int, int> customerIds, reservationIds;
+    {
+        HotelSystem hotel(workDir);
+        hotel.setAutoSave(autoSave);
+
+        TraceRecord record;
+        auto start = Clock::now();
+        while (reader.next(record)) {
+            if (paced) {
+                auto due = start + std::chrono::microseconds(
+                    static_cast<int64_t>(static_cast<double>(record.offsetMicros) / speed));
+                auto now = Clock::now();
+                if (now < due) {
+                    std::this_thread::sleep_until(due);
+                } else {
+                    uint64_t lag = static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(now - due).count());
+                    if (lag > maxLagMicros) maxLagMicros = lag;
+                }
+            }
+
+            auto begin = Clock::now();
+            ResultCode code = execute(hotel, record, shift, customerIds, reservationIds);
+            uint64_t nanos = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count());
+
+            OpStats& op = stats[static_cast<int>(record.op)];
+            op.replayed.record(nanos);
+            op.recorded.record(record.latencyNanos);
+            if (static_cast<uint8_t>(code) != record.code) ++op.mismatches;
+            ++total;
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << "\n========== TRACE REPLAY ==========\n";
+        std::cout << total << " calls in " << std::fixed << std::setprecision(3) << seconds << " s ("
+                  << std::setprecision(0) << (seconds > 0.0 ? total / seconds : 0.0) << " calls/s, "
+                  << (paced ? "paced" : "as fast as possible") << ")\n";
+        if (paced) std::cout << "Max lag behind the recorded pacing: " << maxLagMicros / 1000.0 << " ms\n";
+        std::cout << "\n" << std::left << std::setw(20) << "Operation" << std::right
+                  << std::setw(8) << "Count" << std::setw(10) << "Differ"
+                  << std::setw(12) << "Avg us" << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+                  << std::setw(12) << "Max us" << std::setw(14) << "Rec p50 us" << "\n";
+        std::cout << std::setprecision(2);
+        for (int i = 0; i < TRACE_OP_COUNT; ++i) {
+            const OpStats& op = stats[i];
+            uint64_t n = op.replayed.getCount();
+            if (n == 0) continue;
+            std::cout << std::left << std::setw(20) << traceOpName(static_cast<TraceOp>(i)) << std::right
+                      << std::setw(8) << n << std::setw(10) << op.mismatches
+                      << std::setw(12) << op.replayed.getTotalNanos() / 1000.0 / static_cast<double>(n)
+                      << std::setw(12) << op.replayed.percentileNanos(50) / 1000.0
+                      << std::setw(12) << op.replayed.percentileNanos(99) / 1000.0
+                      << std::setw(12) << op.replayed.getMaxNanos() / 1000.0
+                      << std::setw(14) << op.recorded.percentileNanos(50) / 1000.0 << "\n";
+        }
+        std::cout << "(Differ: calls whose result code changed from the recording)\n";
+    }
+
+    if (reader.isCorrupt()) {
+        std::cerr << "Trace is damaged after record " << total << "; replay stopped there.\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "Waitlist.h"
+#include <algorithm>
+
+void Waitlist::pull(TypeList& list, int n) {
+    Node& node = list.nodes[n];
+    node.minPriority = node.entry.priority;
+    node.minCheckIn = node.maxCheckIn = node.entry.checkIn;
+    node.minCheckOut = node.maxCheckOut = node.entry.checkOut;
+    for (int child : {node.left, node.right}) {
+        if (child < 0) continue;
+        const Node& c = list.nodes[child];
+        node.minPriority = std::min(node.minPriority, c.minPriority);
+        node.minCheckIn = std::min(node.minCheckIn, c.minCheckIn);
+        node.maxCheckIn = std::max(node.maxCheckIn, c.maxCheckIn);
+        node.minCheckOut = std::min(node.minCheckOut, c.minCheckOut);
+        node.maxCheckOut = std::max(node.maxCheckOut, c.maxCheckOut);
+    }
+}
+
+void Waitlist::split(TypeList& list, int n, const Entry& key, int& left, int& right) {
+    if (n < 0) {
+        left = right = -1;
+        return;
+    }
+    if (before(list.nodes[n].entry, key)) {
+        split(list, list.nodes[n].right, key, list.nodes[n].right, right);
+        left = n;
+    } else {
+        split(list, list.nodes[n].left, key, left, list.nodes[n].left);
+        right = n;
+    }
+    pull(list, n);
+}
+
+int Waitlist::merge(TypeList& list, int left, int right) {
+    if (left < 0) return right;
+    if (right < 0) return left;
+    if (list.nodes[left].heap > list.nodes[right].heap) {
+        list.nodes[left].right = merge(list, list.nodes[left].right, right);
+        pull(list, left);
+        return left;
+    }
+    list.nodes[right].left = merge(list, left, list.nodes[right].left);
+    pull(list, right);
+    return right;
+}
+
+void Waitlist::add(RoomType type, int reservationId, size_t index, time_t checkIn, time_t checkOut) {
+    TypeList& list = lists[static_cast<int>(type)];
+    if (list.byId.count(reservationId)) return;
+
+    int n;
+    if (!list.freeNodes.empty()) {
+        n = list.freeNodes.back();
+        list.freeNodes.pop_back();
+    } else {
+        n = static_cast<int>(list.nodes.size());
+        list.nodes.emplace_back();
+    }
+    // xorshift32
+    list.seed ^= list.seed << 13;
+    list.seed ^= list.seed >> 17;
+    list.seed ^= list.seed << 5;
+
+    Node& node = list.nodes[n];
+    node = Node();
+    node.heap = list.seed;
+    node.entry.priority = nextPriority.fetch_add(1, std::memory_order_relaxed);
+    node.entry.index = index;
+    node.entry.reservationId = reservationId;
+    node.entry.checkIn = checkIn;
+    node.entry.checkOut = checkOut;
+    pull(list, n);
+
+    int left, right;
+    split(list, list.root, node.entry, left, right);
+    list.root = merge(list, merge(list, left, n), right);
+    list.byId[reservationId] = n;
+}
+
+bool Waitlist::remove(RoomType type, int reservationId) {
+    TypeList& list = lists[static_cast<int>(type)];
+    auto it = list.byId.find(reservationId);
+    if (it == list.byId.end()) return false;
+    int n = it->second;
+    list.byId.erase(it);
+
+    // Cut out exactly [key, key + 1 priority): the node itself
+    Entry key = list.nodes[n].entry;
+    int left, middle, right;
+    split(list, list.root, key, left, right);
+    ++key.priority;
+    split(list, right, key, middle, right);
+    list.root = merge(list, left, right);
+    list.freeNodes.push_back(n);
+    return true;
+}
+
+void Waitlist::search(const TypeList& list, int n, const Gap& gap, int& best) {
+    if (n < 0) return;
+    const Node& node = list.nodes[n];
+    if (best >= 0 && node.minPriority >= list.nodes[best].entry.priority) return;
+    if (node.maxCheckIn < gap.start || node.minCheckIn >= gap.lastCheckIn) return;
+    if (node.minCheckOut > gap.end || node.maxCheckOut <= gap.freedIn) return;
+
+    const Entry& e = node.entry;
+    if (e.checkIn >= gap.start && e.checkIn < gap.lastCheckIn && e.checkOut <= gap.end &&
+        e.checkOut > gap.freedIn && (best < 0 || e.priority < list.nodes[best].entry.priority)) {
+        best = n;
+    }
+    // The side holding the earlier booking first, so the other is often skipped
+    int first = node.left, second = node.right;
+    if (first < 0 || (second >= 0 && list.nodes[second].minPriority < list.nodes[first].minPriority)) {
+        std::swap(first, second);
+    }
+    search(list, first, gap, best);
+    search(list, second, gap, best);
+}
+
+bool Waitlist::takeBestFit(RoomType type, time_t gapStart, time_t gapEnd,
+                           time_t freedIn, time_t freedOut, Entry& out) {
+    TypeList& list = lists[static_cast<int>(type)];
+    Gap gap{gapStart, gapEnd, freedIn, std::min(gapEnd, freedOut)};
+    int best = -1;
+    search(list, list.root, gap, best);
+    if (best < 0) return false;
+
+    out = list.nodes[best].entry;
+    remove(type, out.reservationId);
+    return true;
+}
+
+void Waitlist::clear() {
+    for (auto& list : lists) {
+        list.nodes.clear();
+        list.freeNodes.clear();
+        list.root = -1;
+        list.byId.clear();
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef WAITLIST_H
+#define WAITLIST_H
+
+#include "Room.h"
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+
+// PENDING reservations waiting for a room of the type they asked for,
+// indexed per RoomType by check-in time. Priority is booking order: the
+// entry added first wins when several fit the same gap. Each type's list is
+// touched only by the holder of that type's shard lock (see HotelLocks.h).
+class Waitlist {
+public:
+    struct Entry {
+        uint64_t priority = 0;   // lower was booked earlier
+        size_t index = 0;        // position in the reservations vector
+        int reservationId = 0;
+        time_t checkIn = 0;
+        time_t checkOut = 0;
+    };
+
+private:
+    // Treap ordered by (checkIn, priority). Each node also keeps the
+    // smallest priority and the check-in and check-out ranges of its
+    // subtree, so takeBestFit can skip any subtree that has nothing booked
+    // earlier than its best match so far, or nothing that fits the gap.
+    struct Node {
+        Entry entry;
+        uint32_t heap = 0;       // random treap priority
+        int left = -1;
+        int right = -1;
+        uint64_t minPriority = 0;
+        time_t minCheckIn = 0;
+        time_t maxCheckIn = 0;
+        time_t minCheckOut = 0;
+        time_t maxCheckOut = 0;
+    };
+
+    struct Gap {
+        time_t start;
+        time_t end;
+        time_t freedIn;
+        time_t lastCheckIn;      // a stay that overlaps the freed nights checks in before this
+    };
+
+    struct TypeList {
+        std::vector<Node> nodes;
+        std::vector<int> freeNodes;
+        int root = -1;
+        std::unordered_map<int, int> byId;   // reservation id -> node
+        uint32_t seed = 2463534242u;
+    };
+
+    TypeList lists[ROOM_TYPE_COUNT];
+    std::atomic<uint64_t> nextPriority{0};
+
+    static bool before(const Entry& a, const Entry& b) {
+        return a.checkIn != b.checkIn ? a.checkIn < b.checkIn : a.priority < b.priority;
+    }
+    static void pull(TypeList& list, int n);
+    // left receives the nodes ordered before key, right the rest
+    static void split(TypeList& list, int n, const Entry& key, int& left, int& right);
+    static int merge(TypeList& list, int left, int right);
+    static void search(const TypeList& list, int n, const Gap& gap, int& best);
+
+public:
+    void add(RoomType type, int reservationId, size_t index, time_t checkIn, time_t checkOut);
+    bool remove(RoomType type, int reservationId);
+
+    // Removes and returns the earliest-booked entry that fits inside the
+    // free gap [gapStart, gapEnd) and overlaps [freedIn, freedOut), the
+    // part of the gap that just became free. Anything else on the list
+    // could not use the freed nights. When the earliest-booked entry that
+    // checks in inside the gap also fits it, this takes O(log n). Entries
+    // booked before the winner that check in inside the gap but end after
+    // it are still passed over one subtree at a time.
+    bool takeBestFit(RoomType type, time_t gapStart, time_t gapEnd,
+                     time_t freedIn, time_t freedOut, Entry& out);
+
+    size_t size(RoomType type) const { return lists[static_cast<int>(type)].byId.size(); }
+    void clear();
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "WhatIfSimulator.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    bool holdsRoom(const Reservation& r) {
+        return r.getAssignedRoomNumber() > 0 &&
+               (r.getStatus() == ReservationStatus::CONFIRMED ||
+                r.getStatus() == ReservationStatus::CHECKED_IN);
+    }
+
+    std::string signedText(double value, int precision) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(precision) << (value > 0 ? "+" : "") << value;
+        return ss.str();
+    }
+
+    std::string signedText(Money value) {
+        return (value > Money() ? "+" : "") + value.toString();
+    }
+}
+
+WhatIfSimulator::WhatIfSimulator(HotelFork forkState, int from, int to)
+    : fork(std::move(forkState)), fromDay(from), toDay(to) {}
+
+WhatIfOutcome WhatIfSimulator::simulate(const WhatIfScenario& scenario) const {
+    auto start = std::chrono::steady_clock::now();
+    WhatIfOutcome outcome;
+    outcome.name = scenario.name;
+
+    // Private copies; the snapshot itself stays shared and untouched
+    const HotelSnapshot& tables = *fork.tables;
+    std::vector<Reservation> reservations;
+    reservations.reserve(tables.getReservationCount() + scenario.extraBookings);
+    for (size_t i = 0; i < tables.getReservationCount(); ++i) reservations.push_back(tables.reservationAt(i));
+    std::vector<Room> rooms;
+    rooms.reserve(tables.getRoomCount() + scenario.addRooms.size());
+    for (size_t i = 0; i < tables.getRoomCount(); ++i) rooms.push_back(tables.roomAt(i));
+    std::vector<RoomBlock> blocks = fork.blocks;
+    const size_t forkedReservations = reservations.size();
+
+    // Inventory: unassign the stays of removed rooms before the index is built
+    std::unordered_set<int> removed(scenario.removeRooms.begin(), scenario.removeRooms.end());
+    std::vector<std::pair<int, RoomType>> rehome;  // reservation id, type of its old room
+    if (!removed.empty()) {
+        std::unordered_map<int, RoomType> removedType;
+        for (const auto& room : rooms) {
+            if (removed.count(room.getRoomNumber())) removedType[room.getRoomNumber()] = room.getType();
+        }
+        for (auto& r : reservations) {
+            auto it = removedType.find(r.getAssignedRoomNumber());
+            if (it == removedType.end() || !holdsRoom(r)) continue;
+            rehome.push_back({r.getId(), it->second});
+            r.setAssignedRoomNumber(-1);
+            r.setStatus(ReservationStatus::PENDING);
+            r.setTotalCost(Money());
+        }
+        rooms.erase(std::remove_if(rooms.begin(), rooms.end(),
+                                   [&](const Room& room) { return removed.count(room.getRoomNumber()) > 0; }),
+                    rooms.end());
+        blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+                                    [&](const RoomBlock& b) { return removed.count(b.roomNumber) > 0; }),
+                     blocks.end());
+    }
+    for (const auto& added : scenario.addRooms) {
+        bool taken = std::any_of(rooms.begin(), rooms.end(),
+                                 [&](const Room& room) { return room.getRoomNumber() == added.getRoomNumber(); });
+        if (!taken) rooms.push_back(Room(added.getRoomNumber(), added.getType(), added.getPricePerNight()));
+    }
+
+    RateCalendar rates;
+    std::vector<RateRule> rules = fork.rateRules;
+    rules.insert(rules.end(), scenario.addRates.begin(), scenario.addRates.end());
+    rates.setRules(rules);
+
+    Scheduler scheduler(rooms, reservations, blocks);
+    scheduler.setRateCalendar(&rates);
+    scheduler.setAssignmentPolicy(scenario.overridePolicy ? scenario.policy : fork.policy);
+
+    for (const auto& entry : rehome) scheduler.scheduleReservation(entry.first, entry.second);
+
+    if (scenario.reschedule != WhatIfReschedule::NONE) {
+        // Same reset as HotelSystem::reschedule
+        std::unordered_map<int, Room*> roomByNumber;
+        for (auto& room : rooms) {
+            room = Room(room.getRoomNumber(), room.getType(), room.getPricePerNight());
+            roomByNumber[room.getRoomNumber()] = &room;
+        }
+        for (auto& r : reservations) {
+            if (r.getStatus() == ReservationStatus::CHECKED_IN) {
+                auto it = roomByNumber.find(r.getAssignedRoomNumber());
+                if (it != roomByNumber.end()) it->second->addReservation(r.getId());
+            } else if (r.getStatus() != ReservationStatus::CANCELLED &&
+                       r.getStatus() != ReservationStatus::CHECKED_OUT) {
+                r.setAssignedRoomNumber(-1);
+                r.setStatus(ReservationStatus::PENDING);
+                r.setTotalCost(Money());
+            }
+        }
+        if (scenario.reschedule == WhatIfReschedule::MAX_REVENUE) {
+            scheduler.scheduleReservationsForRevenue();
+        } else {
+            scheduler.scheduleReservations();
+        }
+    }
+
+    if (scenario.extraBookings > 0 && scenario.demandToDay > scenario.demandFromDay && !rooms.empty()) {
+        // Ids past the fork's; the live id counter is not touched
+        int nextId = 1;
+        for (const auto& r : reservations) nextId = std::max(nextId, r.getId() + 1);
+        std::mt19937_64 rng(scenario.seed);
+        std::uniform_int_distribution<int> arrival(scenario.demandFromDay, scenario.demandToDay - 1);
+        std::uniform_int_distribution<int> nights(1, 7);
+        std::uniform_int_distribution<size_t> pickRoom(0, rooms.size() - 1);
+        for (size_t i = 0; i < scenario.extraBookings; ++i) {
+            int day = arrival(rng);
+            RoomType type = rooms[pickRoom(rng)].getType();
+            Reservation r(nextId++, 0, fromDayIndex(day, 14), fromDayIndex(day + nights(rng), 11), -1,
+                          ReservationStatus::PENDING, Money());
+            r.setRequestedType(static_cast<int>(type));
+            reservations.push_back(r);
+            if (!scheduler.scheduleReservation(r.getId(), type)) ++outcome.rejected;
+        }
+    }
+
+    OccupancyReport report = scheduler.getOccupancySeries(fromDay, toDay);
+    outcome.occupancyRate = report.occupancyRate;
+    outcome.roomNightsSold = report.totalRoomNightsSold;
+    outcome.revenue = report.totalRevenue;
+    for (size_t i = 0; i < reservations.size(); ++i) {
+        const Reservation& r = reservations[i];
+        if (holdsRoom(r)) {
+            ++outcome.confirmed;
+        } else if (r.getStatus() == ReservationStatus::PENDING) {
+            ++outcome.pending;
+            if (i < forkedReservations && holdsRoom(tables.reservationAt(i))) ++outcome.displaced;
+        }
+    }
+    outcome.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return outcome;
+}
+
+std::vector<WhatIfOutcome> WhatIfSimulator::run(const std::vector<WhatIfScenario>& scenarios,
+                                                unsigned threadCount) const {
+    std::vector<WhatIfOutcome> outcomes(scenarios.size());
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, scenarios.size()));
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < scenarios.size(); i = next.fetch_add(1)) {
+            outcomes[i] = simulate(scenarios[i]);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    if (threadCount > 0) worker();
+    for (auto& t : threads) t.join();
+    return outcomes;
+}
+
+void WhatIfSimulator::printComparison(const WhatIfOutcome& baseline, const std::vector<WhatIfOutcome>& outcomes,
+                                      std::ostream& out) {
+    out << std::left << std::setw(34) << "Scenario" << std::right
+        << std::setw(12) << "Occupancy" << std::setw(16) << "Revenue"
+        << std::setw(11) << "Confirmed" << std::setw(9) << "Pending"
+        << std::setw(11) << "Displaced" << std::setw(10) << "Rejected" << "\n";
+    out << std::fixed << std::setprecision(1);
+    out << std::left << std::setw(34) << baseline.name << std::right
+        << std::setw(11) << baseline.occupancyRate << "%" << std::setw(16) << baseline.revenue.toString()
+        << std::setw(11) << baseline.confirmed << std::setw(9) << baseline.pending
+        << std::setw(11) << "-" << std::setw(10) << "-" << "\n";
+    for (const auto& o : outcomes) {
+        out << std::left << std::setw(34) << o.name << std::right
+            << std::setw(11) << signedText(o.occupancyRate - baseline.occupancyRate, 1) << "%"
+            << std::setw(16) << signedText(o.revenue - baseline.revenue)
+            << std::setw(11) << signedText(o.confirmed - baseline.confirmed, 0)
+            << std::setw(9) << signedText(o.pending - baseline.pending, 0)
+            << std::setw(11) << o.displaced << std::setw(10) << o.rejected << "\n";
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef WHAT_IF_SIMULATOR_H
+#define WHAT_IF_SIMULATOR_H
+
+#include "HotelSnapshot.h"
+#include "RateCalendar.h"
+#include "RoomBlock.h"
+#include "Scheduler.h"
+#include "Money.h"
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The live hotel frozen for what-if runs. The tables are a pinned snapshot
+// shared with the live hotel and with every other fork, so forking copies
+// nothing; blocks and rate rules are small and copied outright.
+struct HotelFork {
+    std::shared_ptr<const HotelSnapshot> tables;
+    std::vector<RoomBlock> blocks;
+    std::vector<RateRule> rateRules;
+    AssignmentPolicy policy = AssignmentPolicy::FIRST_FIT;
+};
+
+enum class WhatIfReschedule {
+    NONE,
+    CHECK_IN_ORDER,  // as "Reschedule All Reservations" does it
+    MAX_REVENUE      // Scheduler::scheduleReservationsForRevenue
+};
+
+// One change to try. The steps are applied in the order listed here.
+struct WhatIfScenario {
+    std::string name;
+    // Inventory: stays in a removed room move to another room of its type
+    // or wait; added rooms with a number already in use are ignored
+    std::vector<int> removeRooms;
+    std::vector<Room> addRooms;
+    // Pricing: stacked on the current rules; reaches stays priced in the
+    // scenario (rescheduled, displaced or new)
+    std::vector<RateRule> addRates;
+    bool overridePolicy = false;
+    AssignmentPolicy policy = AssignmentPolicy::FIRST_FIT;
+    WhatIfReschedule reschedule = WhatIfReschedule::NONE;
+    // Synthetic demand: bookings with check-in days drawn uniformly from
+    // [demandFromDay, demandToDay), 1-7 nights, room types in proportion
+    // to the inventory, booked one at a time
+    size_t extraBookings = 0;
+    int demandFromDay = 0;
+    int demandToDay = 0;
+    uint64_t seed = 1;
+};
+
+struct WhatIfOutcome {
+    std::string name;
+    double occupancyRate = 0.0;  // percent over the report window
+    int roomNightsSold = 0;
+    Money revenue;               // of the nights in the report window
+    int confirmed = 0;           // CONFIRMED or CHECKED_IN
+    int pending = 0;
+    int displaced = 0;           // held a room in the fork, pending in the scenario
+    int rejected = 0;            // synthetic bookings that found no room
+    double seconds = 0.0;
+};
+
+// Runs scenarios against a fork without touching the live hotel or its
+// files. Each scenario builds private copies of the tables from the shared
+// snapshot on its own worker thread, so many run in parallel.
+class WhatIfSimulator {
+private:
+    HotelFork fork;
+    int fromDay;
+    int toDay;
+
+public:
+    // Occupancy and revenue are reported over the nights [fromDay, toDay)
+    WhatIfSimulator(HotelFork fork, int fromDay, int toDay);
+
+    WhatIfOutcome simulate(const WhatIfScenario& scenario) const;
+    // Outcomes in the order of scenarios
+    std::vector<WhatIfOutcome> run(const std::vector<WhatIfScenario>& scenarios,
+                                   unsigned threadCount = 0) const;
+
+    // One row per outcome with its difference from baseline
+    static void printComparison(const WhatIfOutcome& baseline, const std::vector<WhatIfOutcome>& outcomes,
+                                std::ostream& out);
+};
+
+#endif
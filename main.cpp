@@ -1,9 +1,93 @@
 #include "HotelSystem.h"
+#include "BatchExecutor.h"
+#include "ReservationServer.h"
+#include "Metrics.h"
 #include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--data DIR] [--best-fit] [--metrics JSON_FILE] [--record TRACE_FILE] [--batch COMMAND_FILE [--log] | --server SOCKET_PATH [--workers N]]\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataDir;
+    std::string batchFile;
+    std::string socketPath;
+    std::string metricsFile;
+    std::string traceFile;
+    unsigned workers = 0;
+    bool logCommands = false;
+    bool bestFit = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            dataDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metricsFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--best-fit") == 0) {
+            bestFit = true;
+        } else if (std::strcmp(argv[i], "--log") == 0) {
+            logCommands = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Written after the hotel (and its final save) is gone, whichever mode ran
+    struct MetricsDump {
+        const std::string& path;
+        ~MetricsDump() {
+            if (path.empty()) return;
+            std::ofstream file(path);
+            if (file.is_open()) Metrics::dumpJson(file);
+            else std::cerr << "Failed to open " << path << " for writing.\n";
+        }
+    } metricsDump{metricsFile};
 
-int main() {
     try {
-        HotelSystem hotel;
+        HotelSystem hotel(dataDir);
+        if (bestFit) hotel.setAssignmentPolicy(AssignmentPolicy::BEST_FIT);
+        if (!traceFile.empty() && !hotel.startRecording(traceFile)) {
+            std::cerr << "Failed to open " << traceFile << " for writing.\n";
+            return 1;
+        }
+
+        if (!batchFile.empty()) {
+            // Headless: persist once at the end instead of after every command
+            hotel.setAutoSave(false);
+            BatchExecutor executor(hotel);
+            BatchStats stats = executor.runFile(batchFile, logCommands ? &std::cout : nullptr);
+            bool saved = hotel.saveData();
+            BatchExecutor::printStats(stats, std::cout);
+            if (!saved) {
+                std::cerr << "Failed to save the data files.\n";
+                return 1;
+            }
+            return stats.parseErrors == 0 ? 0 : 2;
+        }
+
+        if (!socketPath.empty()) {
+            ReservationServer server(hotel, socketPath, workers);
+            bool ok = server.run();
+            if (!hotel.saveData()) {
+                std::cerr << "Failed to save the data files.\n";
+                ok = false;
+            }
+            return ok ? 0 : 1;
+        }
+
         hotel.run();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;